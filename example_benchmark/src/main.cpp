@@ -0,0 +1,452 @@
+#include "ofMain.h"
+
+#include "seam/seamGraph.h"
+#include "seam/clock.h"
+#include "seam/hash.h"
+
+#include "nodes/benchmarkNodes.h"
+
+#include <chrono>
+#include <filesystem>
+
+#if RUN_DOCTEST
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#else
+
+using namespace seam;
+using namespace seam::nodes;
+using namespace seam::pins;
+
+namespace {
+	using Clock = std::chrono::steady_clock;
+
+	enum class Shape {
+		Chain,
+		FanOut,
+		FanIn,
+		Lattice,
+	};
+
+	const std::array<Shape, 4> shapes = { Shape::Chain, Shape::FanOut, Shape::FanIn, Shape::Lattice };
+
+	const char* ShapeName(Shape shape) {
+		switch (shape) {
+		case Shape::Chain:
+			return "chain";
+		case Shape::FanOut:
+			return "fan_out";
+		case Shape::FanIn:
+			return "fan_in";
+		case Shape::Lattice:
+			return "lattice";
+		default:
+			return "unknown";
+		}
+	}
+
+	/// @brief Names of the BenchmarkSource outputs and BenchmarkProbe inputs, in pin order.
+	const std::array<const char*, 6> pinTypeNames = { "float", "int", "uint", "bool", "char", "vec" };
+
+	struct Options {
+		std::vector<size_t> sizes = { 10, 100, 1000, 10000, 100000 };
+		int frames = 100;
+		int pushIterations = 100000;
+		size_t threads = 0;
+		FILE* out = stdout;
+	};
+
+	/// @brief Results are written as JSON lines so they can be diffed or plotted between releases.
+	void Emit(const Options& options, const char* benchmark, const std::string& variant,
+		size_t nodes, size_t iterations, Clock::duration elapsed)
+	{
+		const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+		fprintf(options.out,
+			"{\"benchmark\":\"%s\",\"variant\":\"%s\",\"nodes\":%zu,\"threads\":%zu,"
+			"\"iterations\":%zu,\"total_ms\":%.4f,\"ns_per_iteration\":%.2f}\n",
+			benchmark, variant.c_str(), nodes, options.threads, iterations,
+			ns / 1e6, iterations > 0 ? ns / iterations : 0.0);
+		fflush(options.out);
+	}
+
+	PinInput* In(INode* node, size_t index) {
+		size_t size;
+		PinInput* pins = node->PinInputs(size);
+		assert(index < size);
+		return &pins[index];
+	}
+
+	PinOutput* Out(INode* node, size_t index) {
+		size_t size;
+		PinOutput* pins = node->PinOutputs(size);
+		assert(index < size);
+		return &pins[index];
+	}
+
+	struct Edge {
+		PinOutput* pinOut;
+		PinInput* pinIn;
+	};
+
+	/// @brief Creates the pure-CPU Nodes benchmark graphs are made of, by pre-hashed NodeId.
+	class GraphBuilder {
+	public:
+		GraphBuilder(SeamGraph& _graph) : graph(_graph) { }
+
+		/// @brief Rotates through time based Nodes, which update every frame and dirty their children.
+		INode* Source() {
+			static const std::array<NodeId, 3> ids = { SCHash("Cosine"), SCHash("Saw"), SCHash("Step") };
+			return Create(ids[sources++ % ids.size()]);
+		}
+
+		/// @brief Rotates through single input, single output Nodes.
+		/// @param valueIn Is set to the input which the previous Node should connect to.
+		INode* Processor(PinInput*& valueIn) {
+			static const NodeId rangeId = SCHash("Range");
+			static const NodeId addStoreId = SCHash("Add Store");
+			static const NodeId gateId = SCHash("Gate");
+
+			INode* node = nullptr;
+			switch (processors++ % 3) {
+			case 0:
+				node = Create(rangeId);
+				valueIn = In(node, 2);
+				break;
+			case 1:
+				node = Create(addStoreId);
+				valueIn = In(node, 0);
+				break;
+			default:
+				// The first input is the select line, the second is the (selected by default) first gate.
+				node = Create(gateId);
+				valueIn = In(node, 1);
+				break;
+			}
+			return node;
+		}
+
+		/// @brief Range Nodes have five Float inputs, so they're used wherever a Node needs several parents.
+		INode* Range() {
+			static const NodeId rangeId = SCHash("Range");
+			return Create(rangeId);
+		}
+
+		INode* Probe() {
+			static const NodeId probeId = SCHash("Benchmark Probe");
+			return Create(probeId);
+		}
+
+		/// @brief Build a graph shape, ending in a single probe which is set as the visual output node,
+		/// since only Nodes upstream of the visual output update.
+		void Build(Shape shape, size_t n, std::vector<Edge>& edges) {
+			edges.clear();
+			std::vector<INode*> tails;
+			switch (shape) {
+			case Shape::Chain:
+				BuildChain(n, edges, tails);
+				break;
+			case Shape::FanOut:
+				BuildFanOut(n, edges, tails);
+				break;
+			case Shape::FanIn:
+				BuildFanIn(n, edges, tails);
+				break;
+			case Shape::Lattice:
+				BuildLattice(n, edges, tails);
+				break;
+			}
+
+			INode* probe = Probe();
+			edges.push_back(Edge { Out(Reduce(tails, edges), 0), In(probe, 0) });
+			graph.SetVisualOutputNode(probe);
+		}
+
+	private:
+		INode* Create(NodeId id) {
+			INode* node = graph.CreateAndAdd(id);
+			assert(node != nullptr);
+			return node;
+		}
+
+		/// @brief Reduce Nodes with a tree of five-input Range Nodes.
+		/// @return The root of the tree, or the only Node if there's just one.
+		INode* Reduce(std::vector<INode*> layer, std::vector<Edge>& edges) {
+			std::vector<INode*> next;
+			while (layer.size() > 1) {
+				next.clear();
+				for (size_t i = 0; i < layer.size(); i += 5) {
+					INode* node = Range();
+					for (size_t j = 0; j < 5 && i + j < layer.size(); j++) {
+						edges.push_back(Edge { Out(layer[i + j], 0), In(node, j) });
+					}
+					next.push_back(node);
+				}
+				std::swap(layer, next);
+			}
+			return layer[0];
+		}
+
+		/// @brief source -> processor -> ... -> processor
+		void BuildChain(size_t n, std::vector<Edge>& edges, std::vector<INode*>& tails) {
+			const size_t length = std::max<size_t>(3, n);
+			INode* prev = Source();
+			for (size_t i = 0; i < length - 2; i++) {
+				PinInput* valueIn;
+				INode* node = Processor(valueIn);
+				edges.push_back(Edge { Out(prev, 0), valueIn });
+				prev = node;
+			}
+			tails.push_back(prev);
+		}
+
+		/// @brief One source feeding many processors, which are reduced back down to the probe.
+		void BuildFanOut(size_t n, std::vector<Edge>& edges, std::vector<INode*>& tails) {
+			INode* source = Source();
+			// The reduction tree adds about a quarter as many Nodes again, for roughly n in total.
+			const size_t branches = std::max<size_t>(1, (n - 1) * 4 / 5);
+			for (size_t i = 0; i < branches; i++) {
+				PinInput* valueIn;
+				INode* node = Processor(valueIn);
+				edges.push_back(Edge { Out(source, 0), valueIn });
+				tails.push_back(node);
+			}
+		}
+
+		/// @brief Many sources, reduced into the probe.
+		void BuildFanIn(size_t n, std::vector<Edge>& edges, std::vector<INode*>& tails) {
+			const size_t leaves = std::max<size_t>(5, n * 4 / 5);
+			for (size_t i = 0; i < leaves; i++) {
+				tails.push_back(Source());
+			}
+		}
+
+		/// @brief A square grid of Range Nodes where each Node depends on its left and upper neighbors.
+		/// Edge Nodes are fed by a single source, and the far corner feeds the probe.
+		void BuildLattice(size_t n, std::vector<Edge>& edges, std::vector<INode*>& tails) {
+			const size_t width = std::max<size_t>(2, (size_t)std::sqrt((double)(n > 2 ? n - 2 : 1)));
+			INode* source = Source();
+			std::vector<INode*> grid(width * width);
+			for (size_t y = 0; y < width; y++) {
+				for (size_t x = 0; x < width; x++) {
+					INode* node = Range();
+					grid[y * width + x] = node;
+					INode* left = x > 0 ? grid[y * width + x - 1] : source;
+					INode* up = y > 0 ? grid[(y - 1) * width + x] : source;
+					edges.push_back(Edge { Out(left, 0), In(node, 2) });
+					edges.push_back(Edge { Out(up, 0), In(node, 1) });
+				}
+			}
+
+			tails.push_back(grid.back());
+		}
+
+		SeamGraph& graph;
+		size_t sources = 0;
+		size_t processors = 0;
+	};
+
+	void SetupGraph(SeamGraph& graph, FixedStepClock& clock, const Options& options) {
+		auto factory = graph.GetFactory();
+		factory->Register<BenchmarkSource>();
+		factory->Register<BenchmarkProbe>();
+		graph.SetClock(&clock);
+		graph.SetUpdateThreads(options.threads);
+		graph.OnWindowResized(1920, 1080);
+	}
+
+	void BenchmarkShape(Shape shape, size_t n, const Options& options) {
+		const std::string variant = ShapeName(shape);
+		std::vector<Edge> edges;
+
+		// Batched connections, like LoadGraph() makes.
+		{
+			FixedStepClock clock;
+			SeamGraph graph;
+			SetupGraph(graph, clock, options);
+			GraphBuilder(graph).Build(shape, n, edges);
+
+			auto start = Clock::now();
+			graph.BeginBatchConnect();
+			for (auto& e : edges) {
+				graph.Connect(e.pinIn, e.pinOut);
+			}
+			graph.EndBatchConnect();
+			Emit(options, "connect_batch", variant, graph.GetNodes().size(), edges.size(), Clock::now() - start);
+		}
+
+		const std::string path = (std::filesystem::temp_directory_path()
+			/ ("seam_benchmark_" + variant + "_" + std::to_string(n) + ".seam")).string();
+
+		// Scoped so the graph is cleaned up before it's loaded again below.
+		{
+			FixedStepClock clock;
+			SeamGraph graph;
+			SetupGraph(graph, clock, options);
+
+			auto start = Clock::now();
+			GraphBuilder(graph).Build(shape, n, edges);
+			const size_t nodes = graph.GetNodes().size();
+			Emit(options, "create", variant, nodes, nodes, Clock::now() - start);
+
+			// One connection at a time, like the editor makes.
+			start = Clock::now();
+			for (auto& e : edges) {
+				graph.Connect(e.pinIn, e.pinOut);
+			}
+			Emit(options, "connect", variant, nodes, edges.size(), Clock::now() - start);
+
+			// The first frame compiles the update schedule; time it separately from steady state frames.
+			clock.Step();
+			start = Clock::now();
+			graph.Update();
+			Emit(options, "update_first_frame", variant, nodes, 1, Clock::now() - start);
+
+			start = Clock::now();
+			for (int i = 0; i < options.frames; i++) {
+				clock.Step();
+				graph.Update();
+			}
+			Emit(options, "update", variant, nodes, options.frames, Clock::now() - start);
+
+			if (!graph.SaveGraph(path, graph.GetNodes())) {
+				fprintf(stderr, "failed to save %s\n", path.c_str());
+				return;
+			}
+		}
+
+		FixedStepClock loadClock;
+		SeamGraph loaded;
+		SetupGraph(loaded, loadClock, options);
+		std::vector<SeamGraph::Link> links;
+		auto start = Clock::now();
+		if (!loaded.LoadGraph(path, links)) {
+			fprintf(stderr, "failed to load %s\n", path.c_str());
+		} else {
+			Emit(options, "load_graph", variant, loaded.GetNodes().size(), 1, Clock::now() - start);
+		}
+		std::filesystem::remove(path);
+	}
+
+	/// @brief Time Push() and PushSingle() through every conversion between basic pin types.
+	void BenchmarkPush(const Options& options) {
+		alignas(16) std::array<char, BENCHMARK_PIN_ELEMENTS * sizeof(glm::vec4)> buffer = { 0 };
+
+		for (size_t src = 0; src < pinTypeNames.size(); src++) {
+			for (size_t dst = 0; dst < pinTypeNames.size(); dst++) {
+				// Multi-coordinate pins are only paired with each other.
+				const size_t vecIndex = pinTypeNames.size() - 1;
+				if ((src == vecIndex) != (dst == vecIndex)) {
+					continue;
+				}
+
+				FixedStepClock clock;
+				SeamGraph graph;
+				SetupGraph(graph, clock, options);
+				INode* source = graph.CreateAndAdd("Benchmark Source");
+				INode* probe = graph.CreateAndAdd("Benchmark Probe");
+				PinOutput* pinOut = Out(source, src);
+				graph.Connect(In(probe, dst), pinOut);
+
+				const std::string variant = std::string(pinTypeNames[src]) + "_to_" + pinTypeNames[dst];
+				PushPatterns* pushPatterns = graph.GetUpdateParams()->push_patterns;
+
+				auto start = Clock::now();
+				for (int i = 0; i < options.pushIterations; i++) {
+					pushPatterns->Push(*pinOut, buffer.data(), BENCHMARK_PIN_ELEMENTS);
+				}
+				Emit(options, "push", variant, BENCHMARK_PIN_ELEMENTS, options.pushIterations, Clock::now() - start);
+
+				start = Clock::now();
+				for (int i = 0; i < options.pushIterations; i++) {
+					pushPatterns->PushSingle(*pinOut, buffer.data(), i % BENCHMARK_PIN_ELEMENTS);
+				}
+				Emit(options, "push_single", variant, 1, options.pushIterations, Clock::now() - start);
+
+				const size_t rangeCount = BENCHMARK_PIN_ELEMENTS / 16;
+				start = Clock::now();
+				for (int i = 0; i < options.pushIterations; i++) {
+					pushPatterns->PushRange(*pinOut, buffer.data(), i % (BENCHMARK_PIN_ELEMENTS - rangeCount), rangeCount);
+				}
+				Emit(options, "push_range", variant, rangeCount, options.pushIterations, Clock::now() - start);
+
+				// Matching pins can alias pushed data instead of copying it.
+				if (src == dst) {
+					PinInput* pinIn = In(probe, dst);
+					pinIn->flags = pinIn->flags | PinFlags::Aliasable;
+					pinOut->flags = pinOut->flags | PinFlags::Aliasable;
+					pinOut->connections[0].RecacheConverts();
+
+					start = Clock::now();
+					for (int i = 0; i < options.pushIterations; i++) {
+						pushPatterns->Push(*pinOut, buffer.data(), BENCHMARK_PIN_ELEMENTS);
+					}
+					Emit(options, "push", variant + "_aliased", BENCHMARK_PIN_ELEMENTS, options.pushIterations, Clock::now() - start);
+				}
+			}
+		}
+	}
+
+	void PrintUsage() {
+		printf("usage: example_benchmark [--sizes N,N,...] [--frames N] [--push-iterations N] [--threads N] [--out FILE]\n");
+		printf("  --sizes            node counts to build each graph shape with (default 10,100,1000,10000,100000)\n");
+		printf("  --frames           frames to time SeamGraph::Update() over (default 100)\n");
+		printf("  --push-iterations  pushes to time per conversion type (default 100000)\n");
+		printf("  --threads          worker threads used for thread safe node updates (default 0)\n");
+		printf("  --out              write JSON lines results to a file instead of stdout\n");
+	}
+}
+
+//========================================================================
+/// Benchmarks the push and update core with synthetic graphs of pure-CPU Nodes.
+/// Each result is printed as one JSON object per line.
+int main(int argc, char** argv) {
+	Options options;
+
+	for (int i = 1; i < argc; i++) {
+		std::string_view arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--sizes" && hasValue) {
+			options.sizes.clear();
+			std::stringstream ss(argv[++i]);
+			std::string size;
+			while (std::getline(ss, size, ',')) {
+				options.sizes.push_back(std::strtoull(size.c_str(), nullptr, 10));
+			}
+		} else if (arg == "--frames" && hasValue) {
+			options.frames = std::atoi(argv[++i]);
+		} else if (arg == "--push-iterations" && hasValue) {
+			options.pushIterations = std::atoi(argv[++i]);
+		} else if (arg == "--threads" && hasValue) {
+			options.threads = std::atoi(argv[++i]);
+		} else if (arg == "--out" && hasValue) {
+			options.out = fopen(argv[++i], "w");
+			if (options.out == nullptr) {
+				printf("failed to open %s for writing\n", argv[i]);
+				return 1;
+			}
+		} else {
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	ofInit();
+
+	BenchmarkPush(options);
+
+	for (size_t n : options.sizes) {
+		for (Shape shape : shapes) {
+			fprintf(stderr, "benchmarking %s with %zu nodes\n", ShapeName(shape), n);
+			BenchmarkShape(shape, n, options);
+		}
+	}
+
+	if (options.out != stdout) {
+		fclose(options.out);
+	}
+	return 0;
+}
+
+#endif // RUN_DOCTEST
@@ -0,0 +1,39 @@
+#include "benchmarkNodes.h"
+
+using namespace seam;
+using namespace seam::nodes;
+
+BenchmarkSource::BenchmarkSource() : INode(metadata) {
+}
+
+BenchmarkSource::~BenchmarkSource() {
+
+}
+
+PinInput* BenchmarkSource::PinInputs(size_t& size) {
+	size = 0;
+	return nullptr;
+}
+
+PinOutput* BenchmarkSource::PinOutputs(size_t& size) {
+	size = pinOutputs.size();
+	return pinOutputs.data();
+}
+
+BenchmarkProbe::BenchmarkProbe() : INode(metadata) {
+	flags = (NodeFlags)(flags | NodeFlags::IsVisual);
+}
+
+BenchmarkProbe::~BenchmarkProbe() {
+
+}
+
+PinInput* BenchmarkProbe::PinInputs(size_t& size) {
+	size = pinInputs.size();
+	return pinInputs.data();
+}
+
+PinOutput* BenchmarkProbe::PinOutputs(size_t& size) {
+	size = 0;
+	return nullptr;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "seam/include.h"
+
+#include "seam/pins/pin.h"
+
+using namespace seam::pins;
+
+namespace seam::nodes {
+	/// @brief Number of elements each benchmark pin can hold.
+	constexpr size_t BENCHMARK_PIN_ELEMENTS = 256;
+
+	/// @brief Has one output of each basic pin type, so Push() can be timed for every conversion.
+	/// Never pushes anything on its own; the benchmark pushes through its outputs directly.
+	class BenchmarkSource : public INode {
+	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("Benchmark Source", { }, { PinType::Float, PinType::Int, PinType::Uint, PinType::Bool, PinType::Char });
+
+		BenchmarkSource();
+		~BenchmarkSource();
+
+		PinInput* PinInputs(size_t& size) override;
+
+		PinOutput* PinOutputs(size_t& size) override;
+
+	private:
+		std::array<PinOutput, 6> pinOutputs = {
+			pins::SetupOutputPin(this, PinType::Float, "Float"),
+			pins::SetupOutputPin(this, PinType::Int, "Int"),
+			pins::SetupOutputPin(this, PinType::Uint, "Uint"),
+			pins::SetupOutputPin(this, PinType::Bool, "Bool"),
+			pins::SetupOutputPin(this, PinType::Char, "Char"),
+			pins::SetupOutputPin(this, PinType::Float, "Vec2", 2),
+		};
+	};
+
+	/// @brief A visual Node which doesn't draw anything.
+	/// Only Nodes upstream of the visual output node update, so benchmark graphs end in a probe.
+	/// Has one input of each basic pin type to receive pushes from a BenchmarkSource.
+	class BenchmarkProbe : public INode {
+	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("Benchmark Probe", { PinType::Float, PinType::Int, PinType::Uint, PinType::Bool, PinType::Char }, { });
+
+		BenchmarkProbe();
+		~BenchmarkProbe();
+
+		PinInput* PinInputs(size_t& size) override;
+
+		PinOutput* PinOutputs(size_t& size) override;
+
+	private:
+		std::array<float, BENCHMARK_PIN_ELEMENTS> floats = { 0 };
+		std::array<int32_t, BENCHMARK_PIN_ELEMENTS> ints = { 0 };
+		std::array<uint32_t, BENCHMARK_PIN_ELEMENTS> uints = { 0 };
+		std::array<bool, BENCHMARK_PIN_ELEMENTS> bools = { 0 };
+		std::array<char, BENCHMARK_PIN_ELEMENTS> chars = { 0 };
+		std::array<glm::vec3, BENCHMARK_PIN_ELEMENTS> vec3s;
+
+		std::array<PinInput, 6> pinInputs = {
+			pins::SetupInputPin(PinType::Float, this, floats.data(), floats.size(), "Float"),
+			pins::SetupInputPin(PinType::Int, this, ints.data(), ints.size(), "Int"),
+			pins::SetupInputPin(PinType::Uint, this, uints.data(), uints.size(), "Uint"),
+			pins::SetupInputPin(PinType::Bool, this, bools.data(), bools.size(), "Bool"),
+			pins::SetupInputPin(PinType::Char, this, chars.data(), chars.size(), "Char"),
+			pins::SetupInputPin(PinType::Float, this, vec3s.data(), vec3s.size(), "Vec3",
+				PinInOptions::WithCoords(3)),
+		};
+	};
+}
@@ -0,0 +1,151 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+
+#include "seam/seamGraph.h"
+#include "seam/clock.h"
+
+#include <chrono>
+
+#if RUN_DOCTEST
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#else
+
+namespace {
+	void PrintUsage() {
+		printf("usage: example_headless <graph.seam> [--frames N] [--dt SECONDS] [--size WxH] [--draw] [--threads N] [--pipelined] [--trace FILE]\n");
+		printf("  --frames   number of frames to step (default 600)\n");
+		printf("  --dt       fixed time step per frame (default 1/60)\n");
+		printf("  --size     resolution used for window-sized nodes (default 1920x1080)\n");
+		printf("  --draw     create a hidden GL window and draw the graph each frame\n");
+		printf("  --threads  worker threads used for thread safe node updates (default 0)\n");
+		printf("  --pipelined  update thread safe nodes for the next frame while the current frame draws\n");
+		printf("  --trace    profile nodes and write a chrome://tracing / Perfetto JSON file\n");
+	}
+}
+
+//========================================================================
+/// Steps a saved graph as fast as possible with a fixed time step, without the Seam Editor.
+/// Without --draw, no window or GL context is created, so graphs containing nodes which
+/// allocate GL resources on creation need --draw (and a display, e.g. xvfb on CI machines).
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		PrintUsage();
+		return 1;
+	}
+
+	std::string graphPath = argv[1];
+	int frames = 600;
+	float dt = 1.f / 60.f;
+	glm::ivec2 size(1920, 1080);
+	bool draw = false;
+	size_t threads = 0;
+	bool pipelined = false;
+	std::string tracePath;
+
+	for (int i = 2; i < argc; i++) {
+		std::string_view arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--frames" && hasValue) {
+			frames = std::atoi(argv[++i]);
+		} else if (arg == "--dt" && hasValue) {
+			dt = std::atof(argv[++i]);
+		} else if (arg == "--size" && hasValue) {
+			if (sscanf(argv[++i], "%dx%d", &size.x, &size.y) != 2) {
+				PrintUsage();
+				return 1;
+			}
+		} else if (arg == "--draw") {
+			draw = true;
+		} else if (arg == "--threads" && hasValue) {
+			threads = std::atoi(argv[++i]);
+		} else if (arg == "--pipelined") {
+			pipelined = true;
+		} else if (arg == "--trace" && hasValue) {
+			tracePath = argv[++i];
+		} else {
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	if (frames <= 0 || dt <= 0.f || size.x <= 0 || size.y <= 0) {
+		PrintUsage();
+		return 1;
+	}
+
+	if (draw) {
+		ofGLFWWindowSettings settings;
+		settings.setGLVersion(4, 5);
+		settings.setSize(size.x, size.y);
+		settings.visible = false;
+		settings.title = "Seam Headless";
+		ofCreateWindow(settings);
+	} else {
+		ofInit();
+	}
+
+	seam::FixedStepClock clock(dt);
+	seam::SeamGraph graph;
+	graph.SetClock(&clock);
+	graph.SetUpdateThreads(threads);
+	graph.SetPipelined(pipelined);
+	graph.OnWindowResized(size.x, size.y);
+
+	std::vector<seam::SeamGraph::Link> links;
+	if (!graph.LoadGraph(graphPath, links)) {
+		printf("failed to load graph %s\n", graphPath.c_str());
+		return 1;
+	}
+
+	if (!tracePath.empty()) {
+		graph.SetProfiling(true);
+		graph.GetProfiler().BeginTrace();
+	}
+
+	using Clock = std::chrono::steady_clock;
+	auto start = Clock::now();
+
+	for (int i = 0; i < frames; i++) {
+		clock.Step();
+		graph.Update();
+		if (draw) {
+			graph.Draw();
+		}
+	}
+	graph.FinishPipelinedUpdate();
+
+	double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	printf("graph: %s\n", graphPath.c_str());
+	printf("nodes: %zu\n", graph.GetNodes().size());
+	printf("frames: %d\n", frames);
+	printf("total_seconds: %f\n", seconds);
+	printf("ms_per_frame: %f\n", seconds * 1000.0 / frames);
+	printf("frames_per_second: %f\n", frames / seconds);
+
+	if (!tracePath.empty()) {
+		// Slowest Nodes first, by average Update() time.
+		std::vector<std::pair<seam::TimingStats, seam::nodes::INode*>> timings;
+		for (auto n : graph.GetNodes()) {
+			timings.push_back(std::make_pair(graph.GetNodeTimings(n, seam::ProfileScope::Update), n));
+		}
+		std::sort(timings.begin(), timings.end(), [](const auto& a, const auto& b) {
+			return a.first.avg_ms > b.first.avg_ms;
+		});
+		for (size_t i = 0; i < std::min<size_t>(timings.size(), 10); i++) {
+			const auto& t = timings[i];
+			printf("update_ms: %s (%llu) min %f avg %f p99 %f\n", t.second->InstanceName().c_str(),
+				(unsigned long long)t.second->Id(), t.first.min_ms, t.first.avg_ms, t.first.p99_ms);
+		}
+
+		if (!graph.GetProfiler().WriteTrace(tracePath)) {
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+#endif // RUN_DOCTEST
@@ -5,15 +5,9 @@
 using namespace seam;
 using namespace seam::nodes;
 
-namespace {
-	glm::vec4 PosPtr(glm::vec4* ptr) {
-		return *ptr;
-	}
-}
-
-Fireflies::Fireflies() : INode("Fireflies"), 
-	ff_octree(glm::vec3(0.f), glm::vec3(512.f), PosPtr),  
-	mom_octree(glm::vec3(0.f), glm::vec3(512.f), PosPtr)
+Fireflies::Fireflies() : INode(metadata), 
+	ff_octree(glm::vec3(0.f), glm::vec3(512.f)),  
+	mom_octree(glm::vec3(0.f), glm::vec3(512.f))
 {
 	flags = (NodeFlags)(flags | NodeFlags::IsVisual);
 
@@ -174,6 +168,8 @@ void Fireflies::Setup(SetupParams* params) {
 	box.setPosition(glm::vec3(0.f));
 	box.setScale(glm::vec3(0.1f));
 
+	// The avoidance thread runs searches too, as worker 0.
+	avoidance_workers = std::make_unique<WorkerPool>(std::max(2u, std::thread::hardware_concurrency()) - 1);
 	avoidance_thread = std::thread(&Fireflies::AvoidanceLoop, this);
 }
 
@@ -325,7 +321,6 @@ bool Fireflies::GuiDrawPropertiesList(UpdateParams* params) {
 
 void Fireflies::AvoidanceLoop() {
 	assert(ff_posmap != nullptr && ff_dirmap != nullptr && mom_posmap != nullptr && mom_dirmap != nullptr);
-	std::vector<glm::vec4*> found;
 
 	while (!stop) {
 		// Request a refresh of mapped positions.
@@ -333,8 +328,8 @@ void Fireflies::AvoidanceLoop() {
 
 		auto start = std::chrono::high_resolution_clock::now();
 
-		UpdateDirections(ff_octree, ff_positions, ff_dirmap, fireflies_count, found, avoidanceRadius);
-		UpdateDirections(mom_octree, mom_positions, mom_dirmap, moms_count, found, momAvoidanceRadius);
+		UpdateDirections(ff_octree, ff_positions, ff_dirmap, fireflies_count, avoidanceRadius);
+		UpdateDirections(mom_octree, mom_positions, mom_dirmap, moms_count, momAvoidanceRadius);
 
 		auto stop = std::chrono::high_resolution_clock::now();
 		// printf("took %llu ms to update directions\n", (stop - start).count() / 100000);
@@ -367,19 +362,17 @@ void Fireflies::AvoidanceLoop() {
 }
 
 void Fireflies::UpdateDirections(
-	Octree<glm::vec4, 8>& octree,
+	PosOctree& octree,
 	const std::vector<glm::vec4>& positions, 
 	glm::vec4* dirmap, 
 	size_t count,
-	std::vector<glm::vec4*>& found, 
 	float avoidance_radius
 ) {
-	float max_force = 0.f;
-	for (size_t i = 0; i < count; i++) {
+	// For each particle, look nearby; particles are handed out to workers, so only write to this particle's direction.
+	octree.FindItemsBatch(positions.data(), count, avoidance_radius, [&](size_t i, const std::vector<glm::vec4*>& found) {
+		float max_force = 0.f;
 		glm::vec3 dir(0.f);
 		glm::vec3 my_pos = positions[i];
-		// For each particle, look nearby.
-		octree.FindItems(my_pos, avoidance_radius, found);
 		// Each nearby particle exerts a force based on how far away it is.
 		// Closer particles exert more force.-
 		for (size_t j = 0; j < found.size(); j++) {
@@ -404,5 +397,5 @@ void Fireflies::UpdateDirections(
 		}
 
 		dirmap[i] = glm::vec4(dir, 1.f);
-	}
+	}, avoidance_workers.get());
 }
@@ -4,6 +4,7 @@
 
 #include "seam/pins/pin.h"
 #include "seam/containers/octree.h"
+#include "seam/workerPool.h"
 
 using namespace seam::pins;
 
@@ -13,6 +14,8 @@ namespace seam::nodes {
 	/// </summary>
 	class Fireflies : public INode {
 	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("Fireflies", { PinType::Float, PinType::Uint }, { PinType::FboRgba });
+
 		Fireflies();
 		~Fireflies();
 
@@ -29,14 +32,21 @@ namespace seam::nodes {
 		bool GuiDrawPropertiesList(UpdateParams* params) override;
 
 	private:
+		struct PosPtr {
+			inline glm::vec3 operator()(glm::vec4* ptr) const {
+				return *ptr;
+			}
+		};
+
+		using PosOctree = Octree<glm::vec4, 8, PosPtr>;
+
 		bool LoadShaders();
 		void AvoidanceLoop(); 
 		void UpdateDirections(
-			Octree<glm::vec4, 8>& octree,
+			PosOctree& octree,
 			const std::vector<glm::vec4>& positions, 
 			glm::vec4* dirmap, 
 			size_t count, 
-			std::vector<glm::vec4*>& found, 
 			float avoidance_radius
 		);
 
@@ -68,10 +78,12 @@ namespace seam::nodes {
 			glm::vec3 col_d;
 		};
 
-		Octree<glm::vec4, 8> ff_octree;
-		Octree<glm::vec4, 8> mom_octree;
+		PosOctree ff_octree;
+		PosOctree mom_octree;
 		
 		std::thread avoidance_thread;
+		/// Splits each avoidance pass's neighbour searches across cores.
+		std::unique_ptr<WorkerPool> avoidance_workers;
 		bool stop = false;
 		bool invalidate_posmap = false;
 		bool invalidate_dirmap = false;
@@ -8,7 +8,7 @@ using namespace seam::pins;
 using namespace seam::nodes;
 using namespace seam::notes;
 
-ForceGrid::ForceGrid() : INode("Force Grid") {
+ForceGrid::ForceGrid() : INode(metadata) {
 	flags = (NodeFlags)(flags | NodeFlags::IsVisual);
 	pinNotesOnStream = &pin_inputs[2];
 	pinNotesOffStream = &pin_inputs[3];
@@ -9,6 +9,8 @@ namespace seam::nodes {
 	// This is an example of notes-to-shader, not meant to be re-used in any way.
 	class ForceGrid : public INode {
 	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("Force Grid", { PinType::Float, PinType::NoteEvent }, { PinType::FboRgba });
+
 		ForceGrid();
 		virtual ~ForceGrid();
 
@@ -3,8 +3,7 @@
 using namespace seam::nodes;
 using namespace seam::pins;
 
-// TODO: Replace the name "Node Template" with your custom Node's user-facing name.
-NodeTemplate::NodeTemplate() : INode("Node Template") {
+NodeTemplate::NodeTemplate() : INode(metadata) {
     // TODOs:
     // - Configure node flags
     // - Configure gui display FBO, required if this node is visual
@@ -10,6 +10,10 @@ namespace seam::nodes {
     /// TODO: Inherit IDynamicPinsNode instead of INode if the Node has dynamic pins which need to serialize/deserialize.
 	class NodeTemplate : public INode {
 	public:
+		// TODO: Replace the name "Node Template" with your custom Node's user-facing name,
+		// and list the input and output pin types this Node can have.
+		static constexpr NodeMetadata metadata = NodeMetadata("Node Template", { }, { });
+
 		NodeTemplate();
 		~NodeTemplate();
         
@@ -36,8 +36,8 @@ void ofApp::setup(){
 
 	// Add your custom Seam nodes here.
 	seam::EventNodeFactory* factory = seamEditor.GetFactory();
-	factory->Register(factory->MakeCreate<seam::nodes::Fireflies>());
-	factory->Register(factory->MakeCreate<seam::nodes::ForceGrid>());
+	factory->Register<seam::nodes::Fireflies>();
+	factory->Register<seam::nodes::ForceGrid>();
 
 	seamEditor.Setup(&soundSettings);
 }
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "ofMain.h"
+
+namespace seam {
+	/// @brief Supplies time to a SeamGraph's update and draw params.
+	/// The default clock reads OpenFrameworks' timers, which require a running OF app;
+	/// inject a different clock to run a graph headless, or faster than real time.
+	class IClock {
+	public:
+		virtual ~IClock() { }
+
+		/// @return Seconds elapsed since the clock started.
+		virtual float Time() = 0;
+
+		/// @return Seconds elapsed during the last frame.
+		virtual float DeltaTime() = 0;
+	};
+
+	/// @brief Reads time from OpenFrameworks' app timers.
+	class OfClock final : public IClock {
+	public:
+		float Time() override {
+			return ofGetElapsedTimef();
+		}
+
+		float DeltaTime() override {
+			return ofGetLastFrameTime();
+		}
+	};
+
+	/// @brief A deterministic clock which only advances when Step() is called.
+	/// Useful for benchmarks and offline rendering, where frames should be stepped as fast as possible.
+	class FixedStepClock final : public IClock {
+	public:
+		FixedStepClock(float _deltaTime = 1.f / 60.f) {
+			deltaTime = _deltaTime;
+		}
+
+		/// @brief Advance time by one frame.
+		inline void Step() {
+			time += deltaTime;
+		}
+
+		inline void Reset() {
+			time = 0.f;
+		}
+
+		float Time() override {
+			return time;
+		}
+
+		float DeltaTime() override {
+			return deltaTime;
+		}
+
+	private:
+		float time = 0.f;
+		float deltaTime;
+	};
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <memory>
+
+namespace seam {
+
+	/// @brief Optional value on the heap, for state most instances of a class never use:
+	/// costs one pointer until Get() is first called. Unlike std::unique_ptr it's copyable,
+	/// copying the value, so classes holding one keep their copy semantics.
+	template <typename T>
+	class Boxed {
+	public:
+		Boxed() { }
+
+		Boxed(const Boxed& other) {
+			if (other.value != nullptr) {
+				value = std::make_unique<T>(*other.value);
+			}
+		}
+
+		Boxed(Boxed&& other) noexcept = default;
+
+		Boxed& operator=(const Boxed& other) {
+			if (this != &other) {
+				value = other.value != nullptr ? std::make_unique<T>(*other.value) : nullptr;
+			}
+			return *this;
+		}
+
+		Boxed& operator=(Boxed&& other) noexcept = default;
+
+		/// @return The value, which is default constructed first if there isn't one yet.
+		inline T& Get() {
+			if (value == nullptr) {
+				value = std::make_unique<T>();
+			}
+			return *value;
+		}
+
+		/// @return The value, or nullptr if there isn't one yet.
+		inline T* Find() const {
+			return value.get();
+		}
+
+	private:
+		std::unique_ptr<T> value;
+	};
+}
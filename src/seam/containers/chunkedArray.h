@@ -0,0 +1,131 @@
+#pragma once
+
+#if RUN_DOCTEST
+#include "doctest.h"
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace seam {
+
+	/// @brief Resizable array of fixed size elements, stored in fixed size chunks.
+	/// Elements never move once they're added, so pointers to them stay valid until they're removed;
+	/// growing only ever allocates new chunks, rather than reallocating and copying every element.
+	/// Shrinking keeps chunks around, so growing back doesn't allocate.
+	/// Element sizes are set at runtime, for untyped storage like VectorPinInput's.
+	class ChunkedArray {
+	public:
+		/// @param _elementSize Size of each element in bytes.
+		/// @param chunkElements Elements per chunk; rounded up to a power of two.
+		ChunkedArray(size_t _elementSize, size_t chunkElements = 256)
+			: elementSize(_elementSize)
+		{
+			assert(elementSize > 0);
+			while (((size_t)1 << chunkShift) < chunkElements) {
+				chunkShift++;
+			}
+		}
+
+		ChunkedArray(const ChunkedArray&) = delete;
+		ChunkedArray& operator=(const ChunkedArray&) = delete;
+
+		inline size_t Size() const {
+			return size;
+		}
+
+		inline size_t ElementSize() const {
+			return elementSize;
+		}
+
+		/// @brief Elements past the old size are zeroed. Existing elements stay where they are.
+		void Resize(size_t newSize) {
+			const size_t chunkElements = (size_t)1 << chunkShift;
+			while (chunks.size() * chunkElements < newSize) {
+				chunks.push_back(std::make_unique<char[]>(chunkElements * elementSize));
+			}
+
+			// Zero a chunk's run of new elements at a time.
+			for (size_t i = size; i < newSize; ) {
+				const size_t run = std::min(newSize - i, chunkElements - (i & (chunkElements - 1)));
+				std::memset(At(i), 0, run * elementSize);
+				i += run;
+			}
+			size = newSize;
+		}
+
+		inline void* At(size_t i) {
+			assert(i < chunks.size() << chunkShift);
+			return chunks[i >> chunkShift].get() + (i & (((size_t)1 << chunkShift) - 1)) * elementSize;
+		}
+
+		template <typename T>
+		inline T& At(size_t i) {
+			assert(sizeof(T) == elementSize);
+			return *(T*)At(i);
+		}
+
+		/// @brief Call func(first, count) for each contiguous run of elements, in order;
+		/// for loops which should run over plain arrays.
+		template <typename T, typename Func>
+		void ForEachRun(Func&& func) {
+			assert(sizeof(T) == elementSize);
+			const size_t chunkElements = (size_t)1 << chunkShift;
+			for (size_t i = 0; i < size; i += chunkElements) {
+				func((T*)chunks[i >> chunkShift].get(), std::min(size - i, chunkElements));
+			}
+		}
+
+		/// @brief Bytes allocated for elements, including unused chunk space.
+		inline size_t CapacityBytes() const {
+			return (chunks.size() << chunkShift) * elementSize;
+		}
+
+	private:
+		size_t elementSize;
+		size_t chunkShift = 0;
+		size_t size = 0;
+		std::vector<std::unique_ptr<char[]>> chunks;
+	};
+}
+
+#if RUN_DOCTEST
+TEST_CASE("Test ChunkedArray elements keep their addresses while growing") {
+	seam::ChunkedArray arr(sizeof(int), 10);
+	arr.Resize(5);
+	for (size_t i = 0; i < 5; i++) {
+		CHECK(arr.At<int>(i) == 0);
+		arr.At<int>(i) = (int)i;
+	}
+	int* first = &arr.At<int>(0);
+	int* fourth = &arr.At<int>(4);
+
+	arr.Resize(1000);
+	CHECK(arr.Size() == 1000);
+	CHECK(&arr.At<int>(0) == first);
+	CHECK(&arr.At<int>(4) == fourth);
+	CHECK(*fourth == 4);
+	CHECK(arr.At<int>(999) == 0);
+
+	// Elements added back after shrinking are zeroed again.
+	const size_t capacity = arr.CapacityBytes();
+	arr.At<int>(700) = 7;
+	arr.Resize(3);
+	arr.Resize(800);
+	CHECK(arr.CapacityBytes() == capacity);
+	CHECK(arr.At<int>(700) == 0);
+	CHECK(arr.At<int>(2) == 2);
+
+	size_t visited = 0;
+	arr.ForEachRun<int>([&](int* run, size_t count) {
+		// Chunks are 16 elements, the next power of two.
+		CHECK(count <= 16);
+		CHECK(run == &arr.At<int>(visited));
+		visited += count;
+	});
+	CHECK(visited == 800);
+}
+#endif // RUN_DOCTEST
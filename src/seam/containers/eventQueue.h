@@ -0,0 +1,409 @@
+#pragma once
+
+#if RUN_DOCTEST
+#include "doctest.h"
+#include <thread>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace seam {
+
+	/// @brief Queue of fixed size events which grows a chunk at a time.
+	/// Any number of threads can push (MIDI, OSC or audio callbacks, or the update loop),
+	/// while a single consumer drains everything pushed so far in bulk.
+	/// Producers claim slots in the last chunk with an atomic increment, and whichever producer finds it full
+	/// links on another chunk, so bursts of events are kept rather than dropped.
+	/// The consumer never waits; it stops at the first slot which is still being written,
+	/// and hands drained chunks back to producers to reuse.
+	/// A producer may still be looking at a chunk after it's drained, so chunks are only freed along with the queue,
+	/// which keeps the memory of the largest burst so far.
+	class EventQueue {
+	public:
+		/// @param _elementSize Size of each event in bytes. Events are copied with memcpy,
+		/// so they must be trivially copyable.
+		/// @param _chunkEvents Number of events in each chunk.
+		/// @param _maxEvents If non-zero, events pushed while this many are waiting to be drained
+		/// are dropped and counted, like RingBuffer, rather than growing the queue.
+		EventQueue(size_t _elementSize, size_t _chunkEvents = 256, size_t _maxEvents = 0)
+			: elementSize(_elementSize)
+			, chunkEvents(_chunkEvents)
+			, maxEvents(_maxEvents)
+		{
+			assert(elementSize > 0 && chunkEvents > 0);
+			head = NewChunk();
+			tail.store(head, std::memory_order_relaxed);
+			for (auto& spare : spares) {
+				spare.store(nullptr, std::memory_order_relaxed);
+			}
+		}
+
+		~EventQueue() {
+			Chunk* chunk = head;
+			while (chunk != nullptr) {
+				Chunk* next = chunk->next.load(std::memory_order_relaxed);
+				delete chunk;
+				chunk = next;
+			}
+			chunk = returned.load(std::memory_order_relaxed);
+			while (chunk != nullptr) {
+				Chunk* next = chunk->nextReturned;
+				delete chunk;
+				chunk = next;
+			}
+			for (auto& spare : spares) {
+				delete spare.load(std::memory_order_relaxed);
+			}
+			for (Chunk* c : retired) {
+				delete c;
+			}
+			for (Chunk* c : idle) {
+				delete c;
+			}
+		}
+
+		EventQueue(const EventQueue&) = delete;
+		EventQueue& operator=(const EventQueue&) = delete;
+
+		/// @brief Copy events to the back of the queue, in order. Safe to call from any thread.
+		/// Events from different producers may interleave.
+		/// @return The number of events pushed; less than count only if the queue has a maximum and reached it.
+		size_t Push(const void* events, size_t count) {
+			const char* src = (const char*)events;
+			for (size_t i = 0; i < count; i++, src += elementSize) {
+				if (maxEvents != 0 && waiting.fetch_add(1, std::memory_order_relaxed) >= maxEvents) {
+					waiting.fetch_sub(1, std::memory_order_relaxed);
+					overflows.fetch_add(1, std::memory_order_relaxed);
+					dropped.fetch_add(count - i, std::memory_order_relaxed);
+					return i;
+				}
+
+				while (true) {
+					Chunk* chunk = tail.load(std::memory_order_seq_cst);
+					// Pin the chunk so the consumer doesn't recycle it while it's in use,
+					// then make sure it wasn't retired before it could be pinned.
+					chunk->users.fetch_add(1, std::memory_order_seq_cst);
+					if (tail.load(std::memory_order_seq_cst) != chunk) {
+						chunk->users.fetch_sub(1, std::memory_order_release);
+						continue;
+					}
+
+					const size_t index = chunk->claimed.fetch_add(1, std::memory_order_relaxed);
+					if (index < chunkEvents) {
+						memcpy(chunk->data.get() + index * elementSize, src, elementSize);
+						// Publish the event to the consumer.
+						chunk->ready[index].store(true, std::memory_order_release);
+						chunk->users.fetch_sub(1, std::memory_order_release);
+						break;
+					}
+
+					// The chunk's full, so link on the next one unless another producer already has.
+					Chunk* next = chunk->next.load(std::memory_order_acquire);
+					if (next == nullptr) {
+						Chunk* fresh = TakeChunk();
+						if (chunk->next.compare_exchange_strong(next, fresh, std::memory_order_acq_rel)) {
+							next = fresh;
+						} else {
+							ReturnChunk(fresh);
+						}
+					}
+					tail.compare_exchange_strong(chunk, next, std::memory_order_seq_cst);
+					chunk->users.fetch_sub(1, std::memory_order_release);
+				}
+			}
+			return count;
+		}
+
+		/// @brief Move everything pushed so far into the consumer's contiguous buffer.
+		/// Only the consumer thread may call this.
+		/// @param size Set to the number of drained events which haven't been consumed yet.
+		/// @return The first drained event.
+		void* Drain(size_t& size) {
+			const size_t before = drained.size();
+			while (true) {
+				if (readIndex == chunkEvents) {
+					Chunk* next = head->next.load(std::memory_order_acquire);
+					if (next == nullptr) {
+						break;
+					}
+					retired.push_back(head);
+					head = next;
+					readIndex = 0;
+				}
+				if (!head->ready[readIndex].load(std::memory_order_acquire)) {
+					break;
+				}
+
+				const char* src = head->data.get() + readIndex * elementSize;
+				drained.insert(drained.end(), src, src + elementSize);
+				readIndex++;
+			}
+			if (maxEvents != 0) {
+				waiting.fetch_sub((drained.size() - before) / elementSize, std::memory_order_relaxed);
+			}
+			Recycle();
+
+			size = drained.size() / elementSize;
+			return drained.data();
+		}
+
+		/// @brief Drop the first count drained events. Only the consumer thread may call this.
+		void Consume(size_t count) {
+			const size_t bytes = std::min(count * elementSize, drained.size());
+			drained.erase(drained.begin(), drained.begin() + bytes);
+		}
+
+		inline size_t ElementSize() const {
+			return elementSize;
+		}
+
+		/// @brief Bytes the queue keeps on the heap. Only the consumer thread may call this.
+		size_t HeapBytes() const {
+			return allocatedChunks.load(std::memory_order_relaxed)
+				* (sizeof(Chunk) + chunkEvents * (elementSize + sizeof(std::atomic<bool>)))
+				+ drained.capacity() + (retired.capacity() + idle.capacity()) * sizeof(Chunk*);
+		}
+
+		/// @brief Number of pushes which were cut short, whole or in part, because the queue was at its maximum.
+		inline uint64_t Overflows() const {
+			return overflows.load(std::memory_order_relaxed);
+		}
+
+		/// @brief Number of events dropped because the queue was at its maximum.
+		inline uint64_t Dropped() const {
+			return dropped.load(std::memory_order_relaxed);
+		}
+
+	private:
+		struct Chunk {
+			Chunk(size_t elementSize, size_t events)
+				: ready(std::make_unique<std::atomic<bool>[]>(events))
+				, data(std::make_unique<char[]>(events * elementSize))
+			{
+				for (size_t i = 0; i < events; i++) {
+					ready[i].store(false, std::memory_order_relaxed);
+				}
+			}
+
+			/// @brief Slots handed out to producers; keeps counting past the chunk's size once it's full.
+			std::atomic<size_t> claimed { 0 };
+			std::atomic<Chunk*> next { nullptr };
+			/// @brief Producers currently between reading the queue's tail and being done with this chunk.
+			/// Never reset, since a producer with a stale tail may still be counting itself in and out.
+			std::atomic<uint32_t> users { 0 };
+			/// @brief Link in EventQueue::returned.
+			Chunk* nextReturned = nullptr;
+			std::unique_ptr<std::atomic<bool>[]> ready;
+			std::unique_ptr<char[]> data;
+		};
+
+		Chunk* NewChunk() {
+			allocatedChunks.fetch_add(1, std::memory_order_relaxed);
+			return new Chunk(elementSize, chunkEvents);
+		}
+
+		/// @return A recycled chunk if the consumer has left one out, otherwise a new one.
+		Chunk* TakeChunk() {
+			for (auto& spare : spares) {
+				Chunk* chunk = spare.exchange(nullptr, std::memory_order_acq_rel);
+				if (chunk != nullptr) {
+					return chunk;
+				}
+			}
+			return NewChunk();
+		}
+
+		/// @brief Hand a chunk a producer took but didn't link back to the consumer.
+		/// It may have been recycled, so it can't be freed here.
+		void ReturnChunk(Chunk* chunk) {
+			Chunk* top = returned.load(std::memory_order_relaxed);
+			do {
+				chunk->nextReturned = top;
+			} while (!returned.compare_exchange_weak(top, chunk, std::memory_order_release, std::memory_order_relaxed));
+		}
+
+		/// @brief Reset drained chunks once no producer can still be writing to them,
+		/// and leave them out for TakeChunk().
+		void Recycle() {
+			size_t kept = 0;
+			for (Chunk* chunk : retired) {
+				if (tail.load(std::memory_order_seq_cst) == chunk || chunk->users.load(std::memory_order_seq_cst) != 0) {
+					retired[kept++] = chunk;
+					continue;
+				}
+				chunk->claimed.store(0, std::memory_order_relaxed);
+				chunk->next.store(nullptr, std::memory_order_relaxed);
+				for (size_t i = 0; i < chunkEvents; i++) {
+					chunk->ready[i].store(false, std::memory_order_relaxed);
+				}
+				idle.push_back(chunk);
+			}
+			retired.resize(kept);
+
+			// Returned chunks are already empty.
+			Chunk* chunk = returned.exchange(nullptr, std::memory_order_acquire);
+			while (chunk != nullptr) {
+				idle.push_back(chunk);
+				chunk = chunk->nextReturned;
+			}
+
+			// Only the consumer fills spares, so an empty one stays empty until it's stored to.
+			for (auto& spare : spares) {
+				if (idle.empty()) {
+					break;
+				}
+				if (spare.load(std::memory_order_relaxed) == nullptr) {
+					spare.store(idle.back(), std::memory_order_release);
+					idle.pop_back();
+				}
+			}
+		}
+
+		const size_t elementSize;
+		const size_t chunkEvents;
+		const size_t maxEvents;
+
+		/// @brief Shared by producers. On its own cache line, so pushing doesn't invalidate the consumer's state.
+		alignas(64) std::atomic<Chunk*> tail { nullptr };
+		/// @brief Events pushed but not drained yet; only kept while there's a maximum.
+		std::atomic<size_t> waiting { 0 };
+		std::atomic<uint64_t> overflows { 0 };
+		std::atomic<uint64_t> dropped { 0 };
+		std::atomic<size_t> allocatedChunks { 0 };
+		/// @brief Empty chunks the consumer has left out for producers to link on, so steady bursts don't allocate.
+		std::array<std::atomic<Chunk*>, 4> spares;
+		/// @brief Stack of chunks producers took but didn't need, for the consumer to take back.
+		std::atomic<Chunk*> returned { nullptr };
+
+		/// @brief Only touched by the consumer.
+		alignas(64) Chunk* head = nullptr;
+		size_t readIndex = 0;
+		/// @brief Chunks the consumer is done with, which a producer may still be writing to.
+		std::vector<Chunk*> retired;
+		/// @brief Empty chunks which don't fit in spares.
+		std::vector<Chunk*> idle;
+		std::vector<char> drained;
+	};
+}
+
+#if RUN_DOCTEST
+TEST_CASE("Test EventQueue grows past its chunk size and drains every event in order") {
+	seam::EventQueue queue(sizeof(int), 4);
+	for (int i = 0; i < 10; i++) {
+		CHECK(queue.Push(&i, 1) == 1);
+	}
+	int more[7] = { 10, 11, 12, 13, 14, 15, 16 };
+	CHECK(queue.Push(more, 7) == 7);
+	CHECK(queue.Dropped() == 0);
+
+	size_t size;
+	int* events = (int*)queue.Drain(size);
+	REQUIRE(size == 17);
+	for (int i = 0; i < 17; i++) {
+		CHECK(events[i] == i);
+	}
+
+	// Consuming part of the events keeps the rest for the next drain.
+	queue.Consume(15);
+	queue.Push(more, 1);
+	events = (int*)queue.Drain(size);
+	REQUIRE(size == 3);
+	CHECK(events[0] == 15);
+	CHECK(events[1] == 16);
+	CHECK(events[2] == 10);
+}
+
+TEST_CASE("Test EventQueue reuses drained chunks") {
+	seam::EventQueue queue(sizeof(int), 4);
+	int burst[10] = { };
+	size_t size;
+	size_t bytes = 0;
+	for (int frame = 0; frame < 50; frame++) {
+		queue.Push(burst, 10);
+		queue.Drain(size);
+		CHECK(size == 10);
+		queue.Consume(size);
+		if (frame == 5) {
+			bytes = queue.HeapBytes();
+		}
+	}
+	CHECK(queue.HeapBytes() == bytes);
+}
+
+TEST_CASE("Test EventQueue with a maximum drops and counts what doesn't fit") {
+	seam::EventQueue queue(sizeof(int), 4, 6);
+	int vals[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+	CHECK(queue.Push(vals, 8) == 6);
+	CHECK(queue.Push(vals, 1) == 0);
+	CHECK(queue.Overflows() == 2);
+	CHECK(queue.Dropped() == 3);
+
+	// Draining makes room again, even before the drained events are consumed.
+	size_t size;
+	queue.Drain(size);
+	CHECK(size == 6);
+	CHECK(queue.Push(vals + 6, 2) == 2);
+	int* events = (int*)queue.Drain(size);
+	REQUIRE(size == 8);
+	CHECK(events[5] == 5);
+	CHECK(events[6] == 6);
+	CHECK(events[7] == 7);
+}
+
+TEST_CASE("Test EventQueue loses no events with several producer threads") {
+	// Small chunks, so producers keep racing to link on new ones while the consumer recycles old ones.
+	seam::EventQueue queue(sizeof(uint32_t), 16);
+	const uint32_t PRODUCERS = 4;
+	const uint32_t EVENTS_PER_PRODUCER = 20000;
+
+	std::vector<std::thread> producers;
+	for (uint32_t p = 0; p < PRODUCERS; p++) {
+		producers.emplace_back([&queue, p, EVENTS_PER_PRODUCER]() {
+			for (uint32_t i = 0; i < EVENTS_PER_PRODUCER; i++) {
+				uint32_t ev = p * EVENTS_PER_PRODUCER + i;
+				queue.Push(&ev, 1);
+			}
+		});
+	}
+
+	// Drain while producers are still pushing.
+	std::vector<uint32_t> lastSeen(PRODUCERS, 0);
+	std::vector<uint32_t> counts(PRODUCERS, 0);
+	size_t total = 0;
+	auto drain = [&]() {
+		size_t size;
+		uint32_t* events = (uint32_t*)queue.Drain(size);
+		for (size_t i = 0; i < size; i++) {
+			const uint32_t p = events[i] / EVENTS_PER_PRODUCER;
+			const uint32_t n = events[i] % EVENTS_PER_PRODUCER;
+			// Each producer's events arrive in the order they were pushed.
+			CHECK((counts[p] == 0 || n > lastSeen[p]));
+			lastSeen[p] = n;
+			counts[p]++;
+		}
+		queue.Consume(size);
+		total += size;
+	};
+
+	while (total < PRODUCERS * EVENTS_PER_PRODUCER) {
+		drain();
+	}
+	for (auto& t : producers) {
+		t.join();
+	}
+	drain();
+
+	CHECK(total == PRODUCERS * EVENTS_PER_PRODUCER);
+	CHECK(queue.Dropped() == 0);
+	for (uint32_t p = 0; p < PRODUCERS; p++) {
+		CHECK(counts[p] == EVENTS_PER_PRODUCER);
+	}
+}
+#endif // RUN_DOCTEST
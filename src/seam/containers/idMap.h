@@ -0,0 +1,238 @@
+#pragma once
+
+#if RUN_DOCTEST
+#include "doctest.h"
+#endif
+
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace seam {
+
+	/// @brief Open addressing hash map from nonzero 64 bit keys (pin ids, node pointers, pre-hashed names) to values.
+	/// Slots are probed linearly in one flat array, so lookups are a hash and usually a single cache miss,
+	/// rather than the pointer chasing of std::map or std::unordered_map.
+	/// Erasing shifts later slots back instead of leaving tombstones, so lookups stay fast after many erases.
+	/// Pointers to values are invalidated by Set(), Insert() and Erase().
+	template <typename V>
+	class IdMap {
+	public:
+		IdMap(size_t initialCapacity = 16) {
+			size_t capacity = 16;
+			while (capacity < initialCapacity) {
+				capacity *= 2;
+			}
+			slots.resize(capacity);
+		}
+
+		/// @return The key's value, or nullptr if the key isn't in the map.
+		V* Find(uint64_t key) {
+			assert(key != EMPTY);
+			const size_t mask = slots.size() - 1;
+			for (size_t i = Mix(key) & mask; slots[i].key != EMPTY; i = (i + 1) & mask) {
+				if (slots[i].key == key) {
+					return &slots[i].value;
+				}
+			}
+			return nullptr;
+		}
+
+		/// @brief Add the key, or overwrite its value if it's already in the map.
+		void Set(uint64_t key, const V& value) {
+			*Emplace(key) = value;
+		}
+
+		/// @brief Add the key if it isn't in the map yet; leaves existing values alone.
+		/// @return true if the key was added.
+		bool Insert(uint64_t key, const V& value) {
+			const size_t before = count;
+			V* slot = Emplace(key);
+			if (count == before) {
+				return false;
+			}
+			*slot = value;
+			return true;
+		}
+
+		/// @return true if the key was in the map.
+		bool Erase(uint64_t key) {
+			assert(key != EMPTY);
+			const size_t mask = slots.size() - 1;
+			size_t i = Mix(key) & mask;
+			while (slots[i].key != key) {
+				if (slots[i].key == EMPTY) {
+					return false;
+				}
+				i = (i + 1) & mask;
+			}
+
+			// Shift back any later slot in the probe run which would be unreachable past the hole.
+			size_t hole = i;
+			for (size_t j = (i + 1) & mask; slots[j].key != EMPTY; j = (j + 1) & mask) {
+				const size_t home = Mix(slots[j].key) & mask;
+				// Can j's slot move to the hole, i.e. is its home outside of (hole, j]?
+				const bool movable = hole <= j
+					? (home <= hole || home > j)
+					: (home <= hole && home > j);
+				if (movable) {
+					slots[hole] = std::move(slots[j]);
+					hole = j;
+				}
+			}
+			slots[hole] = Slot();
+			count -= 1;
+			return true;
+		}
+
+		void Clear() {
+			for (auto& slot : slots) {
+				slot = Slot();
+			}
+			count = 0;
+		}
+
+		inline size_t Size() {
+			return count;
+		}
+
+		/// @brief Call func(key, value) for each entry, in no particular order.
+		template <typename Func>
+		void ForEach(Func&& func) {
+			for (auto& slot : slots) {
+				if (slot.key != EMPTY) {
+					func(slot.key, slot.value);
+				}
+			}
+		}
+
+	private:
+		static constexpr uint64_t EMPTY = 0;
+
+		struct Slot {
+			uint64_t key = EMPTY;
+			V value = V();
+		};
+
+		/// @brief Ids are handed out sequentially and pointers are aligned, so scramble the bits before masking.
+		/// This is the splitmix64 finalizer.
+		static inline uint64_t Mix(uint64_t key) {
+			key ^= key >> 30;
+			key *= 0xbf58476d1ce4e5b9ULL;
+			key ^= key >> 27;
+			key *= 0x94d049bb133111ebULL;
+			key ^= key >> 31;
+			return key;
+		}
+
+		/// @return The key's value slot, which is added (with a default value) if the key isn't in the map yet.
+		V* Emplace(uint64_t key) {
+			assert(key != EMPTY);
+			// Keep the load factor under 3/4 so probe runs stay short.
+			if ((count + 1) * 4 > slots.size() * 3) {
+				Grow();
+			}
+
+			const size_t mask = slots.size() - 1;
+			size_t i = Mix(key) & mask;
+			while (slots[i].key != EMPTY) {
+				if (slots[i].key == key) {
+					return &slots[i].value;
+				}
+				i = (i + 1) & mask;
+			}
+
+			slots[i].key = key;
+			count += 1;
+			return &slots[i].value;
+		}
+
+		void Grow() {
+			std::vector<Slot> old = std::move(slots);
+			slots = std::vector<Slot>(old.size() * 2);
+			count = 0;
+			for (auto& slot : old) {
+				if (slot.key != EMPTY) {
+					*Emplace(slot.key) = std::move(slot.value);
+				}
+			}
+		}
+
+		std::vector<Slot> slots;
+		size_t count = 0;
+	};
+}
+
+#if RUN_DOCTEST
+#include <map>
+#include <random>
+
+TEST_CASE("Test IdMap finds, overwrites and erases keys") {
+	seam::IdMap<int> map;
+	for (uint64_t i = 1; i <= 1000; i++) {
+		CHECK(map.Insert(i, (int)i * 2));
+	}
+	CHECK(map.Size() == 1000);
+	CHECK(!map.Insert(5, 0));
+	CHECK(*map.Find(5) == 10);
+	map.Set(5, 7);
+	CHECK(*map.Find(5) == 7);
+	CHECK(map.Find(1001) == nullptr);
+
+	for (uint64_t i = 1; i <= 1000; i += 2) {
+		CHECK(map.Erase(i));
+	}
+	CHECK(!map.Erase(1));
+	CHECK(map.Size() == 500);
+	for (uint64_t i = 1; i <= 1000; i++) {
+		int* v = map.Find(i);
+		if (i % 2 == 1) {
+			CHECK(v == nullptr);
+		} else {
+			REQUIRE(v != nullptr);
+			CHECK(*v == (int)i * 2);
+		}
+	}
+
+	map.Clear();
+	CHECK(map.Size() == 0);
+	CHECK(map.Find(2) == nullptr);
+}
+
+TEST_CASE("Test IdMap matches std::map under random inserts and erases") {
+	seam::IdMap<uint64_t> map(4);
+	std::map<uint64_t, uint64_t> expected;
+	std::mt19937_64 rng(42);
+
+	// A small key range makes for long probe runs, which is where backward shift erasing could go wrong.
+	for (int i = 0; i < 200000; i++) {
+		const uint64_t key = rng() % 512 + 1;
+		if (rng() % 3 == 0) {
+			CHECK(map.Erase(key) == (expected.erase(key) == 1));
+		} else {
+			map.Set(key, i);
+			expected[key] = i;
+		}
+	}
+
+	CHECK(map.Size() == expected.size());
+	for (uint64_t key = 1; key <= 512; key++) {
+		auto it = expected.find(key);
+		uint64_t* v = map.Find(key);
+		if (it == expected.end()) {
+			CHECK(v == nullptr);
+		} else {
+			REQUIRE(v != nullptr);
+			CHECK(*v == it->second);
+		}
+	}
+
+	size_t visited = 0;
+	map.ForEach([&](uint64_t key, uint64_t& value) {
+		CHECK(expected[key] == value);
+		visited++;
+	});
+	CHECK(visited == expected.size());
+}
+#endif // RUN_DOCTEST
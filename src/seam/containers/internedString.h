@@ -0,0 +1,96 @@
+#pragma once
+
+#if RUN_DOCTEST
+#include "doctest.h"
+#endif
+
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+namespace seam {
+
+	/// @brief Handle to an immutable string which is stored once for the lifetime of the program,
+	/// however many handles to it there are. Is a single pointer, for strings like pin descriptions
+	/// which are repeated across thousands of pins and never edited.
+	/// Strings which are edited in place (like pin names, which the GUI renames) should stay std::strings.
+	class InternedString {
+	public:
+		InternedString() { }
+
+		InternedString(std::string_view _str) {
+			if (!_str.empty()) {
+				str = Intern(_str);
+			}
+		}
+
+		inline std::string_view View() const {
+			return str != nullptr ? std::string_view(*str) : std::string_view();
+		}
+
+		inline operator std::string_view() const {
+			return View();
+		}
+
+		inline const char* c_str() const {
+			return str != nullptr ? str->c_str() : "";
+		}
+
+		inline bool empty() const {
+			return str == nullptr;
+		}
+
+		/// @brief Interned strings are never freed; is the heap memory they take up, roughly.
+		static size_t PoolBytes() {
+			Pool& pool = GetPool();
+			std::lock_guard<std::mutex> lock(pool.mutex);
+			return pool.bytes;
+		}
+
+	private:
+		struct Pool {
+			std::mutex mutex;
+			// Nodes never move, so pointers to the strings are stable.
+			std::unordered_set<std::string> strings;
+			size_t bytes = 0;
+		};
+
+		static Pool& GetPool() {
+			static Pool pool;
+			return pool;
+		}
+
+		static const std::string* Intern(std::string_view _str) {
+			Pool& pool = GetPool();
+			std::lock_guard<std::mutex> lock(pool.mutex);
+			auto inserted = pool.strings.emplace(_str);
+			if (inserted.second) {
+				pool.bytes += sizeof(std::string) + inserted.first->capacity() + 1;
+			}
+			return &*inserted.first;
+		}
+
+		const std::string* str = nullptr;
+	};
+}
+
+#if RUN_DOCTEST
+TEST_CASE("Test InternedString stores equal strings once") {
+	seam::InternedString empty;
+	CHECK(empty.empty());
+	CHECK(empty.View() == "");
+
+	std::string text = "Frequency of the wave, in hertz";
+	seam::InternedString a(text);
+	text[0] = 'f';
+	seam::InternedString b(std::string_view("Frequency of the wave, in hertz"));
+	CHECK(a.View() == "Frequency of the wave, in hertz");
+	CHECK(a.View().data() == b.View().data());
+
+	const size_t bytes = seam::InternedString::PoolBytes();
+	seam::InternedString c(a.View());
+	CHECK(seam::InternedString::PoolBytes() == bytes);
+	CHECK(seam::InternedString("").empty());
+}
+#endif // RUN_DOCTEST
@@ -2,58 +2,143 @@
 
 #if RUN_DOCTEST
 #include "doctest.h"
+#include <chrono>
+#include <iostream>
 #endif
 
-#include <functional>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
 #include "glm/glm.hpp"
+#include "seam/workerPool.h"
 
 namespace seam {
 
 	/// <summary>
 	/// Sparse Octree implementation.
+	/// Nodes live in a pool and refer to each other by index, so adding and removing items
+	/// recycles nodes instead of allocating them, and traversals walk one contiguous array.
 	/// TODOs:
 	/// - Handle worst case by vectorizing Leafs past a certain depth, letting them contain > N items.
 	/// </summary>
 	/// <typeparam name="T"></typeparam>
-	template <typename T, uint16_t N>
+	/// <typeparam name="PositionGetter">Callable type taking a T* and returning its glm::vec3 position;
+	/// a template parameter rather than a std::function so calls to it can be inlined.</typeparam>
+	template <typename T, uint16_t N, typename PositionGetter>
 	class Octree {
-		using PositionGetter = std::function<glm::vec3(T*)>;
-
 	public:
-		Octree(glm::vec3 _center, glm::vec3 _bounds, PositionGetter get_position) {
+		Octree(glm::vec3 _center, glm::vec3 _bounds, PositionGetter get_position = PositionGetter())
+			: GetPosition(get_position)
+		{
 			tree_center = _center;
 			tree_bounds = _bounds;
-			root = new OctreeNode(true, nullptr);
-			GetPosition = get_position;
+			const uint32_t root = NewNode(true, NoNode);
+			assert(root == Root);
 		}
 
-		~Octree() {
-			delete root;
+		size_t Count() const {
+			return nodes[Root].count;
 		}
 
-		size_t Count() {
-			return root->count;
+		/// <summary>
+		/// Number of nodes the pool holds, in use or free; only grows when the tree gets bigger than it's ever been.
+		/// </summary>
+		size_t PoolSize() const {
+			return nodes.size();
 		}
 
 		void Add(T* item, glm::vec3 position) {
-			Add(item, position, root, tree_center, tree_bounds);
+			uint32_t branch = Root;
+			glm::vec3 center = tree_center;
+			glm::vec3 bounds = tree_bounds;
+
+			while (true) {
+				const auto res = FindLeaf(position, branch, center, bounds);
+				assert(nodes[res.branch].is_branch);
+				uint32_t leaf = res.leaf;
+				if (leaf == NoNode) {
+					leaf = NewNode(false, res.branch);
+					nodes[res.branch].children[res.leaf_index] = leaf;
+				}
+
+				if (nodes[leaf].count >= N) {
+					// Leaf is full and needs to be split into a branch; then add to one of the branch's new leaves.
+					SplitLeaf(leaf, res.leaf_center, res.leaf_bounds);
+					branch = leaf;
+					center = res.leaf_center;
+					bounds = res.leaf_bounds;
+					ValidateTree(Root);
+					continue;
+				}
+
+				nodes[leaf].items[nodes[leaf].count] = item;
+
+				// Increase the item count for the Leaf and each Branch above it.
+				for (uint32_t updated = leaf; updated != NoNode; updated = nodes[updated].parent) {
+					nodes[updated].count += 1;
+				}
+				return;
+			}
 		}
 
 		void Remove(T* item, glm::vec3 position) {
-			Remove(item, position, root, tree_center, tree_bounds);
+			const auto res = FindLeaf(position, Root, tree_center, tree_bounds);
+			assert(nodes[res.branch].is_branch);
+			const uint32_t leaf = res.leaf;
+			assert(leaf != NoNode && nodes[leaf].count > 0);
+			if (leaf == NoNode) {
+				return;
+			}
+
+			OctreeNode& leaf_node = nodes[leaf];
+			uint32_t i = 0;
+			bool found = false;
+			for (; i < leaf_node.count; i++) {
+				if (leaf_node.items[i] == item) {
+					found = true;
+					break;
+				}
+			}
+
+			assert(found);
+			if (found) {
+				// Move the last item in the list to take the removed position.
+				leaf_node.items[i] = leaf_node.items[leaf_node.count - 1];
+				leaf_node.items[leaf_node.count - 1] = nullptr;
+
+				for (uint32_t updated = leaf; updated != NoNode; updated = nodes[updated].parent) {
+					nodes[updated].count -= 1;
+				}
+
+				// Return empty leaves to the pool.
+				if (nodes[leaf].count == 0) {
+					nodes[res.branch].children[res.leaf_index] = NoNode;
+					FreeNode(leaf);
+				}
+
+				if (nodes[res.branch].count < N/2 && res.branch != Root) {
+					CollapseBranch(res.branch);
+					ValidateTree(Root);
+				}
+			}
 		}
 
 		void Update(T* item, glm::vec3 old_pos, glm::vec3 new_pos) {
-			auto old_res = FindLeaf(old_pos, root, tree_center, tree_bounds);
-			auto new_res = FindLeaf(new_pos, root, tree_center, tree_bounds);
-			if (old_res.leaf != new_res.leaf) {
+			auto old_res = FindLeaf(old_pos, Root, tree_center, tree_bounds);
+			auto new_res = FindLeaf(new_pos, Root, tree_center, tree_bounds);
+			// Compare where the leaves are in the tree, since a new position in an empty octant has no leaf yet.
+			if (old_res.branch != new_res.branch || old_res.leaf_index != new_res.leaf_index) {
 
 				Remove(item, old_pos);
-				ValidateTree(root);
+				ValidateTree(Root);
 
 				Add(item, new_pos);
 
-				ValidateTree(root);
+				ValidateTree(Root);
 			}
 		}
 
@@ -66,50 +151,124 @@ namespace seam {
 		/// <returns></returns>
 		size_t FindItems(glm::vec3 center, float radius, std::vector<T*>& found) {
 			found.clear();
-			return FindItems(center, radius, tree_center, tree_bounds, root, found);
-		}
-
-		void PrintTree() {
-			PrintTree(root, tree_center, tree_bounds, 0);
+			return FindItems(center, radius, found, search_stack);
 		}
 
-	private:
-		struct OctreeNode {
-			OctreeNode* parent;
-			bool is_branch = false;
-			size_t count = 0;
+		/// <summary>
+		/// Search for items in a sphere around each of many centers, split across a WorkerPool's workers.
+		/// Queries are run in order along a Morton curve rather than in index order,
+		/// so each worker's consecutive queries walk mostly the same nodes.
+		/// The tree mustn't be modified until this returns.
+		/// </summary>
+		/// <param name="centers">The center of each search area; anything glm::vec3 can be constructed from.</param>
+		/// <param name="count">Number of centers.</param>
+		/// <param name="radius">Radius of the sphere for every search area.</param>
+		/// <param name="callback">Called as callback(index, found) once per center, where found is only valid during the call.
+		/// Calls for different indices run at the same time on different workers.</param>
+		/// <param name="pool">Workers to run the queries on; if nullptr, they all run on the calling thread.</param>
+		template <typename Vec, typename Callback>
+		void FindItemsBatch(const Vec* centers, size_t count, float radius, Callback&& callback, WorkerPool* pool = nullptr) {
+			batch_order.resize(count);
+			for (size_t i = 0; i < count; i++) {
+				batch_order[i] = BatchQuery { MortonCode(glm::vec3(centers[i])), (uint32_t)i };
+			}
+			std::sort(batch_order.begin(), batch_order.end(), [](const BatchQuery& a, const BatchQuery& b) {
+				return a.code < b.code;
+			});
 
-			OctreeNode(bool as_branch, OctreeNode* _parent) {
-				Reconfigure(as_branch, _parent);
+			const size_t num_workers = pool != nullptr ? pool->NumWorkers() : 1;
+			if (batch_scratch.size() < num_workers) {
+				batch_scratch.resize(num_workers);
 			}
 
-			~OctreeNode() {
-				if (is_branch) {
-					for (size_t i = 0; i < branch_children.size(); i++) {
-						if (branch_children[i] != nullptr) {
-							delete branch_children[i];
-						}
-					}
+			auto run_job = [&](size_t job, size_t worker_index) {
+				BatchScratch& scratch = batch_scratch[worker_index];
+				const size_t end = std::min(count, (job + 1) * BatchJobSize);
+				for (size_t i = job * BatchJobSize; i < end; i++) {
+					const uint32_t index = batch_order[i].index;
+					scratch.found.clear();
+					FindItems(glm::vec3(centers[index]), radius, scratch.found, scratch.stack);
+					callback((size_t)index, (const std::vector<T*>&)scratch.found);
+				}
+			};
+
+			const size_t jobs = (count + BatchJobSize - 1) / BatchJobSize;
+			if (pool != nullptr) {
+				pool->RunBatch(jobs, run_job);
+			} else {
+				for (size_t job = 0; job < jobs; job++) {
+					run_job(job, 0);
 				}
 			}
+		}
+
+		void PrintTree() {
+			PrintTree(Root, tree_center, tree_bounds, 0);
+		}
+
+	private:
+		/// <summary>
+		/// Index of a node which doesn't exist, for empty octants and the root's parent.
+		/// </summary>
+		static constexpr uint32_t NoNode = UINT32_MAX;
+		static constexpr uint32_t Root = 0;
+
+		struct OctreeNode {
+			uint32_t parent;
+			uint32_t count;
+			bool is_branch;
 
-			void Reconfigure(bool as_branch, OctreeNode* new_parent) {
+			void Reconfigure(bool as_branch, uint32_t new_parent) {
 				count = 0;
 				is_branch = as_branch;
 				parent = new_parent;
-				branch_children = { 0 };
-				items = { 0 };
+				if (as_branch) {
+					children.fill(NoNode);
+				} else {
+					items.fill(nullptr);
+				}
 			}
 
 			union {
-				std::array<OctreeNode*, 8> branch_children;
+				std::array<uint32_t, 8> children;
 				std::array<T*, N> items;
 			};
 		};
 
+		/// <summary>
+		/// A node waiting to be visited by FindItems().
+		/// </summary>
+		struct SearchNode {
+			uint32_t node;
+			/// <summary>
+			/// The node's box is already known to be inside the search box, so its children are too.
+			/// </summary>
+			bool contained;
+			glm::vec3 center;
+			glm::vec3 bounds;
+		};
+
+		/// <summary>
+		/// Buffers for one worker's FindItemsBatch() queries, on their own cache lines.
+		/// </summary>
+		struct alignas(64) BatchScratch {
+			std::vector<SearchNode> stack;
+			std::vector<T*> found;
+		};
+
+		struct BatchQuery {
+			uint32_t code;
+			uint32_t index;
+		};
+
+		/// <summary>
+		/// Queries per WorkerPool job; enough to keep the cost of grabbing a job small next to the queries themselves.
+		/// </summary>
+		static constexpr size_t BatchJobSize = 64;
+
 		struct FindResult {
-			OctreeNode* branch;
-			OctreeNode* leaf;
+			uint32_t branch;
+			uint32_t leaf;
 			uint8_t leaf_index;
 			glm::vec3 branch_center;
 			glm::vec3 branch_bounds;
@@ -123,151 +282,82 @@ namespace seam {
 			Full
 		};
 
-		void Add(T* item, glm::vec3 position, OctreeNode* branch, glm::vec3 center, glm::vec3 bounds) {
-			const auto res = FindLeaf(position, branch, center, bounds);
-			assert(res.branch->is_branch);
-			OctreeNode* leaf = res.leaf;
-			if (res.leaf == nullptr) {
-				// TODO replace me with grabbing a leaf from a pool
-				res.branch->branch_children[res.leaf_index] = leaf = new OctreeNode(false, res.branch);
-			}
-
-			if (leaf->count >= N) {
-				// Leaf is full and needs to be split into a branch.
-				// TODO pool me
-				auto new_branch = new OctreeNode(true, res.branch);
-				SplitLeaf(new_branch, leaf, res.leaf_center, res.leaf_bounds);
-				// TODO return leaf to pool
-				memset(leaf, 0, sizeof(OctreeNode));
-				delete leaf;
-				res.branch->branch_children[res.leaf_index] = new_branch;
-
-				Add(item, position, new_branch, res.leaf_center, res.leaf_bounds);
-
-				ValidateTree(root);
+		uint32_t NewNode(bool as_branch, uint32_t parent) {
+			uint32_t index;
+			if (!free_nodes.empty()) {
+				index = free_nodes.back();
+				free_nodes.pop_back();
 			} else {
-				leaf->items[leaf->count] = item;
-
-				// Increase the item count for the Leaf and each Branch above it.
-				OctreeNode* updated = leaf;
-				while (updated != nullptr) {
-					updated->count += 1;
-					updated = updated->parent;
-				}
+				index = (uint32_t)nodes.size();
+				nodes.emplace_back();
 			}
+			// Careful: this may have moved every node, so only hold on to indices across calls to NewNode().
+			nodes[index].Reconfigure(as_branch, parent);
+			return index;
 		}
 
-		void Remove(T* item, glm::vec3 position, OctreeNode* branch, glm::vec3 center, glm::vec3 bounds) {
-			const auto res = FindLeaf(position, branch, center, bounds);
-			assert(res.branch->is_branch);
-			OctreeNode* leaf = res.leaf;
-			assert(res.leaf != nullptr && res.leaf->count > 0);
-			
-			uint8_t i = 0;
-			bool found = false;
-			for (; i < res.leaf->count; i++) {
-				T* leaf_item = res.leaf->items[i];
-				if (leaf_item == item) {
-					found = true;
-					break;
-				}
-			}
-
-			assert(found);
-			if (found) {
-				// Move the last item in the list to take the removed position.
-				res.leaf->items[i] = res.leaf->items[res.leaf->count - 1];
-				res.leaf->items[res.leaf->count - 1] = nullptr;
-
-				OctreeNode* updated = res.leaf;
-				while (updated != nullptr) {
-					updated->count -= 1;
-					updated = updated->parent;
-				}
-
-				if (res.branch->count < N/2 && res.branch->parent != nullptr) {
-					CollapseBranch(res.branch, FindChildIndex(res.branch));
-					ValidateTree(root);
-				}
-			}
+		inline void FreeNode(uint32_t index) {
+			assert(index != Root);
+			free_nodes.push_back(index);
 		}
 
 		size_t FindItems(
-			glm::vec3 search_center, 
-			float search_radius,
-			glm::vec3 branch_center, 
-			glm::vec3 branch_bounds,
-			OctreeNode* node, 
-			std::vector<T*>& found) 
-		{
-			IntersectResult intersect = CalculateBoxBoundsIntersection(branch_center, branch_bounds, search_center, glm::vec3(search_radius));
-
-			if (intersect == IntersectResult::Full) {
-				// The search area completely contains this branch.
-				// Find all items down this branch and do the final radius check and add.
-				return AddItems(node, search_center, search_radius, found);
-			} else if (intersect == IntersectResult::Partial) {
-				if (node->is_branch) {
-					size_t added = 0;
-					for (uint8_t i = 0; i < 8; i++) {
-						OctreeNode* child = node->branch_children[i];
-						if (child != nullptr) {
-							glm::vec3 child_center = CalculateCenter(branch_center, branch_bounds, i);
-							added += FindItems(search_center, search_radius, child_center, branch_bounds / 2.f, child, found);
-						}
-					}
-					return added;
-				} else {
-					return AddLeafItems(node, search_center, search_radius, found);
-				}
-			} else {
-				return 0;
-			}
-		}
-
-		size_t AddItems(
-			OctreeNode* node,
 			glm::vec3 search_center,
 			float search_radius,
-			std::vector<T*>& found)
+			std::vector<T*>& found,
+			std::vector<SearchNode>& stack) const
 		{
+			const float search_radius_sq = search_radius * search_radius;
 			size_t added = 0;
-			if (node == nullptr) {
-				return 0;
-			} else if (node->is_branch) {
-				for (uint8_t i = 0; i < 8; i++) {
-					added += AddItems(node->branch_children[i], search_center, search_radius, found);
+
+			stack.clear();
+			stack.push_back(SearchNode { Root, false, tree_center, tree_bounds });
+			while (!stack.empty()) {
+				const SearchNode search = stack.back();
+				stack.pop_back();
+				const OctreeNode& node = nodes[search.node];
+
+				bool contained = search.contained;
+				if (!contained) {
+					IntersectResult intersect = CalculateBoxBoundsIntersection(
+						search.center, search.bounds, search_center, glm::vec3(search_radius));
+					if (intersect == IntersectResult::None) {
+						continue;
+					}
+					// If the search area completely contains this branch,
+					// every item down it only needs the final radius check.
+					contained = intersect == IntersectResult::Full;
 				}
-			} else {
-				return AddLeafItems(node, search_center, search_radius, found);
-			}
-			return added;
-		}
 
-		size_t AddLeafItems(
-			OctreeNode* leaf,
-			glm::vec3 search_center,
-			float search_radius,
-			std::vector<T*>& found)
-		{
-			assert(!leaf->is_branch);
-			size_t added = 0;
-			for (uint8_t j = 0; j < leaf->count; j++) {
-				// Actually grab the item's position and make sure it's within the search sphere.
-				float distance = glm::distance(search_center, GetPosition(leaf->items[j]));
-				if (distance <= search_radius) {
-					found.push_back(leaf->items[j]);
-					added += 1;
+				if (node.is_branch) {
+					// Push in reverse, so children are visited in index order.
+					const glm::vec3 child_bounds = search.bounds / 2.f;
+					for (int i = 7; i >= 0; i--) {
+						const uint32_t child = node.children[i];
+						if (child != NoNode) {
+							stack.push_back(SearchNode {
+								child, contained, CalculateCenter(search.center, search.bounds, (uint8_t)i), child_bounds });
+						}
+					}
+				} else {
+					for (uint32_t j = 0; j < node.count; j++) {
+						// Actually grab the item's position and make sure it's within the search sphere.
+						const glm::vec3 offset = GetPosition(node.items[j]) - search_center;
+						if (glm::dot(offset, offset) <= search_radius_sq) {
+							found.push_back(node.items[j]);
+							added += 1;
+						}
+					}
 				}
 			}
 			return added;
 		}
 
-		IntersectResult CalculateBoxBoundsIntersection(
-			glm::vec3 node_center, 
-			glm::vec3 node_bounds, 
-			glm::vec3 search_center, 
-			glm::vec3 search_bounds) 
+		static IntersectResult CalculateBoxBoundsIntersection(
+			glm::vec3 node_center,
+			glm::vec3 node_bounds,
+			glm::vec3 search_center,
+			glm::vec3 search_bounds)
 		{
 			const glm::vec3 node_min = node_center - node_bounds;
 			const glm::vec3 node_max = node_center + node_bounds;
@@ -300,85 +390,99 @@ namespace seam {
 			return IntersectResult::None;
 		}
 
-		FindResult FindLeaf(glm::vec3 position, OctreeNode* branch, glm::vec3 center, glm::vec3 bounds) {
-			const auto node_index = CalculateNodeIndex(position, center, bounds);
-			const auto child_node = branch->branch_children[node_index];
-
-			const auto new_bounds = bounds / 2.0f;
-			const glm::vec3 new_center = CalculateCenter(center, bounds, node_index);
-
-			// Bail out when we reach an empty node or a leaf.
-			if (child_node == nullptr || !child_node->is_branch) {
-				FindResult res;
-				res.branch = branch;
-				res.leaf = child_node;
-				res.leaf_index = node_index;
-				res.branch_center = center;
-				res.branch_bounds = bounds;
-				res.leaf_center = new_center;
-				res.leaf_bounds = new_bounds;
-				return res;
-			}
+		FindResult FindLeaf(glm::vec3 position, uint32_t branch, glm::vec3 center, glm::vec3 bounds) const {
+			while (true) {
+				const auto node_index = CalculateNodeIndex(position, center, bounds);
+				const uint32_t child_node = nodes[branch].children[node_index];
+
+				const auto new_bounds = bounds / 2.0f;
+				const glm::vec3 new_center = CalculateCenter(center, bounds, node_index);
+
+				// Bail out when we reach an empty node or a leaf.
+				if (child_node == NoNode || !nodes[child_node].is_branch) {
+					FindResult res;
+					res.branch = branch;
+					res.leaf = child_node;
+					res.leaf_index = node_index;
+					res.branch_center = center;
+					res.branch_bounds = bounds;
+					res.leaf_center = new_center;
+					res.leaf_bounds = new_bounds;
+					return res;
+				}
 
-			// Child node is a branch, keep recursing
-			return FindLeaf(position, child_node, new_center, new_bounds);
+				// Child node is a branch, keep descending.
+				branch = child_node;
+				center = new_center;
+				bounds = new_bounds;
+			}
 		}
 
-		void SplitLeaf(OctreeNode* branch, OctreeNode* leaf, glm::vec3 center, glm::vec3 bounds) {
-			for (size_t i = 0; i < leaf->count; i++) {
-				glm::vec3 position = GetPosition(leaf->items[i]);
+		/// <summary>
+		/// Turn a full leaf into a branch in place, moving its items into new leaves below it.
+		/// </summary>
+		void SplitLeaf(uint32_t leaf, glm::vec3 center, glm::vec3 bounds) {
+			const std::array<T*, N> items = nodes[leaf].items;
+			const uint32_t count = nodes[leaf].count;
+			nodes[leaf].Reconfigure(true, nodes[leaf].parent);
+			// The items are still under this node, so the counts above it don't change.
+			nodes[leaf].count = count;
+
+			for (uint32_t i = 0; i < count; i++) {
+				glm::vec3 position = GetPosition(items[i]);
 				std::uint8_t leaf_index = CalculateNodeIndex(position, center, bounds);
-				OctreeNode* new_leaf = branch->branch_children[leaf_index];
-				if (new_leaf == nullptr) {
-					// TODO POOL POOOL
-					branch->branch_children[leaf_index] = new_leaf = new OctreeNode(false, branch);
+				uint32_t new_leaf = nodes[leaf].children[leaf_index];
+				if (new_leaf == NoNode) {
+					new_leaf = NewNode(false, leaf);
+					nodes[leaf].children[leaf_index] = new_leaf;
 				}
-				new_leaf->items[new_leaf->count] = leaf->items[i];
-				new_leaf->count += 1;
-				branch->count += 1;
+				OctreeNode& new_leaf_node = nodes[new_leaf];
+				new_leaf_node.items[new_leaf_node.count] = items[i];
+				new_leaf_node.count += 1;
 			}
 		}
 
-		void CollapseBranch(OctreeNode* branch, uint8_t branch_index) {
-			assert(branch->count <= N);
-			OctreeNode* collapsed_leaf = new OctreeNode(false, branch->parent);
-			for (uint8_t i = 0; i < 8; i++) {
-				OctreeNode* node = branch->branch_children[i];
-				if (node == nullptr) {
-					continue;
-				} else if (node->is_branch) {
-					printf("collapsing inner branch\n");
-					CollapseBranch(node, i);
-				} 
-
-				// IMPORTANT: this should always run after collapsing a branch!
-				OctreeNode* leaf = branch->branch_children[i];
-				assert(!leaf->is_branch);
-				// TODO a lil memcpy would be faster...
-				for (size_t j = 0; j < leaf->count; j++) {
-					assert(collapsed_leaf->count < N);
-					collapsed_leaf->items[collapsed_leaf->count] = leaf->items[j];
-					collapsed_leaf->count += 1;
+		/// <summary>
+		/// Turn a branch into a leaf in place, holding every item from below it, and return the nodes below it to the pool.
+		/// </summary>
+		void CollapseBranch(uint32_t branch) {
+			assert(nodes[branch].count <= N);
+			std::array<T*, N> items;
+			uint32_t count = 0;
+
+			collapse_stack.clear();
+			for (uint32_t child : nodes[branch].children) {
+				if (child != NoNode) {
+					collapse_stack.push_back(child);
 				}
 			}
-			assert(collapsed_leaf->count == branch->count);
-			branch->parent->branch_children[branch_index] = collapsed_leaf;
-
-			memset(branch, 0, sizeof(OctreeNode));
-			delete branch;
-		}
-
-		std::uint8_t FindChildIndex(OctreeNode* branch) {
-			assert(branch->parent != nullptr);
-			for (uint8_t i = 0; i < 8; i++) {
-				if (branch->parent->branch_children[i] == branch) {
-					return i;
+			while (!collapse_stack.empty()) {
+				const uint32_t index = collapse_stack.back();
+				collapse_stack.pop_back();
+				const OctreeNode& node = nodes[index];
+				if (node.is_branch) {
+					for (uint32_t child : node.children) {
+						if (child != NoNode) {
+							collapse_stack.push_back(child);
+						}
+					}
+				} else {
+					for (uint32_t j = 0; j < node.count; j++) {
+						assert(count < N);
+						items[count] = node.items[j];
+						count += 1;
+					}
 				}
+				FreeNode(index);
 			}
-			assert(false);
+
+			assert(count == nodes[branch].count);
+			nodes[branch].Reconfigure(false, nodes[branch].parent);
+			std::copy(items.begin(), items.begin() + count, nodes[branch].items.begin());
+			nodes[branch].count = count;
 		}
 
-		std::uint8_t CalculateNodeIndex(glm::vec3 position, glm::vec3 center, glm::vec3 bounds) {
+		static std::uint8_t CalculateNodeIndex(glm::vec3 position, glm::vec3 center, glm::vec3 bounds) {
 			// Ensure the passed in position is in bounds.
 #if _DEBUG
 			glm::vec3 center_to_pos = glm::abs(position - center);
@@ -392,7 +496,28 @@ namespace seam {
 			return ((right_of_center << 2) | (above_center << 1) | ahead_of_center);
 		}
 
-		inline glm::vec3 CalculateCenter(glm::vec3 parent_center, glm::vec3 parent_bounds, uint8_t child_index) {
+		/// <summary>
+		/// Interleave the bits of a position's octant at 10 levels of depth, so positions near each other in the tree
+		/// get codes near each other.
+		/// </summary>
+		uint32_t MortonCode(glm::vec3 position) const {
+			const glm::vec3 normalized = (position - (tree_center - tree_bounds)) / 2.f;
+			uint32_t code = 0;
+			const float axes[3] = { normalized.x / tree_bounds.x, normalized.y / tree_bounds.y, normalized.z / tree_bounds.z };
+			for (int axis = 0; axis < 3; axis++) {
+				const uint32_t cell = (uint32_t)std::clamp(axes[axis] * 1024.f, 0.f, 1023.f);
+				// Spread the cell's 10 bits out to every third bit.
+				uint32_t spread = cell;
+				spread = (spread | (spread << 16)) & 0x030000FF;
+				spread = (spread | (spread << 8)) & 0x0300F00F;
+				spread = (spread | (spread << 4)) & 0x030C30C3;
+				spread = (spread | (spread << 2)) & 0x09249249;
+				code |= spread << (2 - axis);
+			}
+			return code;
+		}
+
+		static inline glm::vec3 CalculateCenter(glm::vec3 parent_center, glm::vec3 parent_bounds, uint8_t child_index) {
 			// Use the index to figure out which direction we're going in.
 			float right = (bool)(child_index & (1 << 2));
 			float up = (bool)(child_index & (1 << 1));
@@ -405,49 +530,69 @@ namespace seam {
 			);
 		}
 
-		void PrintTree(OctreeNode* node, glm::vec3 center, glm::vec3 bounds, uint8_t depth) {
+		void PrintTree(uint32_t index, glm::vec3 center, glm::vec3 bounds, uint8_t depth) {
 			const std::string spaces = std::string(depth * 2, ' ');
-			if (node == nullptr) {
-				printf("%snullptr\n", spaces.c_str());
+			if (index == NoNode) {
+				printf("%sempty\n", spaces.c_str());
 				return;
 			}
 
-			if (node->is_branch) {
+			const OctreeNode& node = nodes[index];
+			if (node.is_branch) {
 				printf("%sBranch center (%f, %f, %f), bounds (%f, %f, %f) %u items:\n",
-					spaces.c_str(), center.x, center.y, center.z, bounds.x, bounds.y, bounds.z, node->count);
+					spaces.c_str(), center.x, center.y, center.z, bounds.x, bounds.y, bounds.z, node.count);
 
 				for (uint8_t i = 0; i < 8; i++) {
 					const auto new_bounds = bounds / 2.0f;
 					const auto new_center = CalculateCenter(center, bounds, i);
-					PrintTree(node->branch_children[i], new_center, new_bounds, depth + 1);
+					PrintTree(node.children[i], new_center, new_bounds, depth + 1);
 				}
 
 			} else {
 				printf("%sLeaf center (%f, %f, %f), bounds (%f, %f, %f) %u items:\n",
-					spaces.c_str(), center.x, center.y, center.z, bounds.x, bounds.y, bounds.z, node->count);
-				
-				for (uint8_t i = 0; i < node->count; i++) {
-					glm::vec3 position = GetPosition(node->items[i]);
+					spaces.c_str(), center.x, center.y, center.z, bounds.x, bounds.y, bounds.z, node.count);
+
+				for (uint32_t i = 0; i < node.count; i++) {
+					glm::vec3 position = GetPosition(node.items[i]);
 					printf("%s (%f, %f, %f)\n", spaces.c_str(), position.x, position.y, position.z);
 				}
 			}
 		}
 
-		void ValidateTree(OctreeNode* node) {
+		void ValidateTree(uint32_t index) {
 #if _DEBUG
-			if (node->is_branch) {
+			const OctreeNode& node = nodes[index];
+			if (node.is_branch) {
 				for (uint8_t i = 0; i < 8; i++) {
-					OctreeNode* child = node->branch_children[i];
-					if (child != nullptr) {
-						assert(child->parent == node);
+					const uint32_t child = node.children[i];
+					if (child != NoNode) {
+						assert(nodes[child].parent == index);
 						ValidateTree(child);
 					}
 				}
-			} 
+			}
 #endif
 		}
 
-		OctreeNode* root;
+		/// <summary>
+		/// Every node, in use or not; the root is always the first.
+		/// </summary>
+		std::vector<OctreeNode> nodes;
+		/// <summary>
+		/// Indices of nodes which are back in the pool, to be reused before adding to nodes.
+		/// </summary>
+		std::vector<uint32_t> free_nodes;
+		/// <summary>
+		/// Kept between traversals so they don't allocate.
+		/// </summary>
+		std::vector<SearchNode> search_stack;
+		std::vector<uint32_t> collapse_stack;
+		std::vector<BatchQuery> batch_order;
+		/// <summary>
+		/// One per FindItemsBatch() worker.
+		/// </summary>
+		std::vector<BatchScratch> batch_scratch;
+
 		glm::vec3 tree_center;
 		glm::vec3 tree_bounds;
 		PositionGetter GetPosition;
@@ -471,7 +616,15 @@ namespace {
 		glm::vec3 direction;
 	};
 
-	void TestFindItems(seam::Octree<Particle, 8>& octree, glm::vec3 search_center, float search_radius, Particle* particles, size_t particle_count) {
+	struct GetParticlePosition {
+		inline glm::vec3 operator()(Particle* p) const {
+			return p->position;
+		}
+	};
+
+	using ParticleOctree = seam::Octree<Particle, 8, GetParticlePosition>;
+
+	void TestFindItems(ParticleOctree& octree, glm::vec3 search_center, float search_radius, Particle* particles, size_t particle_count) {
 		std::vector<Particle*> search_result;
 		search_result.resize(particle_count / 10);
 		
@@ -497,9 +650,8 @@ namespace {
 }
 
 TEST_CASE("Testing Octree") {
-	std::function<glm::vec3(Particle*)> get = [](Particle* p) -> glm::vec3 { return p->position; };
 	const float bounds = 50.f;
-	seam::Octree<Particle, 8> octree = seam::Octree<Particle, 8>(glm::vec3(0.f), glm::vec3(bounds), get);
+	ParticleOctree octree(glm::vec3(0.f), glm::vec3(bounds));
 	const int particle_count = 100000;
 	Particle* particles = new Particle[particle_count];
 
@@ -534,4 +686,81 @@ TEST_CASE("Testing Octree") {
 
 	delete[] particles;
 }
+
+TEST_CASE("Test Octree recycles its nodes as items move") {
+	const float bounds = 50.f;
+	ParticleOctree octree(glm::vec3(0.f), glm::vec3(bounds));
+	const int particle_count = 2000;
+	std::vector<Particle> particles(particle_count);
+
+	auto random_position = [bounds]() {
+		glm::vec3 pos = glm::vec3((float)rand(), (float)rand(), (float)rand()) / (float)RAND_MAX - 0.5f;
+		return pos * (bounds - 0.01f) * 2.f;
+	};
+
+	for (int i = 0; i < particle_count; i++) {
+		particles[i] = Particle(random_position());
+		octree.Add(&particles[i], particles[i].position);
+	}
+
+	// Scatter everything a few times; once the pool's grown to fit, moving items around reuses its nodes.
+	size_t pool_size = 0;
+	std::vector<Particle*> found;
+	for (int round = 0; round < 8; round++) {
+		for (int i = 0; i < particle_count; i++) {
+			glm::vec3 new_pos = random_position();
+			octree.Update(&particles[i], particles[i].position, new_pos);
+			particles[i].position = new_pos;
+		}
+		CHECK(octree.Count() == particle_count);
+
+		if (round == 3) {
+			pool_size = octree.PoolSize();
+		}
+
+		const glm::vec3 center = random_position();
+		octree.FindItems(center, 15.f, found);
+		size_t expected = 0;
+		for (int i = 0; i < particle_count; i++) {
+			expected += glm::distance(particles[i].position, center) <= 15.f;
+		}
+		CHECK(found.size() == expected);
+	}
+	CHECK(octree.PoolSize() <= pool_size * 5 / 4);
+
+	for (int i = 0; i < particle_count; i++) {
+		octree.Remove(&particles[i], particles[i].position);
+	}
+	CHECK(octree.Count() == 0);
+}
+
+TEST_CASE("Test Octree batched searches match single searches") {
+	const float bounds = 50.f;
+	ParticleOctree octree(glm::vec3(0.f), glm::vec3(bounds));
+	const int particle_count = 5000;
+	std::vector<Particle> particles(particle_count);
+	std::vector<glm::vec3> centers(particle_count);
+	for (int i = 0; i < particle_count; i++) {
+		glm::vec3 pos = glm::vec3((float)rand(), (float)rand(), (float)rand()) / (float)RAND_MAX - 0.5f;
+		particles[i] = Particle(pos * (bounds - 0.01f) * 2.f);
+		centers[i] = particles[i].position;
+		octree.Add(&particles[i], particles[i].position);
+	}
+
+	std::vector<size_t> expected(particle_count);
+	std::vector<Particle*> found;
+	for (int i = 0; i < particle_count; i++) {
+		expected[i] = octree.FindItems(centers[i], 6.f, found);
+	}
+
+	seam::WorkerPool pool(3);
+	for (seam::WorkerPool* batch_pool : { (seam::WorkerPool*)nullptr, &pool }) {
+		// Each index is only ever written by the worker its query ran on.
+		std::vector<size_t> batched(particle_count, SIZE_MAX);
+		octree.FindItemsBatch(centers.data(), centers.size(), 6.f, [&](size_t i, const std::vector<Particle*>& found) {
+			batched[i] = found.size();
+		}, batch_pool);
+		CHECK(batched == expected);
+	}
+}
 #endif // RUN_DOCTEST
\ No newline at end of file
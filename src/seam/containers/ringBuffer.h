@@ -1,48 +1,201 @@
 #pragma once
 
-/// Circular buffer which acts as a queue with read and write indices.
-/// A separate reader (pop) thread and writer (push) thread can run lock-free,
-/// as long as there is only one thread each for read and write.
-template <typename T>
-class RingBuffer {
-public:
-	RingBuffer(uint32_t _capacity)
-		: capacity(_capacity)
-	{
-		arr = new T[capacity];
-	}
+#if RUN_DOCTEST
+#include "doctest.h"
+#include <thread>
+#endif
 
-	~RingBuffer() {
-		delete[] arr;
-	}
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
 
-	/// push (write) to the tail
-	inline void Push(const T val) {
-		arr[tail] = val;
-		tail = (tail + 1) % capacity;
-		size += 1;
-		assert(size <= capacity);
-	}
+namespace seam {
 
-	/// pop (read) the front
-	inline bool Pop(T& ret) {
-		if (size) {
-			ret = arr[head];
-			head = (head + 1) % capacity;
-			size -= 1;
-			return true;
+	/// @brief Fixed capacity circular queue for exactly one writer (push) thread and one reader (pop) thread,
+	/// neither of which ever waits on the other.
+	/// Pushes which don't fit are dropped and counted, rather than overwriting unread elements;
+	/// for several producer threads, or a queue which grows rather than dropping, see EventQueue.
+	template <typename T>
+	class RingBuffer {
+	public:
+		/// @param _capacity Rounded up to a power of two.
+		RingBuffer(uint32_t _capacity) {
+			assert(_capacity > 0 && _capacity <= (1u << 31));
+			uint32_t capacity = 1;
+			while (capacity < _capacity) {
+				capacity <<= 1;
+			}
+			mask = capacity - 1;
+			arr = std::make_unique<T[]>(capacity);
+		}
+
+		RingBuffer(const RingBuffer&) = delete;
+		RingBuffer& operator=(const RingBuffer&) = delete;
+
+		/// @brief Writer only. Push (write) to the tail.
+		/// @return false if the buffer is full, in which case val is dropped.
+		inline bool TryPush(const T& val) {
+			return PushBulk(&val, 1) == 1;
+		}
+
+		/// @brief Writer only. Push as many of vals as fit, in order; the rest are dropped.
+		/// @return The number of elements pushed.
+		uint32_t PushBulk(const T* vals, uint32_t count) {
+			const uint32_t t = writer.tail.load(std::memory_order_relaxed);
+			if (Capacity() - (t - writer.headCache) < count) {
+				// Only look at the reader's index when the cached one says we're out of space.
+				writer.headCache = reader.head.load(std::memory_order_acquire);
+			}
+			const uint32_t pushed = std::min(count, Capacity() - (t - writer.headCache));
+			if (pushed < count) {
+				writer.overflows.fetch_add(1, std::memory_order_relaxed);
+				writer.dropped.fetch_add(count - pushed, std::memory_order_relaxed);
+			}
+
+			// Copy up to the end of the array, then wrap around to the front.
+			const uint32_t start = t & mask;
+			const uint32_t first = std::min(pushed, Capacity() - start);
+			std::copy(vals, vals + first, arr.get() + start);
+			std::copy(vals + first, vals + pushed, arr.get());
+
+			writer.tail.store(t + pushed, std::memory_order_release);
+			return pushed;
+		}
+
+		/// @brief Reader only. Pop (read) the front.
+		/// @return false if the buffer is empty.
+		inline bool Pop(T& ret) {
+			return PopBulk(&ret, 1) == 1;
+		}
+
+		/// @brief Reader only. Pop up to maxCount elements into out, in the order they were pushed.
+		/// @return The number of elements popped.
+		uint32_t PopBulk(T* out, uint32_t maxCount) {
+			const uint32_t h = reader.head.load(std::memory_order_relaxed);
+			if (reader.tailCache - h < maxCount) {
+				reader.tailCache = writer.tail.load(std::memory_order_acquire);
+			}
+			const uint32_t popped = std::min(maxCount, reader.tailCache - h);
+
+			const uint32_t start = h & mask;
+			const uint32_t first = std::min(popped, Capacity() - start);
+			std::copy(arr.get() + start, arr.get() + start + first, out);
+			std::copy(arr.get(), arr.get() + (popped - first), out + first);
+
+			reader.head.store(h + popped, std::memory_order_release);
+			return popped;
+		}
+
+		/// @brief Exact from the reader thread; from anywhere else it may already be out of date.
+		inline uint32_t NumAvailable() const {
+			return writer.tail.load(std::memory_order_acquire) - reader.head.load(std::memory_order_acquire);
 		}
-		return false;
-	}
 
-	inline uint32_t NumAvailable() {
-		return size;
+		inline uint32_t Capacity() const {
+			return mask + 1;
+		}
+
+		/// @brief Number of pushes which didn't fit, whole or in part.
+		inline uint64_t Overflows() const {
+			return writer.overflows.load(std::memory_order_relaxed);
+		}
+
+		/// @brief Number of elements dropped because the buffer was full.
+		inline uint64_t Dropped() const {
+			return writer.dropped.load(std::memory_order_relaxed);
+		}
+
+	private:
+		// The writer's and reader's state are on separate cache lines,
+		// so each thread only invalidates the other's line when it actually publishes an index.
+		// Indices count up forever and wrap around at 2^32; only (tail - head) and (index & mask) are used.
+
+		struct alignas(64) WriterState {
+			std::atomic<uint32_t> tail = 0;
+			/// @brief The reader's head the last time the writer looked.
+			uint32_t headCache = 0;
+			std::atomic<uint64_t> overflows = 0;
+			std::atomic<uint64_t> dropped = 0;
+		};
+
+		struct alignas(64) ReaderState {
+			std::atomic<uint32_t> head = 0;
+			/// @brief The writer's tail the last time the reader looked.
+			uint32_t tailCache = 0;
+		};
+
+		WriterState writer;
+		ReaderState reader;
+		uint32_t mask = 0;
+		std::unique_ptr<T[]> arr;
+	};
+}
+
+#if RUN_DOCTEST
+TEST_CASE("Test RingBuffer drops and counts what doesn't fit") {
+	seam::RingBuffer<int> ring(3);
+	CHECK(ring.Capacity() == 4);
+
+	int vals[6] = { 0, 1, 2, 3, 4, 5 };
+	CHECK(ring.PushBulk(vals, 6) == 4);
+	CHECK(!ring.TryPush(6));
+	CHECK(ring.Overflows() == 2);
+	CHECK(ring.Dropped() == 3);
+	CHECK(ring.NumAvailable() == 4);
+
+	// Wrap around the end of the array.
+	int out[6] = { };
+	CHECK(ring.PopBulk(out, 3) == 3);
+	CHECK(ring.PushBulk(vals + 4, 2) == 2);
+	CHECK(ring.PopBulk(out, 6) == 3);
+	CHECK(out[0] == 3);
+	CHECK(out[1] == 4);
+	CHECK(out[2] == 5);
+	int last;
+	CHECK(!ring.Pop(last));
+}
+
+TEST_CASE("Test RingBuffer keeps order across a writer and a reader thread") {
+	// A small buffer and bursty pushes, so both threads keep running into the ends.
+	seam::RingBuffer<uint32_t> ring(16);
+	const uint32_t count = 200000;
+
+	std::thread writer([&]() {
+		uint32_t next = 0;
+		uint32_t burst[7];
+		while (next < count) {
+			const uint32_t n = std::min(count - next, (uint32_t)(next % 7) + 1);
+			for (uint32_t i = 0; i < n; i++) {
+				burst[i] = next + i;
+			}
+			// Retry whatever got dropped, so every value makes it through.
+			const uint32_t pushed = ring.PushBulk(burst, n);
+			if (pushed == 0) {
+				std::this_thread::yield();
+			}
+			next += pushed;
+		}
+	});
+
+	uint32_t expected = 0;
+	bool ordered = true;
+	uint32_t out[5];
+	while (expected < count) {
+		const uint32_t popped = ring.PopBulk(out, 5);
+		if (popped == 0) {
+			std::this_thread::yield();
+		}
+		for (uint32_t i = 0; i < popped; i++) {
+			ordered = ordered && out[i] == expected;
+			expected++;
+		}
 	}
+	writer.join();
 
-private:
-	T* arr;
-	uint32_t head = 0;
-	uint32_t tail = 0;
-	uint32_t size = 0;
-	const uint32_t capacity = 0;
-};
\ No newline at end of file
+	CHECK(ordered);
+	CHECK(expected == count);
+	CHECK(ring.NumAvailable() == 0);
+}
+#endif // RUN_DOCTEST
@@ -201,6 +201,8 @@ void Editor::DrawSelectedNode() {
 }
 
 void Editor::GuiDraw() {
+	// The GUI reads and edits Nodes directly, so they can't still be updating for the next frame.
+	graph.FinishPipelinedUpdate();
 
 	im::Begin("Seam Editor", nullptr, ImGuiWindowFlags_MenuBar | ImGuiWindowFlags_NoCollapse);
 
@@ -246,6 +248,16 @@ void Editor::GuiDraw() {
 				showWindowResize = true;
 				windowSize = glm::ivec2(ofGetWidth(), ofGetHeight());
 			}
+			if (ImGui::MenuItem("Print Pin Memory")) {
+				pins::PinMemoryStats stats = graph.GetPinMemoryStats();
+				printf("%zu input pins, %zu output pins: %zu bytes of pins, %zu bytes of pin metadata on the heap, "
+					"%zu bytes of pin values, %zu bytes of interned strings; "
+					"%zu pins have callbacks, whose captures aren't counted; "
+					"%llu events dropped by full input queues\n",
+					stats.inputPins, stats.outputPins, stats.pinBytes, stats.metadataHeapBytes,
+					stats.bufferBytes, InternedString::PoolBytes(), stats.callbackPins,
+					(unsigned long long)stats.droppedEvents);
+			}
 			ImGui::EndMenu();
 		}
 		ImGui::EndMenuBar();
@@ -281,6 +293,8 @@ void Editor::GuiDraw() {
 		selectedNode = selectedNodes.back().AsPointer<INode>();
 		if (selectedNode->IsVisual()) {
 			lastSelectedVisualNode = selectedNode;
+			// Keep the previewed node (and its parents) updating, even if it's not the visual output.
+			graph.SetPreviewNode(lastSelectedVisualNode);
 		}
 	} else {
 		selectedNode = nullptr;
@@ -30,31 +30,31 @@ using namespace seam;
 
 EventNodeFactory::EventNodeFactory() {
 	// register seam-internal nodes here
-	Register(MakeCreate<nodes::AddStore>());
+	Register<nodes::AddStore>();
 	#if BUILD_AUDIO_ANALYSIS
-	Register(MakeCreate<nodes::AudioAnalyzer>());
+	Register<nodes::AudioAnalyzer>();
 	#endif
-	// Register(MakeCreate<nodes::ComputeParticles>());
-	Register(MakeCreate<nodes::Cos>());
-	Register(MakeCreate<nodes::FastNoise>());
-	Register(MakeCreate<nodes::Feedback>());
-	Register(MakeCreate<nodes::Gate>());
-	Register(MakeCreate<nodes::HdrTonemapper>());
-	Register(MakeCreate<nodes::Markov>());
-	// Register(MakeCreate<nodes::MidiIn>());
-	Register(MakeCreate<nodes::MultiTrigger>());
-	Register(MakeCreate<nodes::Noise>());
-	Register(MakeCreate<nodes::NotesPrinter>());
-	Register(MakeCreate<nodes::PercussiveTrigger>());
-	Register(MakeCreate<nodes::Range>());
-	Register(MakeCreate<nodes::Saw>());
-	Register(MakeCreate<nodes::Shader>());
-	Register(MakeCreate<nodes::Step>());
-	Register(MakeCreate<nodes::Threshold>());
-	Register(MakeCreate<nodes::Timer>());
-	Register(MakeCreate<nodes::Toggle>());
-	Register(MakeCreate<nodes::ValueNoise>());
-	Register(MakeCreate<nodes::VideoPlayer>());
+	Register<nodes::ComputeParticles>();
+	Register<nodes::Cos>();
+	Register<nodes::FastNoise>();
+	Register<nodes::Feedback>();
+	Register<nodes::Gate>();
+	Register<nodes::HdrTonemapper>();
+	Register<nodes::Markov>();
+	Register<nodes::MidiIn>();
+	Register<nodes::MultiTrigger>();
+	Register<nodes::Noise>();
+	Register<nodes::NotesPrinter>();
+	Register<nodes::PercussiveTrigger>();
+	Register<nodes::Range>();
+	Register<nodes::Saw>();
+	Register<nodes::Shader>();
+	Register<nodes::Step>();
+	Register<nodes::Threshold>();
+	Register<nodes::Timer>();
+	Register<nodes::Toggle>();
+	Register<nodes::ValueNoise>();
+	Register<nodes::VideoPlayer>();
 
 	// TODO register more seam internal generators here
 
@@ -76,6 +76,8 @@ nodes::INode* EventNodeFactory::Create(seam::nodes::NodeId node_id) {
 	if (it != generators.end() && it->node_id == node_id) {
 		nodes::INode* node = it->Create();
 		assert(node);
+		// Nodes with static metadata must construct with the same name they registered with.
+		assert(node->NodeName() == it->node_name);
 
 		// make sure each input pin has this node set as its parent
 		size_t size;
@@ -93,31 +95,19 @@ nodes::INode* EventNodeFactory::Create(seam::nodes::NodeId node_id) {
 
 bool EventNodeFactory::Register(EventNodeFactory::CreateFunc&& Create) {
 	Generator gen;
-	// TODO it'd be nice to stack alloc dummy nodes instead but probably doesn't matter that much;
-	// this should only run once per node type
+	// Node types without static metadata need to be constructed to read their metadata.
+	// This runs their constructors, so prefer declaring a static NodeMetadata and using Register<T>().
 	std::unique_ptr<nodes::INode> n(Create());
 	gen.node_name = n->NodeName();
 	gen.node_id = SCHash(gen.node_name.data(), gen.node_name.length());
 
-	// make sure it's not already registered before continuing
-	if (std::find(generators.begin(), generators.end(), gen.node_id) != generators.end()) {
-		// node id already registered, probably a bug
-		printf("node with name %s and id %llu already registered\n", 
-			gen.node_name.data(), gen.node_id);
-		return false;
-	}
-	
 	size_t size;
 
 	// read inputs
 	{
 		PinInput* inputs = n->PinInputs(size);
 		for (size_t i = 0; i < size; i++) {
-			PinType type = inputs[i].type;
-			// filter only for types that aren't already in the list
-			if (std::find(gen.pin_inputs.begin(), gen.pin_inputs.end(), type) == gen.pin_inputs.end()) {
-				gen.pin_inputs.push_back(type);
-			}
+			gen.pin_inputs.Add(inputs[i].type);
 		}
 	}
 
@@ -125,14 +115,33 @@ bool EventNodeFactory::Register(EventNodeFactory::CreateFunc&& Create) {
 	{
 		PinOutput* outputs = n->PinOutputs(size);
 		for (size_t i = 0; i < size; i++) {
-			PinType type = outputs[i].type;
-			if (std::find(gen.pin_outputs.begin(), gen.pin_outputs.end(), type) == gen.pin_outputs.end()) {
-				gen.pin_outputs.push_back(type);
-			}
+			gen.pin_outputs.Add(outputs[i].type);
 		}
 	}
 
 	gen.Create = std::move(Create);
+	return AddGenerator(std::move(gen));
+}
+
+bool EventNodeFactory::Register(const nodes::NodeMetadata& metadata, EventNodeFactory::CreateFunc&& Create) {
+	Generator gen;
+	gen.node_name = metadata.name;
+	gen.node_id = metadata.id;
+	gen.pin_inputs = metadata.pinInputs;
+	gen.pin_outputs = metadata.pinOutputs;
+	gen.Create = std::move(Create);
+	return AddGenerator(std::move(gen));
+}
+
+bool EventNodeFactory::AddGenerator(Generator&& gen) {
+	// make sure it's not already registered before continuing
+	if (std::find(generators.begin(), generators.end(), gen.node_id) != generators.end()) {
+		// node id already registered, probably a bug
+		printf("node with name %s and id %llu already registered\n", 
+			gen.node_name.data(), gen.node_id);
+		return false;
+	}
+
 	generators.push_back(std::move(gen));
 	generators_sorted = false;
 	return true;
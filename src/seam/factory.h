@@ -2,6 +2,8 @@
 
 #include "seam/include.h"
 
+#include <type_traits>
+
 namespace seam {
 	class EventNodeFactory {
 	public:
@@ -16,10 +18,10 @@ namespace seam {
 			std::string_view node_name;
 
 			/// list of unique input types
-			std::vector<pins::PinType> pin_inputs;
+			nodes::PinTypeSet pin_inputs;
 
 			/// list of unique output types
-			std::vector<pins::PinType> pin_outputs;
+			nodes::PinTypeSet pin_outputs;
 
 			/// can create a unique instance of the node described by this struct
 			CreateFunc Create;
@@ -44,6 +46,27 @@ namespace seam {
 			};
 		}
 
+		/// @brief Detects Node types which declare a static constexpr NodeMetadata named metadata.
+		template <typename T, typename = void>
+		struct HasMetadata : std::false_type { };
+
+		template <typename T>
+		struct HasMetadata<T, std::void_t<decltype(T::metadata)>> 
+			: std::is_same<std::decay_t<decltype(T::metadata)>, nodes::NodeMetadata> { };
+
+		/// @brief Register a Node type.
+		/// Node types with static metadata are registered without being constructed;
+		/// other Node types fall back to constructing a throwaway instance to read their metadata.
+		/// \return false if the node id is already registered, otherwise true
+		template <typename T>
+		bool Register() {
+			if constexpr (HasMetadata<T>::value) {
+				return Register(T::metadata, MakeCreate<T>());
+			} else {
+				return Register(MakeCreate<T>());
+			}
+		}
+
 		EventNodeFactory();
 
 		~EventNodeFactory();
@@ -59,7 +82,14 @@ namespace seam {
 		/// creates a node and puts its metadata into a generator
 		/// \return false if the node id is already registered, otherwise true
 		bool Register(CreateFunc&& Create);
+
+		/// registers a node type from its static metadata, without creating a node
+		/// \return false if the node id is already registered, otherwise true
+		bool Register(const nodes::NodeMetadata& metadata, CreateFunc&& Create);
+
 	private:
+		bool AddGenerator(Generator&& gen);
+
 
 		bool generators_sorted = false;
 		std::vector<Generator> generators;
@@ -1,39 +1,292 @@
 #pragma once
 
+#if RUN_DOCTEST
+#include "doctest.h"
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace seam {
+	/// @brief Usage of a FramePool, for sizing its chunks.
+	struct FramePoolStats {
+		/// @brief Bytes allocated since the last Clear(), including alignment padding.
+		size_t usedBytes = 0;
+		/// @brief The most bytes used by any frame so far.
+		size_t highWaterBytes = 0;
+		/// @brief Bytes of every chunk the pool holds.
+		size_t capacityBytes = 0;
+		size_t chunks = 0;
+		/// @brief Chunks allocated after the first one; should stop going up once frames are steady.
+		size_t chunkAllocations = 0;
+	};
+
 	/// a very simple allocation pool, which can be "cleared" and reset
 	/// good for per-frame variable-size data, like notes data
+	/// Allocations are bumped out of chunks, which are kept across Clear() calls;
+	/// once the pool has grown to fit a frame, steady frames never touch the system allocator.
+	/// Allocations never move, so pointers pushed to event queues stay valid until the next Clear().
 	class FramePool {
 	public:
-		FramePool(size_t size_in_bytes) {
-			pool.resize(size_in_bytes);
-			pos = 0;
+		/// @param _chunkSize Bytes per chunk. Allocations bigger than this get a chunk of their own.
+		FramePool(size_t _chunkSize) : chunkSize(std::max(_chunkSize, (size_t)64)) {
+			NewChunk(chunkSize);
+			stats.chunkAllocations = 0;
 		}
 
+		~FramePool() {
+			RunDestructors();
+		}
+
+		FramePool(const FramePool&) = delete;
+		FramePool& operator=(const FramePool&) = delete;
+
+		/// @brief Destroy everything allocated since the last Clear(), and reuse the pool's memory.
 		void Clear() {
+			RunDestructors();
+			stats.highWaterBytes = std::max(stats.highWaterBytes, stats.usedBytes);
+			stats.usedBytes = 0;
+			chunk = 0;
 			pos = 0;
 		}
 
+		/// @brief Construct a T in the pool. Non-trivial destructors are run by the next Clear().
+		template <typename T, typename... Args>
+		T* Alloc(Args&&... args) {
+			T* ptr = new (AllocBytes(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+			if constexpr (!std::is_trivially_destructible_v<T>) {
+				destructors.push_back(Destructor { &DestroyArray<T>, ptr, 1 });
+			}
+			return ptr;
+		}
+
+		/// @brief Construct count value-initialized T's, contiguously, in the pool.
 		template <typename T>
-		T* Alloc() {
-			// resize if the pool is too small
-			if (pos + sizeof(T) > pool.size()) {
-				printf("pool is out of space, doubling buffer size to %zu bytes", pool.size() * 2);
-				pool.resize(pool.size() * 2);
-			}
-			// calculate the pointer position of the "allocation"
-			T* ptr = (T*)(pool.data() + pos);
-			// run the default constructor for the given type 
-			*ptr = T();
-			// increment position for next "alloc"
-			pos += sizeof(T);
+		T* AllocArray(size_t count) {
+			T* ptr = (T*)AllocBytes(sizeof(T) * count, alignof(T));
+			for (size_t i = 0; i < count; i++) {
+				new (ptr + i) T();
+			}
+			if constexpr (!std::is_trivially_destructible_v<T>) {
+				destructors.push_back(Destructor { &DestroyArray<T>, ptr, count });
+			}
+			return ptr;
+		}
+
+		/// @brief Raw, uninitialized memory.
+		/// @param alignment Must be a power of two.
+		void* AllocBytes(size_t size, size_t alignment) {
+			assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+			void* ptr = Bump(chunks[chunk], size, alignment);
+			while (ptr == nullptr) {
+				// Move on to the next chunk which fits, adding one if none do.
+				chunk++;
+				pos = 0;
+				if (chunk == chunks.size()) {
+					NewChunk(std::max(chunkSize, size + alignment));
+					printf("frame pool is out of space, added a chunk (%zu bytes in %zu chunks)\n",
+						stats.capacityBytes, stats.chunks);
+				}
+				ptr = Bump(chunks[chunk], size, alignment);
+			}
 			return ptr;
 		}
 
+		/// @brief Register a function to run on ptr at the next Clear(), after later registered ones.
+		/// Alloc() and AllocArray() already do this for non-trivially destructible types.
+		void OnClear(void (*destroy)(void*, size_t), void* ptr, size_t count = 1) {
+			destructors.push_back(Destructor { destroy, ptr, count });
+		}
+
+		inline FramePoolStats Stats() const {
+			FramePoolStats current = stats;
+			current.highWaterBytes = std::max(current.highWaterBytes, current.usedBytes);
+			return current;
+		}
+
 	private:
-		std::vector<char> pool;
-		size_t pos;
+		struct Chunk {
+			std::unique_ptr<char[]> data;
+			size_t size;
+		};
+
+		struct Destructor {
+			void (*destroy)(void*, size_t);
+			void* ptr;
+			size_t count;
+		};
+
+		template <typename T>
+		static void DestroyArray(void* ptr, size_t count) {
+			for (size_t i = 0; i < count; i++) {
+				((T*)ptr)[i].~T();
+			}
+		}
+
+		/// @return nullptr if the allocation doesn't fit in what's left of the chunk.
+		inline void* Bump(Chunk& c, size_t size, size_t alignment) {
+			const uintptr_t base = (uintptr_t)c.data.get();
+			const uintptr_t aligned = (base + pos + alignment - 1) & ~(uintptr_t)(alignment - 1);
+			const size_t end = (size_t)(aligned - base) + size;
+			if (end > c.size) {
+				return nullptr;
+			}
+			stats.usedBytes += end - pos;
+			pos = end;
+			return (void*)aligned;
+		}
+
+		void NewChunk(size_t size) {
+			chunks.push_back(Chunk { std::make_unique<char[]>(size), size });
+			stats.capacityBytes += size;
+			stats.chunks += 1;
+			stats.chunkAllocations += 1;
+		}
+
+		void RunDestructors() {
+			// Later allocations may refer to earlier ones, so destroy them first.
+			for (auto it = destructors.rbegin(); it != destructors.rend(); ++it) {
+				it->destroy(it->ptr, it->count);
+			}
+			destructors.clear();
+		}
+
+		const size_t chunkSize;
+		std::vector<Chunk> chunks;
+		/// @brief The chunk being allocated from, and the offset of its first free byte.
+		size_t chunk = 0;
+		size_t pos = 0;
+		std::vector<Destructor> destructors;
+		FramePoolStats stats;
+	};
+
+	/// @brief A ring of FramePools, one per frame epoch, for allocations which are read after the frame they're made in:
+	/// events queued for Nodes which update later, or pushes staged by a pipelined pass.
+	/// A pool is only reused once its epoch has been retired; if the pool next in the ring is still in use,
+	/// a new one is added to the ring instead, so retirement never has to wait.
+	/// Only the owning thread may allocate and call Begin().
+	class FrameArenaRing {
+	public:
+		FrameArenaRing(size_t numArenas = 4, size_t _chunkSize = 8192) : chunkSize(_chunkSize) {
+			assert(numArenas > 0);
+			for (size_t i = 0; i < numArenas; i++) {
+				arenas.push_back(Arena { std::make_unique<FramePool>(chunkSize), 0 });
+			}
+		}
+
+		/// @brief Start allocating for a new epoch.
+		/// @param retired Everything allocated for this epoch and earlier ones is no longer read.
+		/// @return The pool to allocate from until the next Begin().
+		FramePool& Begin(uint32_t epoch, uint32_t retired) {
+			current = (current + 1) % arenas.size();
+			if (arenas[current].epoch > retired) {
+				arenas.insert(arenas.begin() + current, Arena { std::make_unique<FramePool>(chunkSize), 0 });
+			}
+			arenas[current].pool->Clear();
+			arenas[current].epoch = epoch;
+			return *arenas[current].pool;
+		}
+
+		inline FramePool& Current() {
+			return *arenas[current].pool;
+		}
+
+		inline size_t NumArenas() {
+			return arenas.size();
+		}
+
+	private:
+		struct Arena {
+			std::unique_ptr<FramePool> pool;
+			/// @brief The epoch the pool was last begun for; 0 if it's empty.
+			uint32_t epoch;
+		};
+
+		const size_t chunkSize;
+		std::vector<Arena> arenas;
+		size_t current = 0;
+	};
+}
+
+#if RUN_DOCTEST
+TEST_CASE("Test FramePool allocations are aligned and never move") {
+	seam::FramePool pool(64);
+
+	char* c = pool.Alloc<char>('a');
+	double* d = pool.Alloc<double>(2.5);
+	CHECK(*c == 'a');
+	CHECK(*d == 2.5);
+	CHECK((uintptr_t)d % alignof(double) == 0);
+
+	struct alignas(32) Wide {
+		float v[8];
+	};
+	Wide* wide = pool.Alloc<Wide>();
+	CHECK((uintptr_t)wide % 32 == 0);
+
+	// Spill into more chunks, including one bigger than the chunk size.
+	int* ints = pool.AllocArray<int>(100);
+	for (int i = 0; i < 100; i++) {
+		CHECK(ints[i] == 0);
+		ints[i] = i;
+	}
+	CHECK(*c == 'a');
+	CHECK(*d == 2.5);
+	CHECK(ints[99] == 99);
+	CHECK(pool.Stats().chunks > 1);
+
+	// Steady frames reuse the chunks.
+	const size_t allocations = pool.Stats().chunkAllocations;
+	for (int frame = 0; frame < 3; frame++) {
+		pool.Clear();
+		pool.Alloc<char>();
+		pool.Alloc<double>();
+		pool.Alloc<Wide>();
+		pool.AllocArray<int>(100);
+	}
+	CHECK(pool.Stats().chunkAllocations == allocations);
+	CHECK(pool.Stats().highWaterBytes >= 100 * sizeof(int));
+}
+
+TEST_CASE("Test FramePool destroys what it constructed on Clear") {
+	static int destroyed = 0;
+	struct Counted {
+		~Counted() { destroyed++; }
 	};
+
+	seam::FramePool pool(256);
+	pool.Alloc<Counted>();
+	pool.AllocArray<Counted>(3);
+	pool.Alloc<int>();
+	CHECK(destroyed == 0);
+	pool.Clear();
+	CHECK(destroyed == 4);
+	CHECK(pool.Stats().usedBytes == 0);
+}
+
+TEST_CASE("Test FrameArenaRing keeps allocations until their epoch is retired") {
+	seam::FrameArenaRing ring(2, 256);
+
+	int* first = ring.Begin(1, 0).Alloc<int>(1);
+	int* second = ring.Begin(2, 0).Alloc<int>(2);
+	// Epoch 1 isn't retired, so the ring grows rather than reusing its pool.
+	int* third = ring.Begin(3, 0).Alloc<int>(3);
+	CHECK(ring.NumArenas() == 3);
+	CHECK(*first == 1);
+	CHECK(*second == 2);
+	CHECK(*third == 3);
+
+	// Once everything's retired, the ring cycles through its pools without growing.
+	for (uint32_t epoch = 4; epoch < 20; epoch++) {
+		ring.Begin(epoch, epoch - 1).Alloc<int>((int)epoch);
+	}
+	CHECK(ring.NumArenas() == 3);
 }
+#endif // RUN_DOCTEST
@@ -1,13 +1,14 @@
 #pragma once
 
 #include "stdint.h"
+#include <string_view>
 
 namespace seam {
 	// hash function for an array of char
 	// thank you supercollider plugin source and Bob Jenkins for le hash function
 	// a reference page for the hash is here: https://burtleburtle.net/bob/hash/doobs.html
 	// or run a search for "bob jenkins one-at-a-time hash"
-	inline uint32_t SCHash(const char* inKey, const size_t len) {
+	constexpr uint32_t SCHash(const char* inKey, const size_t len) {
 		// the one-at-a-time hash.
 		// a very good hash function. ref: a web page by Bob Jenkins.
 		uint32_t hash = 0;
@@ -23,7 +24,22 @@ namespace seam {
 		return hash;
 	}
 
-	inline uint32_t SCHash(std::string_view key) {
+	constexpr uint32_t SCHash(std::string_view key) {
 		return SCHash(key.data(), key.length());
 	}
+
+	/// @brief SCHash() of the lowercased key, for case insensitive lookups without copying the key.
+	constexpr uint32_t SCHashLower(std::string_view key) {
+		uint32_t hash = 0;
+		for (char c : key) {
+			hash += (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+			hash += (hash << 10);
+			hash ^= (hash >> 6);
+		}
+		hash += (hash << 3);
+		hash ^= (hash >> 11);
+		hash += (hash << 15);
+
+		return hash;
+	}
 }
\ No newline at end of file
@@ -44,7 +44,8 @@ namespace seam::props {
 		ImGui::PushID(input);
 
 		// If this is a vector pin, draw the vector resize GUI.
-		if ((input->flags & PinFlags::Vector) > PinFlags::None) {
+		const bool isVector = (input->flags & PinFlags::Vector) > PinFlags::None;
+		if (isVector) {
 			sizeChanged = DrawVectorResize(input);
 		}
 
@@ -56,7 +57,8 @@ namespace seam::props {
 		void* guiMin = nullptr;
 		void* guiMax = nullptr;
 		const char* format = nullptr;
-		switch (input->type) {
+		// Vector pins' elements are in their child pins, like a struct's members.
+		switch (isVector ? PinType::Struct : input->type) {
 		case PinType::Int: {
 			imguiType = ImGuiDataType_S32;
 			PinIntMeta* meta = (PinIntMeta*)input->PinMetadata();
@@ -2,5 +2,6 @@
 
 #include "seam/nodes/iNode.h"
 #include "seam/pins/pin.h"
+#include "seam/pins/typedPin.h"
 #include "seam/notes.h"
 #include "seam/textureLocationResolver.h"
\ No newline at end of file
@@ -3,8 +3,8 @@
 using namespace seam;
 using namespace seam::nodes;
 
-AddStore::AddStore() : INode("Add Store") {
-
+AddStore::AddStore() : INode(metadata) {
+	flags = (NodeFlags)(flags | NodeFlags::ThreadSafeUpdate);
 }
 
 AddStore::~AddStore() {
@@ -9,6 +9,8 @@ namespace seam::nodes {
 	/// Adds the input value to the output value every frame.
 	class AddStore : public INode {
 	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("Add Store", { PinType::Float }, { PinType::Float });
+
 		AddStore();
 		~AddStore();
 
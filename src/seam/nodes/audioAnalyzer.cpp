@@ -5,7 +5,7 @@
 using namespace seam;
 using namespace seam::nodes;
 
-AudioAnalyzer::AudioAnalyzer() : INode("Audio Analyzer") {
+AudioAnalyzer::AudioAnalyzer() : INode(metadata) {
 	flags = (NodeFlags)(flags | NodeFlags::UpdatesOverTime);
 }
 
@@ -43,6 +43,15 @@ PinOutput* AudioAnalyzer::PinOutputs(size_t& size) {
 }
 
 void AudioAnalyzer::Update(UpdateParams* params) {
+	// Take the loudest of the buffers analyzed since the last update.
+	float rms[32];
+	uint32_t popped;
+	while ((popped = rmsValues.PopBulk(rms, 32)) > 0) {
+		for (uint32_t i = 0; i < popped; i++) {
+			lastRms = std::max(lastRms, rms[i]);
+		}
+	}
+
 	// Always push RMS.
 	params->push_patterns->Push(pinOutputs[0], &lastRms, 1);
 
@@ -53,7 +62,9 @@ void AudioAnalyzer::Update(UpdateParams* params) {
 				uint32_t channelsSize = (uint32_t)algo.values0.size();
 				params->push_patterns->Push(*algo.pinOutChannelsSize, &channelsSize, 1);
 			}
-			params->push_patterns->Push(*algo.pinOutChannels, algo.values0.data(), algo.values0.size());
+			// values0 keeps accumulating from the audio thread, so push a copy which holds still until the next push.
+			algo.pushed.assign(algo.values0.begin(), algo.values0.end());
+			params->push_patterns->Push(*algo.pinOutChannels, algo.pushed.data(), algo.pushed.size());
 			std::fill(algo.values0.begin(), algo.values0.end(), 0.0f);
 			std::fill(algo.values1.begin(), algo.values1.end(), 0.0f);
 		}
@@ -66,7 +77,8 @@ void AudioAnalyzer::Update(UpdateParams* params) {
 void AudioAnalyzer::ProcessAudio(ofSoundBuffer& input) {
 	audioAnalyzer.analyze(input);
 	float currRms = audioAnalyzer.getValue(ofxAAAlgorithm::RMS, 0);
-	lastRms = std::max(lastRms, currRms);
+	// Update() owns lastRms; if it's fallen behind far enough to fill the ring, this buffer's RMS is dropped.
+	rmsValues.TryPush(currRms);
 
 	for (size_t algIndex = 0; algIndex < multiValueAlgos.size(); algIndex++) {
 		auto& algo = multiValueAlgos[algIndex];
@@ -74,7 +86,7 @@ void AudioAnalyzer::ProcessAudio(ofSoundBuffer& input) {
 		// auto& vals1 = audioAnalyzer.getValues(algo.algorithm, 1);
 
 		for (size_t i = 0; i < vals0.size() && i < algo.values0.size(); i++) {
-			algo.values0[i] = std::max(vals0[i] * lastRms, algo.values0[i]);
+			algo.values0[i] = std::max(vals0[i] * currRms, algo.values0[i]);
 		}
 	} 
 
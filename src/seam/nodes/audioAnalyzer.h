@@ -6,12 +6,15 @@
 #include "ofxAudioAnalyzer.h"
 
 #include "seam/include.h"
+#include "seam/containers/ringBuffer.h"
 
 using namespace seam::pins;
 
 namespace seam::nodes {
 	class AudioAnalyzer : public INode, public IAudioNode {
 	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("Audio Analyzer", { }, { PinType::Float });
+
 		AudioAnalyzer();
 		~AudioAnalyzer();
 
@@ -61,6 +64,10 @@ namespace seam::nodes {
 			std::vector<float> values0;
 			std::vector<float> values1;
 
+			/// @brief The values last pushed to pinOutChannels, which children may alias;
+			/// only written by Update(), right before the next push.
+			std::vector<float> pushed;
+
 			PinOutput* pinOutChannels = nullptr;
 			PinOutput* pinOutChannelsSize = nullptr;
 
@@ -92,12 +99,13 @@ namespace seam::nodes {
 			PinOutput* pinOutValue = nullptr;
 		};
 
+		// Channel outputs push from AudioAlgorithmMulti::pushed, so children can read them in place.
 		std::array<PinOutput, 6> pinOutputs = {
 			SetupOutputPin(this, PinType::Float, "RMS"),
-			SetupOutputPin(this, PinType::Float, "Spectrum Channels"),
+			SetupOutputPin(this, PinType::Float, "Spectrum Channels", 1, PinFlags::Aliasable),
 			SetupOutputPin(this, PinType::Float, "Spectrum Size"),
-			SetupOutputPin(this, PinType::Float, "HPCP"),
-			SetupOutputPin(this, PinType::Float, "Mel Bands"),
+			SetupOutputPin(this, PinType::Float, "HPCP", 1, PinFlags::Aliasable),
+			SetupOutputPin(this, PinType::Float, "Mel Bands", 1, PinFlags::Aliasable),
 			SetupOutputPin(this, PinType::Float, "Mel Bands Size"),
 		};
 
@@ -148,7 +156,12 @@ namespace seam::nodes {
 		};
 		
 		ofxAudioAnalyzer audioAnalyzer;
-		float lastRms = -1.f;
+
+		/// @brief RMS of each buffer ProcessAudio() analyzes, from the audio thread to Update().
+		/// Holds a few seconds' worth of buffers, so only a long stall of the update loop drops any.
+		RingBuffer<float> rmsValues { 256 };
+		/// @brief Loudest RMS since the last push; only touched by Update().
+		float lastRms = 0.f;
 
 		float alpha = 0.1f;
 		float silenceThresh = 0.02f;
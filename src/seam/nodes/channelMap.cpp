@@ -6,7 +6,9 @@ using namespace seam::nodes;
 
 const size_t ChannelMap::maxChannels = 16;
 
-ChannelMap::ChannelMap() : IDynamicPinsNode("Channel Map") {
+ChannelMap::ChannelMap() : IDynamicPinsNode(metadata) {
+   // Inputs are only read through ReadBuffer(), so wide pushes like FFT bins can be aliased instead of copied.
+   pinInputs[0].flags = pinInputs[0].flags | PinFlags::Aliasable;
    ResizeInputBuffer();
 }
 
@@ -29,7 +31,8 @@ PinOutput* ChannelMap::PinOutputs(size_t& size) {
 }
 
 void ChannelMap::Update(UpdateParams* params) {
-    const size_t bytesPerInput = BytesPerInput();
+    // Outputs often map into the same downstream inputs, so only notify each input once.
+    PushTransaction push(params->push_patterns);
     for (size_t i = 0; i < pinOutputs.size(); i++) {
         // Use the PinOutMapping to determine where the input buffer data is.
         auto& outMap = pinOutMappings[i];
@@ -40,12 +43,17 @@ void ChannelMap::Update(UpdateParams* params) {
             uint16_t assignedInput = outMap.assignedInputs[chan];
             uint16_t assignedChannel = outMap.assignedChannels[chan];
 
-            size_t inputOffset = assignedInput * bytesPerInput + assignedChannel * pinElementSize;
-            std::copy(&inputBuffer[inputOffset], &inputBuffer[inputOffset + pinElementSize], &outBuff[chan * pinElementSize]);
+            // The input's values may be aliased, rather than copied into inputBuffer.
+            size_t inputSize;
+            const char* input = (const char*)pinInputs[assignedInput].ReadBuffer(inputSize);
+            if (assignedChannel < inputSize) {
+                const char* value = input + assignedChannel * pinElementSize;
+                std::copy(value, value + pinElementSize, &outBuff[chan * pinElementSize]);
+            }
         }
 
         // Finally, push using the temp buffer.
-        params->push_patterns->Push(pinOutputs[i], outBuff.data(), outMap.channelsCount * pinElementSize);
+        push.Push(pinOutputs[i], outBuff.data(), outMap.channelsCount * pinElementSize);
     }
 
 }
@@ -62,7 +70,7 @@ void ChannelMap::OnPinConnected(PinConnectedArgs args) {
         // If all inputs are now connected, add another input of the current type.
         bool allConnected = true;
         for (size_t i = 0; i < pinInputs.size(); i++) {
-            allConnected = allConnected && pinInputs[i].connection != nullptr;
+            allConnected = allConnected && pinInputs[i].IsConnected();
         }
 
         if (allConnected) {
@@ -227,6 +235,7 @@ inline size_t ChannelMap::BytesPerInput() {
 PinInput& ChannelMap::CreateInput() {
     pinInputs.push_back(pins::SetupInputPin(currentInputType, this, &inputBuffer[0], 
         16, "Channels " + std::to_string(pinInputs.size())));
+    pinInputs.back().flags = pinInputs.back().flags | PinFlags::Aliasable;
     ResizeInputBuffer();
     RecacheInputConnections();
     return pinInputs[pinInputs.size() - 1];
@@ -236,6 +245,7 @@ PinOutput& ChannelMap::CreateOutput() {
     std::string outputName = "Output " + std::to_string(pinOutputs.size());
     pinOutputs.push_back(pins::SetupOutputPin(this, currentInputType, outputName));
     pinOutMappings.push_back(PinOutMapping());
+    PinsChanged();
     return pinOutputs[pinOutputs.size() - 1];
 }
 
@@ -246,7 +256,7 @@ void ChannelMap::DeleteInput(size_t i) {
     std::copy(inputBuffer.begin() + bytesPerInput * (i + 1), inputBuffer.end(), 
         inputBuffer.begin() + bytesPerInput * i);
 
-    if (pinInputs[i].connection != nullptr) {
+    if (pinInputs[i].IsConnected()) {
         // PLS FIX ME... Need to be able to disconnect without the Editor.
         // Refactor the Editor so it doesn't manage connections itself,
         // and then you can use the connector class from here.
@@ -255,9 +265,11 @@ void ChannelMap::DeleteInput(size_t i) {
 
     pinInputs.erase(pinInputs.begin() + i);
     ResizeInputBuffer();
+    PinsChanged();
 }
 
 void ChannelMap::DeleteOutput(size_t i) {
     pinOutputs.erase(pinOutputs.begin() + i);
     pinOutMappings.erase(pinOutMappings.begin() + i);
+    PinsChanged();
 }
\ No newline at end of file
@@ -11,6 +11,9 @@ namespace seam::nodes {
     /// @brief Provides tighter control over output-to-input channel mappings.
 	class ChannelMap : public IDynamicPinsNode {
 	public:
+		/// Outputs take on the type of the first connected input, so they aren't known up front.
+		static constexpr NodeMetadata metadata = NodeMetadata("Channel Map", { PinType::Any }, { });
+
 		ChannelMap();
 		~ChannelMap();
 
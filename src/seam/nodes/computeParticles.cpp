@@ -47,7 +47,7 @@ bool ComputeParticles::ReloadGeometryShader() {
 	);
 }
 
-ComputeParticles::ComputeParticles() : INode("Compute Particles") {
+ComputeParticles::ComputeParticles() : INode(metadata) {
 	flags = (NodeFlags)(flags | NodeFlags::IsVisual);
 
 	// TEMP!!!
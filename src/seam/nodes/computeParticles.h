@@ -8,6 +8,8 @@ using namespace seam::pins;
 namespace seam::nodes {
 	class ComputeParticles : public INode {
 	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("Compute Particles", { PinType::Float }, { PinType::FboRgba });
+
 		ComputeParticles();
 
 		~ComputeParticles();
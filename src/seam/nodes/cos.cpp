@@ -3,8 +3,8 @@
 using namespace seam;
 using namespace seam::nodes;
 
-Cos::Cos() : INode("Cosine") {
-	flags = (NodeFlags)(flags | NodeFlags::UpdatesOverTime);
+Cos::Cos() : INode(metadata) {
+	flags = (NodeFlags)(flags | NodeFlags::UpdatesOverTime | NodeFlags::ThreadSafeUpdate);
 }
 
 Cos::~Cos() {
@@ -31,8 +31,5 @@ float Cos::Calculate(float t) {
 
 void Cos::Update(UpdateParams* params) {
 	float v = Calculate(params->time);
-	// TODO generalize "propagation" (template function?)
-	for (size_t i = 0; i < pin_out_fval.connections.size(); i++) {
-		params->push_patterns->Push(pin_out_fval, &v, 1);
-	}
+	params->push_patterns->Push(pin_out_fval, &v, 1);
 }
\ No newline at end of file
@@ -9,6 +9,8 @@ namespace seam::nodes {
 	/// Cosine signal generator
 	class Cos : public INode {
 	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("Cosine", { PinType::Float }, { PinType::Float });
+
 		Cos();
 		~Cos();
 
@@ -28,16 +30,16 @@ namespace seam::nodes {
 		float phase_shift = 0.f;
 		
 		std::array<PinInput, 4> pin_inputs = {
-			pins::SetupInputPin(PinType::Float, this, &frequency, 1, "Frequency",
+			TypedPinInput<float>(this, &frequency, "Frequency",
 				PinInOptions("a frequency of one will oscillate once per second; two will oscillate twice per second, etc.", &frequencyMeta)),
-			pins::SetupInputPin(PinType::Float, this, &amplitude, 1, "Amplitude", 
+			TypedPinInput<float>(this, &amplitude, "Amplitude", 
 				PinInOptions("all values are multiplied by this number")),
-			pins::SetupInputPin(PinType::Float, this, &amplitude_shift, 1, "Amplitude_Shift", 
+			TypedPinInput<float>(this, &amplitude_shift, "Amplitude_Shift", 
 				PinInOptions("is added to all values")),
-			pins::SetupInputPin(PinType::Float, this, &phase_shift, 1, "Phase_Shift", 
+			TypedPinInput<float>(this, &phase_shift, "Phase_Shift", 
 				PinInOptions("offsets oscillations")),
 		};
 
-		PinOutput pin_out_fval = pins::SetupOutputPin(this, pins::PinType::Float, "output");
+		TypedPinOutput<float> pin_out_fval = TypedPinOutput<float>(this, "output");
 	};
 }
\ No newline at end of file
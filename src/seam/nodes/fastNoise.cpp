@@ -4,7 +4,7 @@
 
 using namespace seam::nodes;
 
-FastNoise::FastNoise() : INode("Fast Noise") {
+FastNoise::FastNoise() : INode(metadata) {
     // TEMP: always use UpdatesOverTime, but there should be a way to flag and unflag
     // nodes for over-time updates instead.
     flags = (NodeFlags)(flags | NodeFlags::IsVisual | NodeFlags::UpdatesOverTime);
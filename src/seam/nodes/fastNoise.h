@@ -35,6 +35,8 @@ namespace seam::nodes {
     /// https://github.com/Auburn/FastNoiseLite/tree/master
 	class FastNoise : public INode {
 	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("Fast Noise", { PinType::Int, PinType::Float, PinType::Bool }, { PinType::FboRgba });
+
 		FastNoise();
 
         void Setup(SetupParams* params) override;
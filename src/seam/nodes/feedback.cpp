@@ -6,7 +6,7 @@ using namespace seam::nodes;
 
 const std::string Feedback::fboInputName = "Input FBO";
 
-Feedback::Feedback() : INode("Feedback") {
+Feedback::Feedback() : INode(metadata) {
 	flags = (NodeFlags)(flags | NodeFlags::IsVisual);
 	gui_display_fbo = &fbo1;
 }
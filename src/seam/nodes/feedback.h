@@ -7,6 +7,8 @@ using namespace seam::pins;
 namespace seam::nodes {
 	class Feedback : public INode {
 	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("Feedback", { PinType::FboRgba, PinType::Float }, { PinType::FboRgba });
+
 		Feedback();
 
 		void Setup(SetupParams* params) override;
@@ -4,7 +4,7 @@
 using namespace seam;
 using namespace seam::nodes;
 
-Gate::Gate() : INode("Gate") {
+Gate::Gate() : INode(metadata) {
 }
 
 Gate::~Gate() {
@@ -17,12 +17,14 @@ void Gate::Setup(SetupParams* params) {
 }
 
 void Gate::Update(UpdateParams* params) {
+	// The gated value and the changed event usually go to the same Node, which should only be notified once.
+	PushTransaction push(params->push_patterns);
 	size_t valueIndex = selectedGate * numCoords;
 	if (gatedValues.size() > valueIndex) {
-		params->push_patterns->Push(pinOutSelection, &gatedValues[valueIndex], 1);
+		push.Push(pinOutSelection, &gatedValues[valueIndex], 1);
 	}
 
-	params->push_patterns->PushFlow(pinOutGateChangedEvent);
+	push.PushFlow(pinOutGateChangedEvent);
 }
 
 pins::PinInput* Gate::PinInputs(size_t& size) {
@@ -8,6 +8,8 @@ using namespace seam::pins;
 namespace seam::nodes {
 	class Gate : public INode {
 	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("Gate", { PinType::Int, PinType::Float }, { PinType::Float, PinType::Flow });
+
 		Gate();
 		~Gate();
 
@@ -3,7 +3,7 @@
 
 using namespace seam::nodes;
 
-HdrTonemapper::HdrTonemapper() : INode("HDR Tone Mapper") {
+HdrTonemapper::HdrTonemapper() : INode(metadata) {
     flags = (NodeFlags)(flags | NodeFlags::IsVisual);
 	gui_display_fbo = &tonemappedFbo;
 }
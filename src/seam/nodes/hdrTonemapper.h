@@ -13,6 +13,8 @@ namespace seam::nodes {
 	/// with tone-mapping and bloom.
 	class HdrTonemapper : public INode {
 	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("HDR Tone Mapper", { PinType::FboRgba16F, PinType::Float }, { PinType::FboRgba });
+
 		HdrTonemapper();
 		virtual ~HdrTonemapper() override;
 
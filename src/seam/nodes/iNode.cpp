@@ -4,6 +4,7 @@
 
 #include "blueprints/widgets.h"
 #include "seam/imguiUtils/properties.h"
+#include "seam/pins/pinIndex.h"
 
 using namespace seam;
 using namespace seam::nodes;
@@ -135,7 +136,7 @@ void INode::GuiDrawInputPin(ed::Utilities::BlueprintNodeBuilder& builder, pins::
 	PinInput* children = pinIn->PinInputs(childrenSize);
 	bool showChildren = false;
 
-	DrawPinIcon(pinIn->type, pinIn->connection != nullptr, 1.0f);
+	DrawPinIcon(pinIn->type, pinIn->IsConnected(), 1.0f);
 	ImGui::Spring(0.f);
 
 	if (childrenSize > 0) {
@@ -224,13 +225,30 @@ void INode::GuiDrawNodeCenter() {
 }
 
 pins::PinInput* INode::FindPinInput(PinId id) {
+	if (seamState.pinIndex != nullptr && seamState.pinIndex->FindNode(id) == this) {
+		return seamState.pinIndex->FindInput(id);
+	}
 	return IInPinnable::FindPinIn(this, id);
 }
 
 pins::PinOutput* INode::FindPinOutput(PinId id) {
+	if (seamState.pinIndex != nullptr && seamState.pinIndex->FindNode(id) == this) {
+		return seamState.pinIndex->FindOutput(id);
+	}
 	return IOutPinnable::FindPinOut(this, id);
 }
 
+void INode::PinsChanged() {
+	if (seamState.pinIndex != nullptr) {
+		seamState.pinIndex->Invalidate(this);
+	}
+}
+
+void INode::RecacheInputConnections() {
+	IInPinnable::RecacheInputConnections();
+	PinsChanged();
+}
+
 void INode::OnWindowResized(glm::uvec2 resolution) {
 	for (auto& windowFbo : windowFbos) {
 		glm::ivec2 expected = resolution * windowFbo.ratio;
@@ -12,6 +12,8 @@
 #include "seam/properties/nodeProperty.h"
 #include "seam/framePool.h"
 #include "seam/seamState.h"
+#include "seam/profiler.h"
+#include "seam/nodes/nodeMetadata.h"
 
 #include "blueprints/builders.h"
 namespace ed = ax::NodeEditor;
@@ -30,8 +32,6 @@ namespace seam::pins {
 
 namespace seam::nodes {
 
-	using NodeId = uint64_t;
-
 	/// A bitmask enum for marking boolean properties of a Node
 	enum class NodeFlags : uint16_t {
 		// visual nodes draw things using the GPU,
@@ -52,6 +52,15 @@ namespace seam::nodes {
 
 		/// Nodes which process audio should use this flag and overrid INode::ProcessAudio()
 		ProcessesAudio = 1 << 3,
+
+		/// Opt-in for Nodes whose Update() only touches their own state and pushes through PushPatterns.
+		/// When the SeamGraph has update threads, Nodes with this flag which share an update order
+		/// may Update() in parallel on worker threads. Their pushes run on that worker too:
+		/// the child's input buffers are written and its pin callbacks are called from the worker.
+		/// Nodes which push into the same child are never in the same parallel batch,
+		/// so each child only sees one pushing worker at a time.
+		/// Don't make GL calls, and don't touch other Nodes except by pushing.
+		ThreadSafeUpdate = 1 << 4,
 	};
 
 	DeclareFlagOperators(NodeFlags, uint16_t);
@@ -109,6 +118,13 @@ namespace seam::nodes {
 			id = IdsDistributor::GetInstance().NextNodeId();
 		}
 
+		/// @brief Node types which declare static metadata should construct with it,
+		/// so the name the factory registers always matches the instance's name.
+		INode(const NodeMetadata& metadata)
+			: INode(metadata.name.data())
+		{
+		}
+
 		virtual ~INode() { }
 		
 		/// @brief Override this to return your own pointer to a list of input pins.
@@ -187,15 +203,30 @@ namespace seam::nodes {
 		}
 
 		inline bool IsDirty() {
-			return dirty;
+			return dirtied_epoch.load(std::memory_order_acquire) > updated_epoch;
 		}
 
+		/// @brief Dirtying a node dirties its children too, but only this node is stamped here;
+		/// the SeamGraph passes dirtiness down to children when its update schedule reaches them.
+		/// Safe to call from other threads.
 		inline void SetDirty() {
-			dirty = true;
-			// dirtying a node dirties its children
-			// need to clean up those dirty kids!
-			for (size_t i = 0; i < children.size(); i++) {
-				children[i].node->SetDirty();
+			if (seamState.frameEpoch == nullptr) {
+				RaiseDirtiedEpoch(updated_epoch + 1);
+				return;
+			}
+
+			// Update passes run on even epochs. A thread which isn't running the current pass,
+			// like a MIDI callback, stamps the epoch after it, since the pass may already be done with this Node.
+			// If a pass starts or ends while stamping, stamp again for the new epoch.
+			uint32_t epoch = seamState.frameEpoch->load(std::memory_order_acquire);
+			while (true) {
+				const bool otherPass = epoch % 2 == 0 && epoch != threadPassEpoch;
+				RaiseDirtiedEpoch(otherPass ? epoch + 1 : epoch);
+				const uint32_t now = seamState.frameEpoch->load(std::memory_order_acquire);
+				if (now == epoch) {
+					break;
+				}
+				epoch = now;
 			}
 		}
 
@@ -211,9 +242,21 @@ namespace seam::nodes {
 			return (flags & NodeFlags::IsVisual) == NodeFlags::IsVisual;
 		}
 
+		inline bool IsThreadSafeUpdate() {
+			return (flags & NodeFlags::ThreadSafeUpdate) == NodeFlags::ThreadSafeUpdate;
+		}
+
+		/// @brief Look up one of this Node's pins by id; uses the graph's PinIndex once the Node is in a graph.
 		pins::PinInput* FindPinInput(pins::PinId id);
 		pins::PinOutput* FindPinOutput(pins::PinId id);
 
+		/// @brief Call when this Node's pins are added, removed, moved in memory, or given new ids,
+		/// so the graph's PinIndex stops pointing at the old pins. 
+		/// RecacheInputConnections() calls it, so changing only input pins doesn't need a separate call.
+		void PinsChanged();
+
+		void RecacheInputConnections() override;
+
 	protected:
 		struct NodeConnection {
 			INode* node = nullptr;
@@ -250,7 +293,7 @@ namespace seam::nodes {
 
 		// nodes' Update() calls should be made parent-first
 		// update order == max(transmitters' update order) + 1
-		int16_t update_order = 0;
+		int32_t update_order = 0;
 
 		seam::nodes::NodeId id = 0;
 
@@ -274,8 +317,40 @@ namespace seam::nodes {
 
 		// a node is dirtied when its inputs change, or time progresses in some cases
 		// a dirtied node needs to have its Update() called once it becomes part of the visual chain,
-		// and a dirtied visual node needs to have its Draw() called
-		bool dirty = true;
+		// and a dirtied visual node needs to have its Draw() called.
+		// Dirtiness is tracked with SeamGraph frame epochs: the node is dirty while dirtied_epoch > updated_epoch.
+		// Only ever raised, so a thread stamping a stale epoch can't undo a newer one.
+		std::atomic<uint32_t> dirtied_epoch = 1;
+
+		inline void RaiseDirtiedEpoch(uint32_t epoch) {
+			uint32_t prev = dirtied_epoch.load(std::memory_order_relaxed);
+			while (prev < epoch && !dirtied_epoch.compare_exchange_weak(prev, epoch, std::memory_order_release, std::memory_order_relaxed)) { }
+		}
+
+		// The update pass the calling thread is running Nodes for, set by the SeamGraph; see SetDirty().
+		static inline thread_local uint32_t threadPassEpoch = 0;
+
+		// Frame epoch of this node's last Update().
+		uint32_t updated_epoch = 0;
+
+		// Frame epoch in which this node last passed its dirtiness on to its children.
+		uint32_t propagated_epoch = 0;
+
+		// Set by the SeamGraph while compiling its update schedule, so shared parents are only scheduled once.
+		uint32_t schedule_mark = 0;
+
+		// Set by the SeamGraph while recalculating update orders or checking new connections for cycles.
+		uint32_t order_mark = 0;
+
+		// Set by the SeamGraph while compiling its update schedule:
+		// the last parallel batch in the current update order level with a Node which pushes into this one.
+		uint32_t schedule_batch = 0;
+
+		// Set by the SeamGraph while pipelined, for nodes which update on the pipeline thread.
+		bool pipeline_update = false;
+
+		// Rolling timings of this node's calls; only allocated while the SeamGraph is profiling.
+		std::unique_ptr<NodeTimings> timings;
 
 		/// @brief List of child nodes which this node sends events to
 		std::vector<NodeConnection> children;
@@ -310,6 +385,9 @@ namespace seam::nodes {
 		};
 
 		IDynamicPinsNode(const char* name) : INode(name) {
+		}
+
+		IDynamicPinsNode(const NodeMetadata& metadata) : INode(metadata) {
 
 		}
 
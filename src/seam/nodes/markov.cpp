@@ -3,7 +3,7 @@
 using namespace seam;
 using namespace seam::nodes;
 
-Markov::Markov() : INode("Markov") {
+Markov::Markov() : INode(metadata) {
 	flags = (NodeFlags)(NodeFlags::UpdatesOverTime | flags);
 	Reconfigure();
 }
@@ -8,6 +8,8 @@ using namespace seam::pins;
 namespace seam::nodes {
 	class Markov : public INode {
 	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("Markov", { }, { PinType::Int, PinType::Flow });
+
 		Markov();
 		~Markov();
 
@@ -14,7 +14,7 @@ namespace {
 	}
 }
 
-MidiIn::MidiIn() : IDynamicPinsNode("MIDI In") {
+MidiIn::MidiIn() : IDynamicPinsNode(metadata) {
 	// external input requires updating every frame
 	flags = (NodeFlags)(flags | NodeFlags::UpdatesEveryFrame);
 	custom_pins_index = pin_outputs.size();
@@ -93,15 +93,21 @@ PinOutput* MidiIn::AddNotePin(uint32_t midi_note) {
 		);
 
 		pin_outputs.insert(it, std::move(pin_out));
+		PinsChanged();
 
 		return &pin_outputs[index];
 	}
 }
 
 void MidiIn::newMidiMessage(ofxMidiMessage& msg) {
-	// all we do here is push to the ring buffer;
-	// the messages will be processed and drained in Update()
-	messages.Push(msg);
+	// queue a copy of the note, rather than a pointer to a note event;
+	// the events are made from the update loop's frame pool in Update(),
+	// so they live as long as everything else pushed this frame
+	if (msg.status != MIDI_NOTE_ON && msg.status != MIDI_NOTE_OFF) {
+		return;
+	}
+	MidiNote note { msg.status, msg.pitch, msg.velocity };
+	messages.Push(&note, 1);
 	SetDirty();
 }
 
@@ -141,7 +147,7 @@ bool MidiIn::GuiDrawPropertiesList(UpdateParams* params) {
 	return changed;
 }
 
-seam::notes::NoteOnEvent* MidiIn::MidiToNoteOnEvent(ofxMidiMessage& msg, seam::FramePool* alloc_pool) {
+seam::notes::NoteOnEvent* MidiIn::MidiToNoteOnEvent(const MidiNote& msg, seam::FramePool* alloc_pool) {
 	// use the frame pool to get space for the note event
 	NoteOnEvent* ev = alloc_pool->Alloc<NoteOnEvent>();
 	// convert pitch from MIDI note to frequency in hz
@@ -155,7 +161,7 @@ seam::notes::NoteOnEvent* MidiIn::MidiToNoteOnEvent(ofxMidiMessage& msg, seam::F
 	return ev;
 }
 
-seam::notes::NoteOffEvent* MidiIn::MidiToNoteOffEvent(ofxMidiMessage& msg, seam::FramePool* alloc_pool) {
+seam::notes::NoteOffEvent* MidiIn::MidiToNoteOffEvent(const MidiNote& msg, seam::FramePool* alloc_pool) {
 	// frame pool alloc a note off event
 	NoteOffEvent* ev = alloc_pool->Alloc<NoteOffEvent>();
 	// instance id is the note's MIDI pitch (just like with note on)
@@ -163,7 +169,7 @@ seam::notes::NoteOffEvent* MidiIn::MidiToNoteOffEvent(ofxMidiMessage& msg, seam:
 	return ev;
 }
 
-void MidiIn::AttemptPushToNotePin(UpdateParams* params, NoteEvent* ev, int pitch) {
+void MidiIn::AttemptPushToNotePin(UpdateParams* params, NoteEvent* ev, uint32_t pitch) {
 	// check if there's a pin for changes to this specific note
 	// first search for it
 	auto it = std::lower_bound(
@@ -180,25 +186,28 @@ void MidiIn::AttemptPushToNotePin(UpdateParams* params, NoteEvent* ev, int pitch
 
 void MidiIn::Update(UpdateParams* params) {
 	// drain the messages queue
-	ofxMidiMessage msg;
-	while (messages.Pop(msg)) {
-		// push each message to the event queue pins,
-		// if the message type is one we care about
-		if (msg.status == MIDI_NOTE_ON && flags::AreRaised(listening_event_types, EventTypes::On)) {
-			notes::NoteOnEvent* ev = MidiToNoteOnEvent(msg, params->alloc_pool);
+	size_t size;
+	MidiNote* notes = (MidiNote*)messages.Drain(size);
+	for (size_t i = 0; i < size; i++) {
+		const MidiNote& note = notes[i];
+		// make a note event and push it to the event queue pins,
+		// if the event type is one we care about
+		if (note.status == MIDI_NOTE_ON && flags::AreRaised(listening_event_types, EventTypes::On)) {
+			NoteEvent* ev = MidiToNoteOnEvent(note, params->alloc_pool);
 			// push to all notes stream and notes on stream
 			params->push_patterns->Push(pin_outputs[0], &ev, 1);
 			params->push_patterns->Push(pin_outputs[1], &ev, 1);
-			AttemptPushToNotePin(params, ev, msg.pitch);
+			AttemptPushToNotePin(params, ev, ev->instance_id);
 
-		} else if (msg.status == MIDI_NOTE_OFF && flags::AreRaised(listening_event_types, EventTypes::Off)) {
-			notes::NoteOffEvent* ev = MidiToNoteOffEvent(msg, params->alloc_pool);
+		} else if (note.status == MIDI_NOTE_OFF && flags::AreRaised(listening_event_types, EventTypes::Off)) {
+			NoteEvent* ev = MidiToNoteOffEvent(note, params->alloc_pool);
 			// push to all notes stream and notes off stream
 			params->push_patterns->Push(pin_outputs[0], &ev, 1);
 			params->push_patterns->Push(pin_outputs[2], &ev, 1);
-			AttemptPushToNotePin(params, ev, msg.pitch);
+			AttemptPushToNotePin(params, ev, ev->instance_id);
 		}
 	}
+	messages.Consume(size);
 }
 
 PinInput* MidiIn::AddPinIn(PinInArgs args) {
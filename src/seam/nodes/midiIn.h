@@ -5,13 +5,15 @@
 #include "ofxMidi.h"
 
 #include "seam/include.h"
-#include "seam/containers/ringBuffer.h"
+#include "seam/containers/eventQueue.h"
 
 using namespace seam::pins;
 
 namespace seam::nodes {
 	class MidiIn : public IDynamicPinsNode, public ofxMidiListener {
 	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("MIDI In", { }, { PinType::NoteEvent });
+
 		MidiIn();
 		~MidiIn();
 
@@ -47,9 +49,16 @@ namespace seam::nodes {
 
 		static bool CompareNotePin(const PinOutput& pin_out, const uint32_t note);
 
-		notes::NoteOnEvent* MidiToNoteOnEvent(ofxMidiMessage& msg, FramePool* alloc_pool);
-		notes::NoteOffEvent* MidiToNoteOffEvent(ofxMidiMessage& msg, FramePool* alloc_pool);
-		void AttemptPushToNotePin(UpdateParams* params, notes::NoteEvent* ev, int pitch);
+		/// @brief The parts of an ofxMidiMessage which make up a note event.
+		struct MidiNote {
+			MidiStatus status;
+			int pitch;
+			int velocity;
+		};
+
+		notes::NoteOnEvent* MidiToNoteOnEvent(const MidiNote& msg, FramePool* alloc_pool);
+		notes::NoteOffEvent* MidiToNoteOffEvent(const MidiNote& msg, FramePool* alloc_pool);
+		void AttemptPushToNotePin(UpdateParams* params, notes::NoteEvent* ev, uint32_t pitch);
 
 		// this node has a variable number of output pins;
 		// there is always at least one, an EVENT_QUEUE Pin which pushes ALL note events,
@@ -77,8 +86,9 @@ namespace seam::nodes {
 		int gui_midi_port = 0;
 		int gui_note_add = 0;
 
-		// pushes MIDI messages from midi_in; the update loop drains messages
-		// if you manage to make more than 16 MIDI notes in a single frame, wow
-		RingBuffer<ofxMidiMessage> messages = RingBuffer<ofxMidiMessage>(16);
+		// copies of midi_in's note messages, pushed from the MIDI thread;
+		// the update loop drains them and makes the note events it pushes.
+		// Grows as needed, so bursts of notes in a single frame aren't dropped.
+		EventQueue messages { sizeof(MidiNote) };
 	};
 }
\ No newline at end of file
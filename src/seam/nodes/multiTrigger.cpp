@@ -3,7 +3,7 @@
 using namespace seam;
 using namespace seam::nodes;
 
-MultiTrigger::MultiTrigger() : INode("Multi Trigger") {
+MultiTrigger::MultiTrigger() : INode(metadata) {
 	Resize(inputsSize);
 }
 
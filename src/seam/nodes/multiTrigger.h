@@ -5,9 +5,11 @@
 using namespace seam::pins;
 
 namespace seam::nodes {
-	// This will hopefully become unnecessary once Pin Connections are smarter.
+	// Flow inputs accept any number of connections now, so this is only kept for graphs which already use it.
 	class MultiTrigger : public INode {
 	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("Multi Trigger", { PinType::Flow }, { PinType::Flow });
+
 		MultiTrigger();
 
 		PinInput* PinInputs(size_t& size) override;
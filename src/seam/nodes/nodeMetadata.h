@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <string_view>
+
+#include "seam/hash.h"
+#include "seam/pins/pinTypes.h"
+
+namespace seam::nodes {
+	using NodeId = uint64_t;
+
+	/// @brief A small fixed-capacity set of pin types, so it can be built at compile time.
+	struct PinTypeSet {
+		static constexpr size_t MAX_TYPES = 8;
+
+		constexpr PinTypeSet() { }
+
+		constexpr PinTypeSet(std::initializer_list<pins::PinType> pinTypes) {
+			for (auto t : pinTypes) {
+				Add(t);
+			}
+		}
+
+		constexpr bool Contains(pins::PinType type) const {
+			for (size_t i = 0; i < size; i++) {
+				if (types[i] == type) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/// @brief Types which are already in the set are ignored.
+		constexpr void Add(pins::PinType type) {
+			if (!Contains(type) && size < MAX_TYPES) {
+				types[size++] = type;
+			}
+		}
+
+		constexpr const pins::PinType* begin() const {
+			return types.data();
+		}
+
+		constexpr const pins::PinType* end() const {
+			return types.data() + size;
+		}
+
+		std::array<pins::PinType, MAX_TYPES> types = { };
+		size_t size = 0;
+	};
+
+	/// @brief Describes a Node type without constructing an instance of it.
+	/// Node types declare this as a static constexpr member named metadata,
+	/// so the EventNodeFactory can register them without running their constructors.
+	struct NodeMetadata {
+		constexpr NodeMetadata(std::string_view _name, PinTypeSet _pinInputs, PinTypeSet _pinOutputs)
+			: name(_name), id(SCHash(_name)), pinInputs(_pinInputs), pinOutputs(_pinOutputs) { }
+
+		/// @brief The Node type's human readable name; must match the name passed to INode's constructor.
+		std::string_view name;
+
+		/// @brief Hashed from the name.
+		NodeId id;
+
+		/// @brief Unique input pin types the Node type can have, including pins created after construction.
+		PinTypeSet pinInputs;
+
+		/// @brief Unique output pin types the Node type can have, including pins created after construction.
+		PinTypeSet pinOutputs;
+	};
+}
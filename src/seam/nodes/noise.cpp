@@ -3,8 +3,8 @@
 using namespace seam;
 using namespace seam::nodes;
 
-Noise::Noise() : INode("Noise") {
-	flags = (NodeFlags)(flags | NodeFlags::UpdatesOverTime);
+Noise::Noise() : INode(metadata) {
+	flags = (NodeFlags)(flags | NodeFlags::UpdatesOverTime | NodeFlags::ThreadSafeUpdate);
 	seed = ofRandom(-100.f, 100.f);
 }
 
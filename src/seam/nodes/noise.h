@@ -8,6 +8,8 @@ namespace seam::nodes {
 	/// Noise wave signal generator
 	class Noise : public INode {
 	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("Noise", { PinType::Float }, { PinType::Float });
+
 		Noise();
 		~Noise();
 
@@ -3,7 +3,7 @@
 using namespace seam;
 using namespace seam::nodes;
 
-NotesPrinter::NotesPrinter() : INode("Notes Printer") {
+NotesPrinter::NotesPrinter() : INode(metadata) {
 	// this is a debug tool which will never be part of a visual chain (it has no outputs).
 	// check for Update() every frame.
 	flags = (NodeFlags)(flags | NodeFlags::UpdatesEveryFrame | NodeFlags::UpdatesOverTime | NodeFlags::IsVisual);
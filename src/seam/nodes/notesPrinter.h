@@ -9,6 +9,8 @@ namespace seam::nodes {
 	/// Inherit this class and override PrintNoteEvent() to print extended note info.
 	class NotesPrinter : public INode {
 	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("Notes Printer", { PinType::NoteEvent }, { });
+
 		NotesPrinter();
 		virtual ~NotesPrinter();
 
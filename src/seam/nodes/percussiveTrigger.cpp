@@ -27,7 +27,7 @@ namespace {
 	}
 }
 
-PercussiveTrigger::PercussiveTrigger() : INode("Percussive Trigger") {
+PercussiveTrigger::PercussiveTrigger() : INode(metadata) {
 	flags = (NodeFlags)(flags | NodeFlags::UpdatesOverTime);
 	pinNotesOnStream = FindPinInByName(this, notesOnStreamPinName);
 	assert(pinNotesOnStream != nullptr);
@@ -9,6 +9,8 @@ namespace seam::nodes {
 	/// Can turn one-shot percussive events into a suitable animation curve.
 	class PercussiveTrigger : public INode {
 	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("Percussive Trigger", { PinType::Flow, PinType::NoteEvent, PinType::Float }, { PinType::Float, PinType::Flow });
+
 		PercussiveTrigger();
 		virtual ~PercussiveTrigger();
 
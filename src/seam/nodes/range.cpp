@@ -15,7 +15,9 @@ namespace {
 	}
 }
 
-Range::Range() : INode("Range") {
+Range::Range() : INode(metadata) {
+	flags = (NodeFlags)(flags | NodeFlags::ThreadSafeUpdate);
+
 	PinInput* valuePin = FindPinInByName(this, inputValuePinName);
 	assert(valuePin != nullptr);
 
@@ -9,6 +9,8 @@ namespace seam::nodes {
 	/// Adds the input value to the output value every frame.
 	class Range : public INode {
 	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("Range", { PinType::Float }, { PinType::Float });
+
 		Range();
 
 		void Update(UpdateParams* params) override;
@@ -3,8 +3,8 @@
 using namespace seam;
 using namespace seam::nodes;
 
-Saw::Saw() : INode("Saw") {
-	flags = (NodeFlags)(flags | NodeFlags::UpdatesOverTime);
+Saw::Saw() : INode(metadata) {
+	flags = (NodeFlags)(flags | NodeFlags::UpdatesOverTime | NodeFlags::ThreadSafeUpdate);
 }
 
 Saw::~Saw() {
@@ -27,10 +27,7 @@ void Saw::Update(UpdateParams* params) {
 
 	float v = leadingEdge + progress * (fallingEdge - leadingEdge);
 
-	// TODO generalize "propagation" (template function?)
-	for (size_t i = 0; i < pin_out_fval.connections.size(); i++) {
-		params->push_patterns->Push(pin_out_fval, &v, 1);
-	}
+	params->push_patterns->Push(pin_out_fval, &v, 1);
 }
 
 void Saw::Reset() {
@@ -8,6 +8,8 @@ namespace seam::nodes {
 	/// Saw wave signal generator
 	class Saw : public INode {
 	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("Saw", { PinType::Float, PinType::Flow }, { PinType::Float });
+
 		Saw();
 		~Saw();
 
@@ -26,14 +28,14 @@ namespace seam::nodes {
 		float fallingEdge = 0.01f;
 
 		std::array<PinInput, 4> pin_inputs = {
-			pins::SetupInputPin(PinType::Float, this, &frequency, 1, "Frequency"),
-			pins::SetupInputPin(PinType::Float, this, &leadingEdge, 1, "Leading Edge", 
+			TypedPinInput<float>(this, &frequency, "Frequency"),
+			TypedPinInput<float>(this, &leadingEdge, "Leading Edge", 
 				PinInOptions("right before the saw wave snap, the value will be this")),
-			pins::SetupInputPin(PinType::Float, this, &fallingEdge, 1, "Falling Edge", 
+			TypedPinInput<float>(this, &fallingEdge, "Falling Edge", 
 				PinInOptions("right after the saw wave snap, the value will be this")),
 			pins::SetupInputFlowPin(this, [&] { Reset(); }, "Reset"),
 		};
 
-		PinOutput pin_out_fval = pins::SetupOutputPin(this, pins::PinType::Float, "output");
+		TypedPinOutput<float> pin_out_fval = TypedPinOutput<float>(this, "output");
 	};
 }
\ No newline at end of file
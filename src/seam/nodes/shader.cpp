@@ -5,7 +5,7 @@
 using namespace seam;
 using namespace seam::nodes;
 
-Shader::Shader() : INode("Shader Material") {
+Shader::Shader() : INode(metadata) {
 	flags = (NodeFlags)(flags | NodeFlags::IsVisual);
 
 	windowFbos.push_back(WindowRatioFbo(&fbo, &pinOutMaterial));
@@ -12,6 +12,8 @@ namespace seam::nodes {
 	/// "Outputs" the shader as a Material PinOutput
 	class Shader : public INode {
 	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("Shader Material", { PinType::Struct }, { PinType::FboRgba16F });
+
 		Shader();
 		~Shader();
 
@@ -3,9 +3,9 @@
 using namespace seam;
 using namespace seam::nodes;
 
-Step::Step() : INode("Step") {
+Step::Step() : INode(metadata) {
 	// temp???@@@
-	flags = (NodeFlags)(flags | NodeFlags::UpdatesOverTime);
+	flags = (NodeFlags)(flags | NodeFlags::UpdatesOverTime | NodeFlags::ThreadSafeUpdate);
 }
 
 Step::~Step() {
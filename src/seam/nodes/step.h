@@ -11,6 +11,8 @@ namespace seam::nodes {
 	/// </summary>
 	class Step : public INode {
 	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("Step", { PinType::Float }, { PinType::Float, PinType::Bool });
+
 		Step();
 		~Step();
 
@@ -25,14 +27,14 @@ namespace seam::nodes {
 		float input = 0.f;
 
 		std::array<PinInput, 3> pin_inputs = {
-			pins::SetupInputPin(PinType::Float, this, &edge, 1, "Edge", 
+			TypedPinInput<float>(this, &edge, "Edge", 
 				PinInOptions("The input value will be compared to this edge value using the comparator.")),
-			pins::SetupInputPin(PinType::Float, this, &comparator, 1, "Comparator", 
+			TypedPinInput<float>(this, &comparator, "Comparator", 
 				PinInOptions("When < 0, output is input < edge, when == 0 equality is used, when > 0 check input > edge" )),
-			pins::SetupInputPin(PinType::Float, this, &input, 1, "Input"),
+			TypedPinInput<float>(this, &input, "Input"),
 		};
 
-		PinOutput pin_out_fval = pins::SetupOutputPin(this, pins::PinType::Float, "Float Output");
-		PinOutput pin_out_bval = pins::SetupOutputPin(this, pins::PinType::Bool, "Bool Output");
+		TypedPinOutput<float> pin_out_fval = TypedPinOutput<float>(this, "Float Output");
+		TypedPinOutput<bool> pin_out_bval = TypedPinOutput<bool>(this, "Bool Output");
 	};
 }
\ No newline at end of file
@@ -2,8 +2,8 @@
 
 using namespace seam::nodes;
 
-Threshold::Threshold() : INode("Threshold") {
-    flags = (NodeFlags)(flags | NodeFlags::UpdatesOverTime);
+Threshold::Threshold() : INode(metadata) {
+    flags = (NodeFlags)(flags | NodeFlags::UpdatesOverTime | NodeFlags::ThreadSafeUpdate);
 
     VectorPinInput::Options options;
     options.onSizeChanged = [this](VectorPinInput* vectorPin) { OnSizeChanged(vectorPin); };
@@ -16,43 +16,43 @@ Threshold::Threshold() : INode("Threshold") {
 };
 
 void Threshold::Update(UpdateParams* params) {
-    size_t thresholdsSize, valuesSize;
-    ThresholdConfig* configs = thresholds.Get<ThresholdConfig>(thresholdsSize);
-    float* fv = values.Get<float>(valuesSize);
-
-    assert(thresholdsSize == valuesSize);
+    const size_t valuesSize = values.Size();
+    assert(thresholds.Size() == valuesSize);
 
     for (size_t i = 0; i < valuesSize; i++) {
+        ThresholdConfig& config = thresholds.Get<ThresholdConfig>(i);
+        const float value = values.Get<float>(i);
+
         size_t childrenSize;
         PinOutput* childPins = pinOutEvents[i].PinOutputs(childrenSize);
         PinOutput& flowPinOut = childPins[0];
         PinOutput& triggeredPinOut = childPins[1];
 
-        if (configs[i].triggered) {
+        if (config.triggered) {
             // When triggered and the current value has dipped below the trigger, accumulate silence time.
-            if (configs[i].triggerValue > fv[i]) {
-                configs[i].timePastThreshold += params->delta_time;
+            if (config.triggerValue > value) {
+                config.timePastThreshold += params->delta_time;
                 // If this threshold has been quiet long enough, un-trigger it.
-                if (configs[i].timePastThreshold > configs[i].silenceTime) {
-                    configs[i].triggered = false;
-                    configs[i].timePastThreshold = 0.f;
+                if (config.timePastThreshold > config.silenceTime) {
+                    config.triggered = false;
+                    config.timePastThreshold = 0.f;
 
                     bool pushValues[] = { false };
                     params->push_patterns->Push(triggeredPinOut, pushValues, 1);
                 }
             } else {
                 // Went back into triggered state, reset time past threshold.
-                configs[i].timePastThreshold = 0.f;
+                config.timePastThreshold = 0.f;
             }
         } else {
             // When not triggered and the current value exceeds the trigger, accumulate sustain time.
-            if (configs[i].triggerValue <= fv[i]) {
-                configs[i].timePastThreshold += params->delta_time;
+            if (config.triggerValue <= value) {
+                config.timePastThreshold += params->delta_time;
 
                 // If this threshold has been exceeded for long enough, trigger it.
-                if (configs[i].timePastThreshold > configs[i].sustainTime) {
-                    configs[i].triggered = true;
-                    configs[i].timePastThreshold = 0.f;
+                if (config.timePastThreshold > config.sustainTime) {
+                    config.triggered = true;
+                    config.timePastThreshold = 0.f;
 
                     bool pushValues[] = { true };
                     params->push_patterns->Push(triggeredPinOut, pushValues, 1);
@@ -60,7 +60,7 @@ void Threshold::Update(UpdateParams* params) {
                 }
             } else {
                 // Dipped below the trigger threshold, reset sustain time.
-                configs[i].timePastThreshold = 0.f;
+                config.timePastThreshold = 0.f;
             }
         }
     }
@@ -121,12 +121,11 @@ void Threshold::OnSizeChanged(VectorPinInput* changed) {
 
         pinOutEvents[i].SetChildren(std::move(children));
     }
+    PinsChanged();
 }
 
 void Threshold::GuiDrawNodeCenter() {
-    size_t size;
-    ThresholdConfig* configs = thresholds.Get<ThresholdConfig>(size);
-
+    const size_t size = thresholds.Size();
     for (size_t i = 0; i < size; i++) {
         if (i > 0 && i % 4 == 0) {
             ImGui::NewLine();
@@ -134,7 +133,7 @@ void Threshold::GuiDrawNodeCenter() {
             ImGui::SameLine();
         }
 
-        ImVec4 col = configs[i].triggered ? ImVec4(1.0, 0.0, 1.0, 1.0) : ImVec4(0.1f, 0.1f, 0.1f, 1.f);
+        ImVec4 col = thresholds.Get<ThresholdConfig>(i).triggered ? ImVec4(1.0, 0.0, 1.0, 1.0) : ImVec4(0.1f, 0.1f, 0.1f, 1.f);
         ImGui::TextColored(col, "o");
     }
 }
@@ -147,26 +146,19 @@ bool Threshold::GuiDrawPropertiesList(UpdateParams* params) {
     bool changed = triggerChanged || sustainChanged || silenceChanged;
 
     if (changed) {
-        size_t thresholdsSize;
-        ThresholdConfig* configs = thresholds.Get<ThresholdConfig>(thresholdsSize);
-
-        if (triggerChanged) {
-            for (size_t i = 0; i < thresholdsSize; i++) {
-                configs[i].triggerValue = defaultConfig.triggerValue;
-            }
-        }
-
-        if (sustainChanged) {
-            for (size_t i = 0; i < thresholdsSize; i++) {
-                configs[i].sustainTime = defaultConfig.sustainTime;
-            }
-        }
-
-        if (silenceChanged) {
-            for (size_t i = 0; i < thresholdsSize; i++) {
-                configs[i].silenceTime = defaultConfig.silenceTime;
+        thresholds.ForEachRun<ThresholdConfig>([&](ThresholdConfig* configs, size_t count) {
+            for (size_t i = 0; i < count; i++) {
+                if (triggerChanged) {
+                    configs[i].triggerValue = defaultConfig.triggerValue;
+                }
+                if (sustainChanged) {
+                    configs[i].sustainTime = defaultConfig.sustainTime;
+                }
+                if (silenceChanged) {
+                    configs[i].silenceTime = defaultConfig.silenceTime;
+                }
             }
-        }
+        });
     }
 
     ImGui::NewLine();
@@ -8,6 +8,8 @@ namespace seam::nodes {
     /// @brief Fires events when an input line exceeds some threshold for an amount of time.
     class Threshold : public INode {
     public:
+        static constexpr NodeMetadata metadata = NodeMetadata("Threshold", { PinType::Struct, PinType::Float }, { PinType::Struct });
+
         Threshold();
 
         void Update(UpdateParams* params) override;
@@ -3,7 +3,7 @@
 using namespace seam;
 using namespace seam::nodes;
 
-Timer::Timer() : INode("Timer") {
+Timer::Timer() : INode(metadata) {
 	// TODO you may want to instead update every frame;
 	// I could see this causing some weirdness later on...
 	flags = (NodeFlags)(flags | NodeFlags::UpdatesOverTime);
@@ -10,6 +10,8 @@ namespace seam::nodes {
 	/// Can also be paused.
 	class Timer : public INode {
 	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("Timer", { PinType::Float, PinType::Flow }, { PinType::Float });
+
 		Timer();
 		~Timer();
 
@@ -3,7 +3,7 @@
 using namespace seam::nodes;
 using namespace seam::pins;
 
-Toggle::Toggle() : INode("Toggle") {
+Toggle::Toggle() : INode(metadata) {
 }
 
 void Toggle::Setup(SetupParams* params) {
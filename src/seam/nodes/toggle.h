@@ -10,6 +10,8 @@ namespace seam::nodes {
 	/// For now output just ranges from [0..statesCount], but ideally should allow user-defined mappings as well.
 	class Toggle : public INode {
 	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("Toggle", { PinType::Flow }, { PinType::Uint });
+
 		Toggle();
 
 		void Setup(SetupParams* params) override;
@@ -5,7 +5,7 @@
 using namespace seam;
 using namespace seam::nodes;
 
-ValueNoise::ValueNoise() : INode("Value Noise") {
+ValueNoise::ValueNoise() : INode(metadata) {
 	flags = (NodeFlags)(flags | NodeFlags::IsVisual);
 	gui_display_fbo = &fbo;
 }
@@ -10,6 +10,8 @@ namespace seam::nodes {
 	/// using inigo quilez's method described here: http://iquilezles.org/articles/morenoise/
 	class ValueNoise : public INode {
 	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("Value Noise", { PinType::Struct }, { PinType::FboRgba });
+
 		ValueNoise();
 
 		void Setup(SetupParams* params) override;
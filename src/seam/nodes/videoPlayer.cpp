@@ -4,7 +4,7 @@
 using namespace seam::nodes;
 using namespace seam::pins;
 
-VideoPlayer::VideoPlayer() : INode("Video Player") {
+VideoPlayer::VideoPlayer() : INode(metadata) {
 	flags = (NodeFlags)(flags | NodeFlags::IsVisual | NodeFlags::UpdatesOverTime);
     gui_display_fbo = &fbo;
 	windowFbos.push_back(WindowRatioFbo(&fbo, &pinOutFbo));
@@ -10,6 +10,8 @@ namespace seam::nodes {
     /// TODO pass around the video texture instead of rendering to an FBO
 	class VideoPlayer : public INode {
 	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("Video Player", { PinType::Float }, { PinType::FboRgba16F });
+
 		VideoPlayer();
 		~VideoPlayer();
         
@@ -0,0 +1,414 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "seam/pins/convertKernels.h"
+#include "seam/pins/pinInput.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SEAM_CONVERT_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang only emit instructions for the ISA a function is tagged with;
+// MSVC emits any intrinsic it's given, so the tags are left out there.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define SEAM_TARGET(isa)
+#else
+#define SEAM_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+using namespace seam::pins;
+
+namespace {
+    /// @brief C++ types of the basic pin types, in PinType order starting at PinType::Bool.
+    using BasicTypes = std::tuple<bool, char, int32_t, uint32_t, float>;
+    constexpr size_t NUM_BASIC_TYPES = std::tuple_size_v<BasicTypes>;
+
+    inline size_t BasicIndex(PinType type) {
+        return (size_t)type - (size_t)PinType::Bool;
+    }
+
+    template <typename T>
+    constexpr bool IS_BYTE = sizeof(T) == 1;
+
+    /// @brief Int and Uint share their bits, so converting between them is a copy.
+    template <typename SrcT, typename DstT>
+    constexpr bool IS_COPY = std::is_same_v<SrcT, DstT>
+        || (sizeof(SrcT) == 4 && sizeof(DstT) == 4 && std::is_integral_v<SrcT> && std::is_integral_v<DstT>);
+
+    /// @brief Conversions which go through unsigned 32 bit lanes in the batch kernels.
+    template <typename T>
+    constexpr bool IS_UNSIGNED_LANE = std::is_same_v<T, uint32_t> || (std::is_same_v<T, char> && !std::is_signed_v<char>);
+
+    template <typename SrcT, typename DstT>
+    void ConvertSingleKernel(ConvertSingleArgs args) {
+        const SrcT* src = (const SrcT*)args.src;
+        DstT* dst = (DstT*)args.dst;
+        const uint16_t numCoords = std::min(args.srcNumCoords, args.dstNumCoords);
+        for (uint16_t i = 0; i < numCoords; i++) {
+            dst[i] = src[i];
+        }
+    }
+
+    template <typename SrcT, typename DstT>
+    void BatchScalar(const SrcT* src, DstT* dst, size_t count) {
+        if constexpr (IS_COPY<SrcT, DstT>) {
+            std::memcpy(dst, src, count * sizeof(SrcT));
+        } else {
+            for (size_t i = 0; i < count; i++) {
+                dst[i] = src[i];
+            }
+        }
+    }
+
+    struct Scalar {
+        template <typename SrcT, typename DstT>
+        static void Batch(const SrcT* src, DstT* dst, size_t count) {
+            BatchScalar(src, dst, count);
+        }
+    };
+
+#if SEAM_CONVERT_X86
+    // Both x86 kernels widen every element to a 32 bit lane, convert between float and integer lanes,
+    // and then narrow the lanes back down to the destination type.
+
+    template <typename SrcT>
+    SEAM_TARGET("avx2") inline __m256i LoadLanesAvx2(const SrcT* src) {
+        if constexpr (IS_BYTE<SrcT>) {
+            const __m128i bytes = _mm_loadl_epi64((const __m128i*)src);
+            if constexpr (std::is_signed_v<SrcT>) {
+                return _mm256_cvtepi8_epi32(bytes);
+            } else {
+                return _mm256_cvtepu8_epi32(bytes);
+            }
+        } else {
+            return _mm256_loadu_si256((const __m256i*)src);
+        }
+    }
+
+    template <typename DstT>
+    SEAM_TARGET("avx2") inline void StoreLanesAvx2(__m256i lanes, DstT* dst) {
+        if constexpr (IS_BYTE<DstT>) {
+            // Gather the low byte of each lane into the low dword of each 128 bit half, then join the halves.
+            const __m256i lowBytes = _mm256_setr_epi8(
+                0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+            const __m256i packed = _mm256_permutevar8x32_epi32(
+                _mm256_shuffle_epi8(lanes, lowBytes), _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0));
+            _mm_storel_epi64((__m128i*)dst, _mm256_castsi256_si128(packed));
+        } else {
+            _mm256_storeu_si256((__m256i*)dst, lanes);
+        }
+    }
+
+    template <typename SrcT>
+    SEAM_TARGET("avx2") inline __m256 LanesToFloatAvx2(__m256i lanes) {
+        if constexpr (IS_UNSIGNED_LANE<SrcT>) {
+            // No unsigned convert before AVX-512; convert each 16 bit half exactly and round once when adding.
+            const __m256 hi = _mm256_cvtepi32_ps(_mm256_srli_epi32(lanes, 16));
+            const __m256 lo = _mm256_cvtepi32_ps(_mm256_and_si256(lanes, _mm256_set1_epi32(0xFFFF)));
+            return _mm256_add_ps(_mm256_mul_ps(hi, _mm256_set1_ps(65536.f)), lo);
+        } else {
+            return _mm256_cvtepi32_ps(lanes);
+        }
+    }
+
+    template <typename DstT>
+    SEAM_TARGET("avx2") inline __m256i FloatToLanesAvx2(__m256 f) {
+        if constexpr (IS_UNSIGNED_LANE<DstT>) {
+            // Values past INT_MAX are shifted down into range, truncated, and have their top bit put back.
+            const __m256 twoPow31 = _mm256_set1_ps(2147483648.f);
+            const __m256 big = _mm256_cmp_ps(f, twoPow31, _CMP_GE_OQ);
+            const __m256i truncated = _mm256_cvttps_epi32(_mm256_sub_ps(f, _mm256_and_ps(big, twoPow31)));
+            return _mm256_xor_si256(truncated, _mm256_slli_epi32(_mm256_castps_si256(big), 31));
+        } else {
+            return _mm256_cvttps_epi32(f);
+        }
+    }
+
+    struct Avx2 {
+        template <typename SrcT, typename DstT>
+        SEAM_TARGET("avx2") static void Batch(const SrcT* src, DstT* dst, size_t count) {
+            constexpr size_t LANES = 8;
+            size_t i = 0;
+            if constexpr (!IS_COPY<SrcT, DstT>) {
+                const __m256i one = _mm256_set1_epi32(1);
+                for (; i + LANES <= count; i += LANES) {
+                    if constexpr (std::is_same_v<SrcT, float>) {
+                        const __m256 f = _mm256_loadu_ps(src + i);
+                        if constexpr (std::is_same_v<DstT, bool>) {
+                            // Not-equal is unordered, so NaN is true like it is for scalar conversions.
+                            const __m256i nonZero = _mm256_castps_si256(_mm256_cmp_ps(f, _mm256_setzero_ps(), _CMP_NEQ_UQ));
+                            StoreLanesAvx2(_mm256_and_si256(nonZero, one), dst + i);
+                        } else {
+                            StoreLanesAvx2(FloatToLanesAvx2<DstT>(f), dst + i);
+                        }
+                    } else {
+                        const __m256i lanes = LoadLanesAvx2(src + i);
+                        if constexpr (std::is_same_v<DstT, float>) {
+                            _mm256_storeu_ps(dst + i, LanesToFloatAvx2<SrcT>(lanes));
+                        } else if constexpr (std::is_same_v<DstT, bool>) {
+                            const __m256i zero = _mm256_cmpeq_epi32(lanes, _mm256_setzero_si256());
+                            StoreLanesAvx2(_mm256_andnot_si256(zero, one), dst + i);
+                        } else {
+                            StoreLanesAvx2(lanes, dst + i);
+                        }
+                    }
+                }
+            }
+            BatchScalar(src + i, dst + i, count - i);
+        }
+    };
+
+    template <typename SrcT>
+    SEAM_TARGET("sse4.1") inline __m128i LoadLanesSse41(const SrcT* src) {
+        if constexpr (IS_BYTE<SrcT>) {
+            int32_t word;
+            std::memcpy(&word, src, sizeof(word));
+            const __m128i bytes = _mm_cvtsi32_si128(word);
+            if constexpr (std::is_signed_v<SrcT>) {
+                return _mm_cvtepi8_epi32(bytes);
+            } else {
+                return _mm_cvtepu8_epi32(bytes);
+            }
+        } else {
+            return _mm_loadu_si128((const __m128i*)src);
+        }
+    }
+
+    template <typename DstT>
+    SEAM_TARGET("sse4.1") inline void StoreLanesSse41(__m128i lanes, DstT* dst) {
+        if constexpr (IS_BYTE<DstT>) {
+            const __m128i lowBytes = _mm_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+            const int32_t word = _mm_cvtsi128_si32(_mm_shuffle_epi8(lanes, lowBytes));
+            std::memcpy(dst, &word, sizeof(word));
+        } else {
+            _mm_storeu_si128((__m128i*)dst, lanes);
+        }
+    }
+
+    template <typename SrcT>
+    SEAM_TARGET("sse4.1") inline __m128 LanesToFloatSse41(__m128i lanes) {
+        if constexpr (IS_UNSIGNED_LANE<SrcT>) {
+            const __m128 hi = _mm_cvtepi32_ps(_mm_srli_epi32(lanes, 16));
+            const __m128 lo = _mm_cvtepi32_ps(_mm_and_si128(lanes, _mm_set1_epi32(0xFFFF)));
+            return _mm_add_ps(_mm_mul_ps(hi, _mm_set1_ps(65536.f)), lo);
+        } else {
+            return _mm_cvtepi32_ps(lanes);
+        }
+    }
+
+    template <typename DstT>
+    SEAM_TARGET("sse4.1") inline __m128i FloatToLanesSse41(__m128 f) {
+        if constexpr (IS_UNSIGNED_LANE<DstT>) {
+            const __m128 twoPow31 = _mm_set1_ps(2147483648.f);
+            const __m128 big = _mm_cmpge_ps(f, twoPow31);
+            const __m128i truncated = _mm_cvttps_epi32(_mm_sub_ps(f, _mm_and_ps(big, twoPow31)));
+            return _mm_xor_si128(truncated, _mm_slli_epi32(_mm_castps_si128(big), 31));
+        } else {
+            return _mm_cvttps_epi32(f);
+        }
+    }
+
+    struct Sse41 {
+        template <typename SrcT, typename DstT>
+        SEAM_TARGET("sse4.1") static void Batch(const SrcT* src, DstT* dst, size_t count) {
+            constexpr size_t LANES = 4;
+            size_t i = 0;
+            if constexpr (!IS_COPY<SrcT, DstT>) {
+                const __m128i one = _mm_set1_epi32(1);
+                for (; i + LANES <= count; i += LANES) {
+                    if constexpr (std::is_same_v<SrcT, float>) {
+                        const __m128 f = _mm_loadu_ps(src + i);
+                        if constexpr (std::is_same_v<DstT, bool>) {
+                            const __m128i nonZero = _mm_castps_si128(_mm_cmpneq_ps(f, _mm_setzero_ps()));
+                            StoreLanesSse41(_mm_and_si128(nonZero, one), dst + i);
+                        } else {
+                            StoreLanesSse41(FloatToLanesSse41<DstT>(f), dst + i);
+                        }
+                    } else {
+                        const __m128i lanes = LoadLanesSse41(src + i);
+                        if constexpr (std::is_same_v<DstT, float>) {
+                            _mm_storeu_ps(dst + i, LanesToFloatSse41<SrcT>(lanes));
+                        } else if constexpr (std::is_same_v<DstT, bool>) {
+                            const __m128i zero = _mm_cmpeq_epi32(lanes, _mm_setzero_si128());
+                            StoreLanesSse41(_mm_andnot_si128(zero, one), dst + i);
+                        } else {
+                            StoreLanesSse41(lanes, dst + i);
+                        }
+                    }
+                }
+            }
+            BatchScalar(src + i, dst + i, count - i);
+        }
+    };
+#endif
+
+    /// @brief Number of input elements from args.dstFirst to the end of the input's buffer.
+    inline size_t DstElementsLeft(const ConvertMultiArgs& args, size_t dstElements) {
+        return args.dstFirst < dstElements ? dstElements - args.dstFirst : 0;
+    }
+
+    /// @brief The destination is a flat array with as many coords per element as the source,
+    /// so every coord of the push can be converted in a single batch.
+    template <typename SrcT, typename DstT, typename Isa>
+    void ConvertContiguous(ConvertMultiArgs args) {
+        assert(args.srcNumCoords == args.pinIn->NumCoords());
+        size_t dstElements;
+        size_t dstStride;
+        DstT* dst = (DstT*)args.DstBuffer(dstElements, dstStride) + args.dstFirst * args.srcNumCoords;
+        const size_t count = std::min(args.srcSize, DstElementsLeft(args, dstElements)) * args.srcNumCoords;
+        Isa::template Batch<SrcT, DstT>((const SrcT*)args.src, dst, count);
+    }
+
+    template <typename SrcT, typename DstT>
+    void ConvertStrided(ConvertMultiArgs args) {
+        size_t dstElements;
+        size_t dstStride;
+        char* dst = args.DstBuffer(dstElements, dstStride) + args.dstFirst * dstStride;
+        const uint16_t numCoords = std::min(args.srcNumCoords, args.pinIn->NumCoords());
+        const size_t count = std::min(args.srcSize, DstElementsLeft(args, dstElements));
+
+        const SrcT* src = (const SrcT*)args.src;
+        for (size_t i = 0; i < count; i++, src += args.srcNumCoords, dst += dstStride) {
+            BatchScalar(src, (DstT*)dst, numCoords);
+        }
+    }
+
+    template <size_t I>
+    using BasicType = std::tuple_element_t<I, BasicTypes>;
+
+    /// @brief Tables are indexed by [src basic index * NUM_BASIC_TYPES + dst basic index].
+    template <size_t... I>
+    constexpr std::array<ConvertSingle, sizeof...(I)> MakeSingleTable(std::index_sequence<I...>) {
+        return { &ConvertSingleKernel<BasicType<I / NUM_BASIC_TYPES>, BasicType<I % NUM_BASIC_TYPES>>... };
+    }
+
+    template <typename Isa, size_t... I>
+    constexpr std::array<ConvertMulti, sizeof...(I)> MakeContiguousTable(std::index_sequence<I...>) {
+        return { &ConvertContiguous<BasicType<I / NUM_BASIC_TYPES>, BasicType<I % NUM_BASIC_TYPES>, Isa>... };
+    }
+
+    template <size_t... I>
+    constexpr std::array<ConvertMulti, sizeof...(I)> MakeStridedTable(std::index_sequence<I...>) {
+        return { &ConvertStrided<BasicType<I / NUM_BASIC_TYPES>, BasicType<I % NUM_BASIC_TYPES>>... };
+    }
+
+    using TableIndices = std::make_index_sequence<NUM_BASIC_TYPES * NUM_BASIC_TYPES>;
+
+    constexpr auto SINGLE_TABLE = MakeSingleTable(TableIndices());
+    constexpr auto STRIDED_TABLE = MakeStridedTable(TableIndices());
+    constexpr auto SCALAR_TABLE = MakeContiguousTable<Scalar>(TableIndices());
+#if SEAM_CONVERT_X86
+    constexpr auto SSE41_TABLE = MakeContiguousTable<Sse41>(TableIndices());
+    constexpr auto AVX2_TABLE = MakeContiguousTable<Avx2>(TableIndices());
+#endif
+
+    ConvertSimd DetectConvertSimd() {
+#if SEAM_CONVERT_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 0);
+        const int maxLeaf = info[0];
+        __cpuid(info, 1);
+        const bool sse41 = (info[2] & (1 << 19)) != 0;
+        // AVX registers also need to be saved by the OS.
+        const bool osAvx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0
+            && (_xgetbv(0) & 0x6) == 0x6;
+        bool avx2 = false;
+        if (maxLeaf >= 7 && osAvx) {
+            __cpuidex(info, 7, 0);
+            avx2 = (info[1] & (1 << 5)) != 0;
+        }
+#else
+        __builtin_cpu_init();
+        const bool sse41 = __builtin_cpu_supports("sse4.1");
+        const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+        if (avx2) {
+            return ConvertSimd::Avx2;
+        } else if (sse41) {
+            return ConvertSimd::Sse41;
+        }
+        return ConvertSimd::Scalar;
+#else
+        // Other CPUs, ARM included, use the scalar kernels.
+        return ConvertSimd::Scalar;
+#endif
+    }
+
+    ConvertSimd DetectedSimd() {
+        static const ConvertSimd detected = DetectConvertSimd();
+        return detected;
+    }
+
+    std::atomic<ConvertSimd> currentSimd = ConvertSimd(0xFF);
+}
+
+namespace seam::pins {
+    ConvertSimd GetConvertSimd() {
+        ConvertSimd simd = currentSimd.load(std::memory_order_relaxed);
+        if (simd == ConvertSimd(0xFF)) {
+            simd = DetectedSimd();
+            currentSimd.store(simd, std::memory_order_relaxed);
+        }
+        return simd;
+    }
+
+    bool IsConvertSimdSupported(ConvertSimd simd) {
+        const ConvertSimd detected = DetectedSimd();
+        switch (simd) {
+        case ConvertSimd::Scalar:
+            return true;
+        case ConvertSimd::Sse41:
+            return detected == ConvertSimd::Sse41 || detected == ConvertSimd::Avx2;
+        default:
+            return simd == detected;
+        }
+    }
+
+    ConvertSimd SetConvertSimd(ConvertSimd simd) {
+        if (!IsConvertSimdSupported(simd)) {
+            simd = ConvertSimd::Scalar;
+        }
+        currentSimd.store(simd, std::memory_order_relaxed);
+        return simd;
+    }
+
+    bool IsBasicConvertType(PinType type) {
+        return type >= PinType::Bool && type <= PinType::Float;
+    }
+
+    ConvertSingle GetBasicConvertSingle(PinType srcType, PinType dstType) {
+        assert(IsBasicConvertType(srcType) && IsBasicConvertType(dstType));
+        return SINGLE_TABLE[BasicIndex(srcType) * NUM_BASIC_TYPES + BasicIndex(dstType)];
+    }
+
+    ConvertMulti GetBasicConvertMulti(PinType srcType, PinType dstType, bool contiguous) {
+        assert(IsBasicConvertType(srcType) && IsBasicConvertType(dstType));
+        const size_t index = BasicIndex(srcType) * NUM_BASIC_TYPES + BasicIndex(dstType);
+        if (!contiguous) {
+            return STRIDED_TABLE[index];
+        }
+
+        switch (GetConvertSimd()) {
+#if SEAM_CONVERT_X86
+        case ConvertSimd::Avx2:
+            return AVX2_TABLE[index];
+        case ConvertSimd::Sse41:
+            return SSE41_TABLE[index];
+#endif
+        default:
+            return SCALAR_TABLE[index];
+        }
+    }
+}
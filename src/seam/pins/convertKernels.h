@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+
+#include "seam/pins/pinTypes.h"
+#include "seam/pins/pinConnection.h"
+
+namespace seam::pins {
+    /// @brief Instruction sets the batch conversion kernels can use.
+    /// The best one the CPU supports is picked the first time a converter is requested.
+    enum class ConvertSimd : uint8_t {
+        Scalar,
+        Sse41,
+        Avx2
+    };
+
+    /// @return The instruction set used by converters which are created from now on.
+    ConvertSimd GetConvertSimd();
+
+    /// @brief Pick the instruction set used by converters which are created from now on,
+    /// for instance to compare the SIMD kernels against the scalar ones.
+    /// Connections which already exist keep their converters until they're re-cached.
+    /// @return The instruction set actually picked; unsupported instruction sets fall back to Scalar.
+    ConvertSimd SetConvertSimd(ConvertSimd simd);
+
+    /// @return true if the CPU running this process supports the instruction set.
+    bool IsConvertSimdSupported(ConvertSimd simd);
+
+    /// @brief Is true for the basic types which have generated converters between each other:
+    /// Bool, Char, Int, Uint and Float.
+    bool IsBasicConvertType(PinType type);
+
+    /// @brief Get the generated single element converter between two basic types.
+    ConvertSingle GetBasicConvertSingle(PinType srcType, PinType dstType);
+
+    /// @brief Get the generated multi element converter between two basic types.
+    /// @param contiguous true if the destination is a flat array with the same number of coords as the source,
+    /// in which case the current ConvertSimd's batch kernel converts the whole push in one go.
+    ConvertMulti GetBasicConvertMulti(PinType srcType, PinType dstType, bool contiguous);
+}
@@ -29,10 +29,10 @@ void IInPinnable::RecacheInputConnections() {
 
 void IInPinnable::RecacheInputConnections(PinInput* pins, size_t size) {
     for (size_t i = 0; i < size; i++) {
-		// If the Input pin is connected, re-cache the PinOutput's pointer to the PinInput.
-		if (pins[i].connection != nullptr) {
+		// If the Input pin is connected, re-cache each PinOutput's pointer to the PinInput.
+		for (PinOutput* pinOut : pins[i].connections) {
 			// Find the input pin in the Output pin's connections
-			std::vector<pins::PinConnection>& connections = pins[i].connection->connections;
+			std::vector<pins::PinConnection>& connections = pinOut->connections;
 			for (size_t j = 0; j < connections.size(); j++) {
 				if (connections[j].inputPinId == pins[i].id) {
 					connections[j].pinIn = &pins[i];
@@ -41,6 +41,11 @@ void IInPinnable::RecacheInputConnections(PinInput* pins, size_t size) {
 			}
 		}
 
+		// Staged pushes are replayed into the pin, so they need to follow it too.
+		if (pins[i].staged != nullptr) {
+			pins[i].staged->SetPin(&pins[i]);
+		}
+
 		// Recurse for child hierarchies
 		size_t childrenSize;
 		PinInput* children = pins[i].PinInputs(childrenSize);
@@ -16,7 +16,7 @@ namespace seam::pins {
 
         /// @brief When the buffer for dynamically alloc'd pin inputs changes, this function needs to be called,
 		/// so that any Connections can re-cache each pointer to the PinInput
-		void RecacheInputConnections();
+		virtual void RecacheInputConnections();
 
     private:
 		void RecacheInputConnections(PinInput* inputs, size_t size);
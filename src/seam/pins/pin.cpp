@@ -1,8 +1,8 @@
 #include "seam/pins/pin.h"
 
-const size_t seam::pins::PinInput::MAX_EVENTS = 16;
+namespace seam::pins {
+	DefineFlagOperators(PinFlags, uint16_t);
 
-namespace {
 	bool StrCmpLower(std::string_view s1, std::string_view s2) {
 		if (s1.length() != s2.length()) {
 			return false;
@@ -14,10 +14,6 @@ namespace {
 		}
 		return same;
 	}
-}
-
-namespace seam::pins {
-	DefineFlagOperators(PinFlags, uint16_t);
 
 	props::NodePropertyType PinTypeToPropType(PinType pinType) {
 		using namespace seam::props;
@@ -311,7 +307,7 @@ namespace seam::pins {
 		size_t elementSize = options.elementSize > 0 
 			? options.elementSize : PinTypeToElementSize(pinType);
 
-		return PinInput(
+		PinInput pinIn(
 			pinType,
 			name,
 			options.description,
@@ -326,6 +322,8 @@ namespace seam::pins {
 			std::move(options.onValueChanging),
 			options.pinMetadata
 		);
+		pinIn.SetReducer(options.reducer);
+		return pinIn;
 	}
 
 	PinInput SetupInputFboPin(
@@ -388,7 +386,8 @@ namespace seam::pins {
 		const std::string_view name,
 		size_t elementSizeInBytes,
 		void* pinMetadata,
-		const std::string_view description
+		const std::string_view description,
+		size_t maxEvents
 	) {
 		// TODO: Validate inputs in debug mode...?
 
@@ -396,7 +395,7 @@ namespace seam::pins {
 			elementSizeInBytes = PinTypeToElementSize(pinType);
 		}
 
-		return PinInput(pinType, name, description, node, elementSizeInBytes, pinMetadata);
+		return PinInput(pinType, name, description, node, elementSizeInBytes, pinMetadata, maxEvents);
 	}
 
 	PinInput SetupVec2InputPin(
@@ -504,4 +503,37 @@ namespace seam::pins {
 		PinOutput* pins = pinnable->PinOutputs(size);
 		return FindPinOutByName(pins, size, name);
 	}
+	void AddPinMemory(IInPinnable* pinnable, PinMemoryStats& stats) {
+		size_t size;
+		PinInput* pins = pinnable->PinInputs(size);
+		for (size_t i = 0; i < size; i++) {
+			PinInput& pin = pins[i];
+			stats.inputPins += 1;
+			stats.pinBytes += sizeof(PinInput);
+			stats.metadataHeapBytes += pin.MetadataHeapBytes();
+			stats.callbackPins += pin.HasCallbacks() ? 1 : 0;
+			stats.droppedEvents += pin.DroppedEvents();
+
+			size_t childrenSize;
+			pin.PinInputs(childrenSize);
+			if (childrenSize == 0) {
+				stats.bufferBytes += pin.BufferSize();
+			} else {
+				AddPinMemory(&pin, stats);
+			}
+		}
+	}
+
+	void AddPinMemory(IOutPinnable* pinnable, PinMemoryStats& stats) {
+		size_t size;
+		PinOutput* pins = pinnable->PinOutputs(size);
+		for (size_t i = 0; i < size; i++) {
+			PinOutput& pin = pins[i];
+			stats.outputPins += 1;
+			stats.pinBytes += sizeof(PinOutput);
+			stats.metadataHeapBytes += pin.MetadataHeapBytes();
+			stats.callbackPins += pin.HasCallbacks() ? 1 : 0;
+			AddPinMemory(&pin, stats);
+		}
+	}
 }
\ No newline at end of file
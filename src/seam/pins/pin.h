@@ -91,13 +91,16 @@ namespace seam {
 			PinInOptions&& options = PinInOptions()
 		);
 
+		/// @param maxEvents If non-zero, events pushed while this many are waiting for the Node are dropped;
+		/// otherwise the queue grows to fit.
 		PinInput SetupInputQueuePin(
 			PinType pinType,
 			nodes::INode* node,
 			const std::string_view name = "Input Queue",
 			size_t elementSizeInBytes = 0,
 			void* pinMetadata = nullptr,
-			const std::string_view description = ""
+			const std::string_view description = "",
+			size_t maxEvents = 0
 		);
 
 		PinInput SetupInputFlowPin(
@@ -130,6 +133,9 @@ namespace seam {
 			void* userp = nullptr
 		);
 		
+		/// @return true if the strings are equal, ignoring case. Pin names are compared this way.
+		bool StrCmpLower(std::string_view s1, std::string_view s2);
+
 		PinInput* FindPinInByName(PinInput* pins, size_t pinsSize, std::string_view name);
 
 		PinInput* FindPinInByName(IInPinnable* pinnable, std::string_view name);
@@ -138,6 +144,33 @@ namespace seam {
 		
 		PinOutput* FindPinOutByName(IOutPinnable* pinnable, std::string_view name);
 
+		/// @brief Memory taken up by pins, to compare against the data they point to.
+		struct PinMemoryStats {
+			size_t inputPins = 0;
+			size_t outputPins = 0;
+			/// @brief The pins themselves.
+			size_t pinBytes = 0;
+			/// @brief Names, extras, connections, reducer state, event queues and unused child pin capacity on the heap.
+			size_t metadataHeapBytes = 0;
+			/// @brief Pins with a callback set. Callbacks are std::functions,
+			/// and whatever they allocate for their captures isn't part of metadataHeapBytes.
+			size_t callbackPins = 0;
+			/// @brief Events dropped by input queues with a maximum.
+			uint64_t droppedEvents = 0;
+			/// @brief The values input pins point to.
+			size_t bufferBytes = 0;
+
+			inline size_t MetadataBytes() {
+				return pinBytes + metadataHeapBytes;
+			}
+		};
+
+		/// @brief Add the memory used by the pins and their children to stats.
+		/// Pins held directly by the pinnable are counted by size, since the pinnable stores them.
+		void AddPinMemory(IInPinnable* pinnable, PinMemoryStats& stats);
+
+		void AddPinMemory(IOutPinnable* pinnable, PinMemoryStats& stats);
+
 		PinInput SetupVec2InputPin(
 			nodes::INode* node,
 			glm::vec2& v,
@@ -4,6 +4,7 @@
 #include <functional>
 
 #include "seam/pins/pinTypes.h"
+#include "seam/containers/internedString.h"
 #include "seam/flagsHelper.h"
 #include "seam/idsDistributor.h"
 #include "seam/properties/nodePropertyType.h"
@@ -53,6 +54,13 @@ namespace seam::pins {
         /// @brief Valid for Input pins only; means Pin channels are resizable,
         /// and the void* backing the Pin points to a vector<T>
         Vector = 1 << 4,
+
+        /// @brief Lets Push() skip copying between pins of the same type and layout;
+        /// only takes effect when both ends of a connection raise it.
+        /// On an output pin, promises pushed data stays valid and unchanged until the pin's next push.
+        /// On an input pin, promises the Node reads the pin's values through PinInput::ReadBuffer(),
+        /// rather than through the memory it set the pin up with.
+        Aliasable = 1 << 5,
     };
 
     DeclareFlagOperators(PinFlags, uint16_t);
@@ -65,30 +73,32 @@ namespace seam::pins {
     };
 
     // base struct for pin types, holds metadata about the pin
+    // Large graphs have tens of thousands of pins, so keep members ordered to avoid padding,
+    // and keep anything most pins don't use out of line.
     struct Pin {
         PinId id;
 
-        PinType type;
-
-        // TODO make name and description string-view-ifiable again somehow
-
-        // human-readable Pin name for display purposes
+        // human-readable Pin name for display purposes.
+        // Stays a std::string since the GUI renames pins in place; short names don't allocate.
         std::string name;
-        // human-readable Pin description for display purposes
-        std::string description;
+        // human-readable Pin description for display purposes.
+        // Descriptions are repeated across many pins and never edited, so they're interned.
+        InternedString description;
 
         // Pins keep track of the node they are associated with;
         // is expected to have a valid pointer value
         nodes::INode* node = nullptr;
 
-        PinFlags flags = (PinFlags)0;
-
         /// @brief Don't touch! For seam internal usage.
         void* seamp = nullptr;
 
         /// @brief Unused pointer for user data, if any is needed.
         void* userp = nullptr;
 
+        PinType type;
+
+        PinFlags flags = (PinFlags)0;
+
         virtual ~Pin() { }
 
         Pin() {
@@ -96,6 +106,13 @@ namespace seam::pins {
         }
     };
 
+    /// @return Bytes a std::string allocated on the heap; short strings are stored inline and allocate nothing.
+    inline size_t StringHeapBytes(const std::string& str) {
+        const uintptr_t data = (uintptr_t)str.data();
+        const uintptr_t self = (uintptr_t)&str;
+        return data >= self && data < self + sizeof(std::string) ? 0 : str.capacity() + 1;
+    }
+
     props::NodePropertyType PinTypeToPropType(PinType pinType);
     size_t PinTypeToElementSize(PinType type);
 }
\ No newline at end of file
@@ -1,18 +1,67 @@
 #if RUN_DOCTEST
 #include "doctest.h"
+#include <thread>
 #endif
  
 #include "seam/pins/pinConnection.h"
+#include "seam/pins/convertKernels.h"
 #include "seam/pins/pinInput.h"
 #include "seam/pins/pin.h"
+#include "seam/pins/typedPin.h"
 
 namespace {
-    template <typename SrcT, typename DstT>
-    void Convert(seam::pins::ConvertSingleArgs args) {
-        for (uint16_t i = 0; i < args.srcNumCoords && i < args.dstNumCoords; i++) {
-            *((DstT*)args.dst + i) = *((SrcT*)args.src + i);
+    using namespace seam::pins;
+
+    /// @brief Note event and FBO pins push pointers, which are copied rather than converted.
+    bool IsPointerType(PinType type) {
+        return type == PinType::NoteEvent || IsFboPin(type);
+    }
+
+    void CopyPointersSingle(ConvertSingleArgs args) {
+        const uint16_t numCoords = std::min(args.srcNumCoords, args.dstNumCoords);
+        std::copy((void**)args.src, (void**)args.src + numCoords, (void**)args.dst);
+    }
+
+    void CopyPointersMulti(ConvertMultiArgs args) {
+        size_t dstElements;
+        size_t dstStride;
+        char* dst = args.DstBuffer(dstElements, dstStride) + args.dstFirst * dstStride;
+        const uint16_t numCoords = std::min(args.srcNumCoords, args.pinIn->NumCoords());
+        const size_t count = args.dstFirst < dstElements ? std::min(args.srcSize, dstElements - args.dstFirst) : 0;
+
+        void** src = (void**)args.src;
+        for (size_t i = 0; i < count; i++, src += args.srcNumCoords, dst += dstStride) {
+            std::copy(src, src + numCoords, (void**)dst);
         }
     }
+
+    /// @brief Strings own their characters, so they're assigned rather than copied byte for byte.
+    void CopyStringsSingle(ConvertSingleArgs args) {
+        const uint16_t numCoords = std::min(args.srcNumCoords, args.dstNumCoords);
+        std::copy((std::string*)args.src, (std::string*)args.src + numCoords, (std::string*)args.dst);
+    }
+
+    void CopyStringsMulti(ConvertMultiArgs args) {
+        size_t dstElements;
+        size_t dstStride;
+        char* dst = args.DstBuffer(dstElements, dstStride) + args.dstFirst * dstStride;
+        const uint16_t numCoords = std::min(args.srcNumCoords, args.pinIn->NumCoords());
+        const size_t count = args.dstFirst < dstElements ? std::min(args.srcSize, dstElements - args.dstFirst) : 0;
+
+        std::string* src = (std::string*)args.src;
+        for (size_t i = 0; i < count; i++, src += args.srcNumCoords, dst += dstStride) {
+            std::copy(src, src + numCoords, (std::string*)dst);
+        }
+    }
+
+    /// @brief Flow pins don't carry values, but a push to a flow input still fires its callback.
+    void TriggerFlow(ConvertSingleArgs args) {
+        args.pinIn->OnValueChanged();
+    }
+
+    void SkipSingle(ConvertSingleArgs args) { }
+
+    void SkipMulti(ConvertMultiArgs args) { }
 }
 
 namespace seam::pins {
@@ -25,193 +74,140 @@ namespace seam::pins {
     void PinConnection::RecacheConverts() {
         bool canConvert;
         convertSingle = GetConvertSingle(pinOut->type, pinIn->type, canConvert);
-        assert(canConvert);
         convertMulti = GetConvertMulti(pinIn, pinOut, canConvert);
-        assert(canConvert);
+        // Connect() refuses pins which can't convert, but a Node may change a connected pin's type afterwards.
+        // Drop what's pushed rather than call a null converter.
+        if (!canConvert) {
+            printf("RecacheConverts(): can't convert pin %s to pin %s anymore, pushes between them are skipped\n",
+                pinOut->name.c_str(), pinIn->name.c_str());
+            convertSingle = &SkipSingle;
+            convertMulti = &SkipMulti;
+        }
+        sameLayout = SameLayout(pinIn, pinOut);
+        aliasable = CanAlias(pinIn, pinOut);
+        // The aliased data may not match the new layout.
+        if (!aliasable && pinIn->IsAliased()) {
+            pinIn->Detach();
+        }
+    }
+
+    char* ConvertMultiArgs::DstBuffer(size_t& elements, size_t& stride) const {
+        if (dst != nullptr) {
+            elements = dstElements;
+            stride = dstStride;
+            return (char*)dst;
+        }
+        stride = pinIn->Stride();
+        return (char*)pinIn->Buffer(elements);
+    }
+
+    void PinConnection::Convert(ConvertMultiArgs args) {
+        if (pinIn->Reducer() == PinReducer::LastWrite) {
+            convertMulti(args);
+        } else {
+            pinIn->ConvertReduced(pinOut, convertMulti, args);
+        }
+    }
+
+    bool PinConnection::ConvertAt(void* src, uint16_t srcNumCoords, size_t index) {
+        size_t dstSize;
+        pinIn->ReadBuffer(dstSize);
+        if (index >= dstSize) {
+            return false;
+        }
+
+        if (pinIn->Reducer() == PinReducer::LastWrite) {
+            char* dst = (char*)pinIn->Buffer(dstSize) + index * pinIn->Stride();
+            convertSingle(ConvertSingleArgs(src, srcNumCoords, dst, pinIn->NumCoords(), pinIn));
+        } else {
+            pinIn->ConvertReduced(pinOut, convertMulti, ConvertMultiArgs(src, srcNumCoords, 1, pinIn, index));
+        }
+        return true;
     }
 
     ConvertSingle GetConvertSingle(PinType srcType, PinType dstType, bool& isConvertible) {
         isConvertible = true;
-        const bool dstIsAny = dstType == PinType::Any;
-        // If types match, no conversion is needed and a simple memcpy can be used.
-        if (dstType == srcType || dstIsAny) {
-            size_t elementSize = PinTypeToElementSize(dstIsAny ? srcType : dstType);
-            return [elementSize](ConvertSingleArgs args) {
-                uint16_t numCoords = std::min(args.srcNumCoords, args.dstNumCoords);
-                std::copy((char*)args.src, (char*)args.src + elementSize * numCoords, 
-                    (char*)args.dst); 
-            };
+
+        // Any inputs take on the type of whatever is pushed to them.
+        if (dstType == PinType::Any) {
+            dstType = srcType;
         }
-        
-        switch (dstType) {
-            case PinType::Float:
-                switch (srcType) {
-                    case PinType::Int:
-                        return Convert<int32_t, float>;
-                    case PinType::Uint:
-                        return Convert<uint32_t, float>;
-                    case PinType::Bool:
-                        return Convert<bool, float>;
-                    case PinType::Char:
-                        return Convert<char, float>;
-                    default:
-                        break;
-                }
-            case PinType::Int:
-                switch (srcType) {
-                    case PinType::Float:
-                        return Convert<float, int32_t>;
-                    case PinType::Uint:
-                        return Convert<uint32_t, int32_t>;
-                    case PinType::Bool:
-                        return Convert<bool, int32_t>;
-                    case PinType::Char:
-                        return Convert<char, int32_t>;
-                    default:
-                        break;
-                }
-            case PinType::Bool:
-                switch (srcType) {
-                    case PinType::Float:
-                        return Convert<float, bool>;
-                    case PinType::Int:
-                        return Convert<int32_t, bool>;
-                    case PinType::Uint:
-                        return Convert<uint32_t, bool>;
-                    case PinType::Char:
-                        return Convert<char, bool>;
-                    default:
-                        break;
-                }
-            case PinType::Uint:
-                switch (srcType) {
-                    case PinType::Float:
-                        return Convert<float, uint32_t>;
-                    case PinType::Int:
-                        return Convert<int32_t, uint32_t>;
-                    case PinType::Bool:
-                        return Convert<bool, uint32_t>;
-                    case PinType::Char:
-                        return Convert<char, uint32_t>;
-                    default:
-                        break;
-                }
-            case PinType::Char:
-                switch(srcType) {
-                    case PinType::Float:
-                        return Convert<float, char>;
-                    case PinType::Int:
-                        return Convert<int32_t, char>;
-                    case PinType::Bool:
-                        return Convert<bool, char>;
-                    case PinType::Uint:
-                        return Convert<uint32_t, char>;
-                    default:
-                        break;
-                }
-            case PinType::Flow: {
-                return [](ConvertSingleArgs args) {
-                    args.pinIn->OnValueChanged();
-                };
-            }
-            // The pin system can't always infer what type of FBO is expected,
-            // for instance in cases where we create an FBO pin from uniforms.
-            // So, allow any FBO pin type to connect to another FBO pin type.
-            case PinType::FboRgba:
-            case PinType::FboRed:
-            case PinType::FboRgba16F:
-            {
-                if (IsFboPin(srcType)) {
-                    return Convert<ofFbo*, ofFbo*>;
-                }
-            }
-            default:
-                break;
+
+        if (IsBasicConvertType(srcType) && IsBasicConvertType(dstType)) {
+            return GetBasicConvertSingle(srcType, dstType);
+        }
+
+        // The pin system can't always infer what type of FBO is expected,
+        // for instance in cases where we create an FBO pin from uniforms.
+        // So, allow any FBO pin type to connect to another FBO pin type.
+        if (IsPointerType(srcType) && (srcType == dstType || (IsFboPin(srcType) && IsFboPin(dstType)))) {
+            return &CopyPointersSingle;
+        }
+
+        // Same typed strings are copied as they are.
+        if (srcType == dstType && srcType == PinType::String) {
+            return &CopyStringsSingle;
+        }
+
+        // Flow and struct pins have no values of their own to copy.
+        if (srcType == dstType && (srcType == PinType::Flow || srcType == PinType::Struct)) {
+            return &SkipSingle;
+        }
+
+        // Anything can trigger a flow input, and flow outputs can trigger any input.
+        if (dstType == PinType::Flow || srcType == PinType::Flow) {
+            return &TriggerFlow;
         }
 
         // Return empty converter since we can't actually do it...
         isConvertible = false;
-        return ConvertSingle();
+        return nullptr;
     }
 
     ConvertMulti GetConvertMulti(PinInput* pinIn, PinOutput* pinOut, bool& isConvertible) {
-        if (pinOut->type == pinIn->type) {
-            isConvertible = true;
-            size_t elementSize = PinTypeToElementSize(pinOut->type);
-
-            // If there's no stride, one big copy might be possible.
-            if (pinIn->Stride() == elementSize * pinIn->NumCoords()) {
-                if (pinIn->NumCoords() == pinOut->NumCoords()) {
-                    // Destination data has the same type and is formatted as a flat array,
-                    // and has the same number of coords as the source. A single copy is possible.
-                    return [elementSize](ConvertMultiArgs args) {
-                        size_t size;
-                        void* dst = args.pinIn->Buffer(size);
-                        size_t bytesToCopy = std::min(args.srcSize * args.srcNumCoords * elementSize, 
-                            args.pinIn->BufferSize());
-
-                        std::copy((char*)args.src, (char*)args.src + bytesToCopy, (char*)dst);
-                    };
-                } else {
-                    // Src and dst types are the same, and dst is a flat array,
-                    // but numCoords differ.
-                    return [elementSize](ConvertMultiArgs args) {
-                        size_t dstSize;
-                        void* dst = args.pinIn->Buffer(dstSize);
-                        const uint16_t coordsPerCopy = std::min(args.srcNumCoords, args.pinIn->NumCoords());
-                        const size_t bytesPerCopy = coordsPerCopy * elementSize;
-                        const size_t totalElements = std::min(args.srcSize, dstSize);
-
-                        // Copy as many coords as possible per element, and then skip to the next element.
-                        for (size_t i = 0; i < totalElements; i++) {
-                            std::copy((char*)args.src + elementSize * args.srcNumCoords * i,
-                                (char*)args.src + bytesPerCopy * (i + i),
-                                (char*)dst + elementSize * args.pinIn->NumCoords() * i);
-                        }
-                    };
-                }
-            } else {
-                // Has to account for stride!
-                return [elementSize](ConvertMultiArgs args) {
-                    size_t dstSize;
-                    char* dst = (char*)args.pinIn->Buffer(dstSize);
-
-                    const uint16_t numCoords = std::min(args.srcNumCoords, args.pinIn->NumCoords());
-                    char* src = (char*)args.src;
-                    char* srcEnd = src + args.srcSize * args.srcNumCoords * elementSize;
-                    size_t i = 0;
-
-                    while (i < dstSize && src != srcEnd) {
-                        char* dsti = dst + i * args.pinIn->Stride();
-                        std::copy(src, src + elementSize * numCoords, dsti);
-
-                        i++;
-                        src = src + elementSize * args.srcNumCoords;
-                    }
-                };
-            }
+        const PinType srcType = pinOut->type;
+        const PinType dstType = pinIn->type == PinType::Any ? srcType : pinIn->type;
 
-        } else {
-            ConvertSingle Convert = GetConvertSingle(pinOut->type, pinIn->type, isConvertible);
-            if (isConvertible) {
-                size_t srcStride = PinTypeToElementSize(pinOut->type) * pinOut->NumCoords();
-                return [Convert, srcStride](ConvertMultiArgs args) {
-                    size_t dstElements;
-                    char* dst = (char*)args.pinIn->Buffer(dstElements);
-                    const size_t dstStride = args.pinIn->Stride();
-                    
-                    char* src = (char*)args.src;
-                    char* srcEnd = src + args.srcSize * srcStride;
-
-                    for (size_t i = 0; i < dstElements && src != srcEnd; src += srcStride, dst += dstStride) {
-                        ConvertSingleArgs sArgs(src, args.srcNumCoords, 
-                            dst, args.pinIn->NumCoords(), args.pinIn);
-                        Convert(sArgs);
-                    }
-                };
-            }
+        // Multi converts are valid wherever single converts are.
+        GetConvertSingle(srcType, dstType, isConvertible);
+        if (!isConvertible) {
+            return nullptr;
+        }
+
+        if (IsBasicConvertType(srcType) && IsBasicConvertType(dstType)) {
+            // A flat destination with the same number of coords as the source can be converted in one batch.
+            const bool contiguous = pinIn->NumCoords() == pinOut->NumCoords()
+                && pinIn->Stride() == PinTypeToElementSize(dstType) * pinIn->NumCoords();
+            return GetBasicConvertMulti(srcType, dstType, contiguous);
+        }
+
+        if (IsPointerType(srcType) && IsPointerType(dstType)) {
+            return &CopyPointersMulti;
+        }
+
+        if (srcType == PinType::String && dstType == PinType::String) {
+            return &CopyStringsMulti;
         }
-        return ConvertMulti();
+
+        // Flow pins were already triggered by the push itself.
+        return &SkipMulti;
+    }
+
+    bool SameLayout(PinInput* pinIn, PinOutput* pinOut) {
+        if (pinIn->Reducer() != PinReducer::LastWrite) {
+            return false;
+        }
+
+        const PinType dstType = pinIn->type == PinType::Any ? pinOut->type : pinIn->type;
+        return IsBasicConvertType(dstType) && dstType == pinOut->type
+            && pinIn->NumCoords() == pinOut->NumCoords()
+            && pinIn->Stride() == PinTypeToElementSize(dstType) * pinIn->NumCoords();
+    }
+
+    bool CanAlias(PinInput* pinIn, PinOutput* pinOut) {
+        return flags::AreRaised(pinIn->flags, PinFlags::Aliasable) 
+            && flags::AreRaised(pinOut->flags, PinFlags::Aliasable)
+            && SameLayout(pinIn, pinOut);
     }
 }
 
@@ -330,6 +326,34 @@ TEST_CASE("Test single converter for 2-coord float to 3-coord float") {
 	CHECK(dst.z == 1.f);
 }
 
+TEST_CASE("Test single string to string pin converter") {
+    bool isConvertible = false;
+    pins::ConvertSingle Convert = seam::pins::GetConvertSingle(PinType::String, PinType::String, isConvertible);
+    CHECK(isConvertible);
+    REQUIRE(Convert != nullptr);
+    std::string src[2] = { "a string too long for the small string buffer", "b" };
+    std::string dst[2];
+    ConvertSingleArgs args(src, 2, dst, 2);
+    Convert(args);
+    CHECK(dst[0] == src[0]);
+    CHECK(dst[1] == "b");
+    // The copy owns its own characters.
+    CHECK(dst[0].data() != src[0].data());
+
+    Convert = seam::pins::GetConvertSingle(PinType::String, PinType::Any, isConvertible);
+    CHECK(isConvertible);
+    CHECK(Convert != nullptr);
+}
+
+TEST_CASE("Test strings and numbers aren't convertible") {
+    bool isConvertible = true;
+    CHECK(seam::pins::GetConvertSingle(PinType::String, PinType::Float, isConvertible) == nullptr);
+    CHECK(!isConvertible);
+    isConvertible = true;
+    CHECK(seam::pins::GetConvertSingle(PinType::Int, PinType::String, isConvertible) == nullptr);
+    CHECK(!isConvertible);
+}
+
 TEST_CASE("Test single converter for 3-coord uint to 2-coord float") {
     bool isConvertible = false;
 	pins::ConvertSingle Convert = seam::pins::GetConvertSingle(PinType::Uint, PinType::Float, isConvertible);
@@ -418,6 +442,259 @@ TEST_CASE("Test strided multi converter where source and destination are differe
     CHECK(dst[3].y == 3.f);
 }
 
+
+namespace {
+    template <typename T>
+    constexpr PinType BASIC_PIN_TYPE = std::is_same_v<T, bool> ? PinType::Bool
+        : std::is_same_v<T, char> ? PinType::Char
+        : std::is_same_v<T, int32_t> ? PinType::Int
+        : std::is_same_v<T, uint32_t> ? PinType::Uint
+        : PinType::Float;
+
+    template <typename SrcT, typename DstT>
+    void CheckBatchConvert() {
+        // Odd sized so the scalar tail after each kernel's vector loop runs too.
+        std::array<SrcT, 37> src;
+        std::array<DstT, 37> expected;
+        for (size_t i = 0; i < src.size(); i++) {
+            // Every value fits in every basic type, so the expected results are well defined.
+            src[i] = std::is_same_v<SrcT, bool> ? (SrcT)(i % 2) : (SrcT)((i % 5) == 0 ? 0 : i * 3 + 0.5f);
+            expected[i] = src[i];
+        }
+
+        const ConvertSimd previous = GetConvertSimd();
+        for (auto simd : { ConvertSimd::Scalar, ConvertSimd::Sse41, ConvertSimd::Avx2 }) {
+            if (!IsConvertSimdSupported(simd)) {
+                continue;
+            }
+            CHECK(SetConvertSimd(simd) == simd);
+
+            std::array<DstT, 37> dst = { };
+            pins::PinInput pinIn = pins::SetupInputPin(BASIC_PIN_TYPE<DstT>, nullptr, dst.data(), dst.size(), "dst");
+            pins::PinOutput pinOut = pins::SetupOutputPin(nullptr, BASIC_PIN_TYPE<SrcT>, "src");
+
+            bool isConvertible;
+            pins::ConvertMulti Convert = GetConvertMulti(&pinIn, &pinOut, isConvertible);
+            CHECK(isConvertible);
+            Convert(ConvertMultiArgs(src.data(), 1, src.size(), &pinIn));
+            CHECK(dst == expected);
+        }
+        SetConvertSimd(previous);
+    }
+
+    template <typename SrcT>
+    void CheckBatchConvertsFrom() {
+        CheckBatchConvert<SrcT, bool>();
+        CheckBatchConvert<SrcT, char>();
+        CheckBatchConvert<SrcT, int32_t>();
+        CheckBatchConvert<SrcT, uint32_t>();
+        CheckBatchConvert<SrcT, float>();
+    }
+}
+
+TEST_CASE("Test contiguous multi converters match scalar conversions for every instruction set") {
+    CheckBatchConvertsFrom<bool>();
+    CheckBatchConvertsFrom<char>();
+    CheckBatchConvertsFrom<int32_t>();
+    CheckBatchConvertsFrom<uint32_t>();
+    CheckBatchConvertsFrom<float>();
+}
+
+TEST_CASE("Test ranged multi converters only write their slice of the input") {
+    const std::array<int32_t, 3> src = { 7, 8, 9 };
+    std::array<float, 8> dst = { };
+    pins::PinInput pinIn = pins::SetupInputPin(PinType::Float, nullptr, dst.data(), dst.size(), "dst");
+    pins::PinOutput pinOut = pins::SetupOutputPin(nullptr, PinType::Int, "src");
+
+    bool isConvertible;
+    pins::ConvertMulti Convert = GetConvertMulti(&pinIn, &pinOut, isConvertible);
+    CHECK(isConvertible);
+    Convert(ConvertMultiArgs((void*)src.data(), 1, src.size(), &pinIn, 2));
+    CHECK(dst == std::array<float, 8> { 0.f, 0.f, 7.f, 8.f, 9.f, 0.f, 0.f, 0.f });
+
+    // Ranges running past the end of the input are cut short.
+    Convert(ConvertMultiArgs((void*)src.data(), 1, src.size(), &pinIn, 6));
+    CHECK(dst == std::array<float, 8> { 0.f, 0.f, 7.f, 8.f, 9.f, 0.f, 7.f, 8.f });
+    Convert(ConvertMultiArgs((void*)src.data(), 1, src.size(), &pinIn, 8));
+    CHECK(dst == std::array<float, 8> { 0.f, 0.f, 7.f, 8.f, 9.f, 0.f, 7.f, 8.f });
+
+    // The changed range is the whole buffer unless a push narrows it, until the change is handled.
+    CHECK(pinIn.ChangedRange().first == 0);
+    CHECK(pinIn.ChangedRange().count == dst.size());
+    pinIn.SetChangedRange(6, 3);
+    CHECK(pinIn.ChangedRange().first == 6);
+    CHECK(pinIn.ChangedRange().count == 2);
+    pinIn.OnValueChanged();
+    CHECK(pinIn.ChangedRange().count == dst.size());
+}
+
+TEST_CASE("Test inputs with reducers merge what each connection pushed") {
+    std::array<float, 4> dst = { };
+    pins::PinOutput pinOutA = pins::SetupOutputPin(nullptr, PinType::Float, "a");
+    pins::PinOutput pinOutB = pins::SetupOutputPin(nullptr, PinType::Int, "b");
+    pins::PinInput pinIn = pins::SetupInputPin(PinType::Float, nullptr, dst.data(), dst.size(), "dst",
+        PinInOptions::WithReducer(PinReducer::Sum));
+    PinConnection connA(&pinIn, &pinOutA);
+    PinConnection connB(&pinIn, &pinOutB);
+    pinIn.AddConnection(&pinOutA);
+    pinIn.AddConnection(&pinOutB);
+
+    std::array<float, 4> a = { 1.f, 2.f, 3.f, 4.f };
+    std::array<int32_t, 2> b = { 10, -10 };
+    connA.Convert(ConvertMultiArgs(a.data(), 1, a.size(), &pinIn));
+    CHECK(dst == std::array<float, 4> { 1.f, 2.f, 3.f, 4.f });
+    connB.Convert(ConvertMultiArgs(b.data(), 1, b.size(), &pinIn));
+    CHECK(dst == std::array<float, 4> { 11.f, -8.f, 3.f, 4.f });
+
+    // Pushing again replaces that connection's values, rather than adding to them.
+    a[0] = 0.f;
+    connA.Convert(ConvertMultiArgs(a.data(), 1, a.size(), &pinIn));
+    CHECK(dst == std::array<float, 4> { 10.f, -8.f, 3.f, 4.f });
+    CHECK(connB.ConvertAt(&b[1], 1, 3));
+    CHECK(dst == std::array<float, 4> { 10.f, -8.f, 3.f, -6.f });
+
+    pinIn.SetReducer(PinReducer::Max);
+    connA.Convert(ConvertMultiArgs(a.data(), 1, a.size(), &pinIn));
+    connB.Convert(ConvertMultiArgs(b.data(), 1, b.size(), &pinIn));
+    CHECK(dst == std::array<float, 4> { 10.f, 2.f, 3.f, 4.f });
+
+    pinIn.SetReducer(PinReducer::Concat);
+    connA.Convert(ConvertMultiArgs(a.data(), 1, 1, &pinIn));
+    connB.Convert(ConvertMultiArgs(b.data(), 1, b.size(), &pinIn));
+    CHECK(dst == std::array<float, 4> { 0.f, 10.f, -10.f, 4.f });
+
+    // Disconnected outputs stop contributing once something is pushed again.
+    pinIn.RemoveConnection(&pinOutA);
+    connB.Convert(ConvertMultiArgs(b.data(), 1, b.size(), &pinIn));
+    CHECK(dst == std::array<float, 4> { 10.f, -10.f, -10.f, 4.f });
+}
+
+TEST_CASE("Test parents pushing into a reducing input from different threads") {
+    std::array<float, 64> dst = { };
+    pins::PinOutput pinOutA = pins::SetupOutputPin(nullptr, PinType::Float, "a");
+    pins::PinOutput pinOutB = pins::SetupOutputPin(nullptr, PinType::Float, "b");
+    // Strided, so merges also go through the input's scratch buffer.
+    pins::PinInput pinIn = pins::SetupInputPin(PinType::Float, nullptr, dst.data(), dst.size() / 2, "dst",
+        PinInOptions(sizeof(float) * 2));
+    pinIn.SetReducer(PinReducer::Sum);
+    PinConnection connA(&pinIn, &pinOutA);
+    PinConnection connB(&pinIn, &pinOutB);
+    pinIn.AddConnection(&pinOutA);
+    pinIn.AddConnection(&pinOutB);
+
+    auto pushRepeatedly = [&pinIn](PinConnection& conn, float value) {
+        std::array<float, 32> src;
+        src.fill(value);
+        for (int i = 0; i < 2000; i++) {
+            conn.Convert(ConvertMultiArgs(src.data(), 1, src.size(), &pinIn));
+        }
+    };
+    std::thread pushingA([&]() { pushRepeatedly(connA, 1.f); });
+    pushRepeatedly(connB, 2.f);
+    pushingA.join();
+
+    // The pin's buffer is never pointed anywhere else, and both slots made it into the sum.
+    size_t size;
+    CHECK(pinIn.Buffer(size) == dst.data());
+    bool summed = true;
+    for (size_t i = 0; i < size; i++) {
+        summed = summed && dst[i * 2] == 3.f && dst[i * 2 + 1] == 0.f;
+    }
+    CHECK(summed);
+}
+
+TEST_CASE("Test aliased inputs read pushed data in place and copy it before writes") {
+    std::array<float, 8> pushed = { 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f };
+    std::array<float, 8> owned = { };
+    pins::PinInput pinIn = pins::SetupInputPin(PinType::Float, nullptr, owned.data(), owned.size(), "dst");
+    pins::PinOutput pinOut = pins::SetupOutputPin(nullptr, PinType::Float, "src");
+
+    // Both ends have to opt in.
+    CHECK(!CanAlias(&pinIn, &pinOut));
+    pinIn.flags = pinIn.flags | PinFlags::Aliasable;
+    CHECK(!CanAlias(&pinIn, &pinOut));
+    pinOut.flags = pinOut.flags | PinFlags::Aliasable;
+    CHECK(CanAlias(&pinIn, &pinOut));
+
+    // Layouts have to match.
+    pinOut.SetNumCoords(2);
+    CHECK(!CanAlias(&pinIn, &pinOut));
+    pinOut.SetNumCoords(1);
+
+    size_t size;
+    pinIn.Alias(pushed.data());
+    CHECK(pinIn.ReadBuffer(size) == pushed.data());
+    CHECK(size == owned.size());
+
+    // Writing copies the pushed values over first, and leaves them untouched.
+    float* buff = (float*)pinIn.Buffer(size);
+    CHECK(buff == owned.data());
+    CHECK(!pinIn.IsAliased());
+    CHECK(owned == pushed);
+    buff[0] = 42.f;
+    CHECK(pushed[0] == 1.f);
+    CHECK(pinIn.ReadBuffer(size) == owned.data());
+}
+
+TEST_CASE("Test typed pins get their layout from their element type") {
+    std::array<glm::vec3, 2> values = { glm::vec3(1.f), glm::vec3(2.f) };
+    TypedPinInput<glm::vec3, 2> pinIn(nullptr, values.data(), "dst");
+    CHECK(pinIn.type == PinType::Float);
+    CHECK(pinIn.NumCoords() == 3);
+    CHECK(pinIn.Stride() == sizeof(glm::vec3));
+    CHECK(pinIn.Value(1) == glm::vec3(2.f));
+
+    // Same typed outputs can copy straight into the input.
+    TypedPinOutput<glm::vec3> vec3Out(nullptr, "vec3");
+    TypedPinOutput<glm::vec4> vec4Out(nullptr, "vec4");
+    TypedPinOutput<glm::ivec3> ivec3Out(nullptr, "ivec3");
+    CHECK(vec3Out.NumCoords() == 3);
+    CHECK(ivec3Out.type == PinType::Int);
+    CHECK(PinConnection(&pinIn, &vec3Out).sameLayout);
+    CHECK(!PinConnection(&pinIn, &vec4Out).sameLayout);
+    CHECK(!PinConnection(&pinIn, &ivec3Out).sameLayout);
+
+    // Reducers merge values, so they always convert.
+    pinIn.SetReducer(PinReducer::Sum);
+    CHECK(!PinConnection(&pinIn, &vec3Out).sameLayout);
+    pinIn.SetReducer(PinReducer::LastWrite);
+
+    // Value() reads pushed data the input aliases.
+    std::array<glm::vec3, 2> pushed = { glm::vec3(3.f), glm::vec3(4.f) };
+    pinIn.Alias(pushed.data());
+    CHECK(pinIn.Value(0) == glm::vec3(3.f));
+}
+
+TEST_CASE("Test pin callbacks are copied with the pin, and cost nothing until set") {
+    float value = 0.f;
+    PinInput plain = SetupInputPin(PinType::Float, nullptr, &value, 1, "plain");
+    const size_t plainBytes = plain.MetadataHeapBytes();
+    CHECK(plainBytes == 0);
+
+    int changed = 0;
+    PinInput pinIn = SetupInputPin(PinType::Float, nullptr, &value, 1, "pin",
+        PinInOptions([&changed]() { changed++; }));
+    CHECK(pinIn.MetadataHeapBytes() > plainBytes);
+
+    PinInput copy = pinIn;
+    copy.OnValueChanged();
+    pinIn.OnValueChanged();
+    CHECK(changed == 2);
+
+    // The copy's callbacks are its own.
+    copy.SetOnValueChanged([&changed]() { changed += 10; });
+    pinIn.OnValueChanged();
+    CHECK(changed == 3);
+    copy.OnValueChanged();
+    CHECK(changed == 13);
+
+    PinInput described(PinType::Float, "described", "The same description", nullptr, &value, 1, sizeof(float),
+        sizeof(float), 0, 1, ValueChangedCallback(), ValueChangingCallback(), nullptr);
+    PinInput describedToo(PinType::Float, "described too", "The same description", nullptr, &value, 1, sizeof(float),
+        sizeof(float), 0, 1, ValueChangedCallback(), ValueChangingCallback(), nullptr);
+    CHECK(described.description.View().data() == describedToo.description.View().data());
+}
+
 }
 
-#endif // RUN_DOCTEST
\ No newline at end of file
+#endif // RUN_DOCTEST
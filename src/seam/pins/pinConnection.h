@@ -1,6 +1,5 @@
 #pragma once
 
-#include <functional>
 #include "seam/pins/pinBase.h"
 
 namespace seam::pins {
@@ -10,7 +9,7 @@ namespace seam::pins {
     struct ConvertSingleArgs {
         ConvertSingleArgs(void* _src, uint16_t _srcNumCoords, 
             void* _dst, uint16_t _dstNumCoords,
-            PinInput* _pinIn) {
+            PinInput* _pinIn = nullptr) {
             src = _src;
             srcNumCoords = _srcNumCoords;
             dst = _dst;
@@ -26,33 +25,70 @@ namespace seam::pins {
     };
 
     struct ConvertMultiArgs {
-        ConvertMultiArgs(void* _src, uint16_t _srcNumCoords, size_t _srcSize, PinInput* _pinIn) {
+        ConvertMultiArgs(void* _src, uint16_t _srcNumCoords, size_t _srcSize, PinInput* _pinIn,
+            size_t _dstFirst = 0) {
             src = _src;
             srcNumCoords = _srcNumCoords;
             srcSize = _srcSize;
             pinIn = _pinIn;
+            dstFirst = _dstFirst;
         }
 
+        /// @return Where elements are converted to: dst if it's set, otherwise the input's buffer.
+        char* DstBuffer(size_t& elements, size_t& stride) const;
+
         void* src;
         uint16_t srcNumCoords;
         size_t srcSize;
         PinInput* pinIn;
+        /// @brief Index of the input element the first source element is converted to,
+        /// so ranged pushes only touch their slice of the input.
+        size_t dstFirst;
+
+        /// @brief If set, elements are converted into this array (a fan in slot, for instance)
+        /// instead of the input's buffer; the input still gives the destination's type and coords.
+        void* dst = nullptr;
+        size_t dstStride = 0;
+        size_t dstElements = 0;
     };
 
-    using ConvertSingle = std::function<void(ConvertSingleArgs)>;
-    using ConvertMulti = std::function<void(ConvertMultiArgs)>;
+    /// @brief Converters are plain function pointers picked from generated tables, 
+    /// so pushing costs a single indirect call per connection rather than one per element.
+    using ConvertSingle = void(*)(ConvertSingleArgs);
+    using ConvertMulti = void(*)(ConvertMultiArgs);
 
     struct PinConnection {
         PinConnection(PinInput* _input, PinOutput* _output);
         void RecacheConverts();
 
+        /// @brief Convert pushed elements into the input, starting at element args.dstFirst.
+        /// If the input has a reducer, they're merged with what its other connections pushed.
+        void Convert(ConvertMultiArgs args);
+
+        /// @brief Convert a single pushed element into the input's element at index, if it has one.
+        /// @return true if the input has an element at index.
+        bool ConvertAt(void* src, uint16_t srcNumCoords, size_t index);
+
         PinId inputPinId;
         PinInput* pinIn;
         PinOutput* pinOut;
         ConvertSingle convertSingle;
         ConvertMulti convertMulti;
+        /// @brief True if multi pushes can alias the pushed data rather than convert it;
+        /// see PinFlags::Aliasable.
+        bool aliasable;
+        /// @brief True if pushed elements can be copied into the input as they are; see SameLayout().
+        bool sameLayout;
     };
     
     ConvertSingle GetConvertSingle(PinType srcType, PinType dstType, bool& isConvertible);
     ConvertMulti GetConvertMulti(PinInput* pinIn, PinOutput* pinOut, bool& isConvertible);
+
+    /// @return true if the input stores elements exactly like the output pushes them:
+    /// the same basic type and number of coords, tightly packed, and no reducer.
+    bool SameLayout(PinInput* pinIn, PinOutput* pinOut);
+
+    /// @return true if the input can read data pushed by the output in place:
+    /// both raise PinFlags::Aliasable, and their types and tightly packed layouts match.
+    bool CanAlias(PinInput* pinIn, PinOutput* pinOut);
 }
\ No newline at end of file
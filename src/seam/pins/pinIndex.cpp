@@ -0,0 +1,171 @@
+#include <algorithm>
+
+#include "seam/pins/pinIndex.h"
+#include "seam/pins/pin.h"
+#include "seam/nodes/iNode.h"
+#include "seam/hash.h"
+
+namespace {
+    using namespace seam::pins;
+
+    PinInput* Children(PinInput& pin, size_t& size) {
+        return pin.PinInputs(size);
+    }
+
+    PinOutput* Children(PinOutput& pin, size_t& size) {
+        return pin.PinOutputs(size);
+    }
+}
+
+namespace seam::pins {
+    void PinIndex::Add(nodes::INode* node) {
+        NodeEntry* entry = indexedNodes.Find(NodeKey(node));
+        if (entry != nullptr) {
+            Unindex(node, *entry);
+        } else {
+            indexedNodes.Set(NodeKey(node), NodeEntry());
+            entry = indexedNodes.Find(NodeKey(node));
+        }
+        Index(node, *entry);
+    }
+
+    void PinIndex::Remove(nodes::INode* node) {
+        NodeEntry* entry = indexedNodes.Find(NodeKey(node));
+        if (entry == nullptr) {
+            return;
+        }
+
+        if (entry->invalidated) {
+            invalidated.erase(std::find(invalidated.begin(), invalidated.end(), node));
+        }
+        Unindex(node, *entry);
+        indexedNodes.Erase(NodeKey(node));
+    }
+
+    void PinIndex::Invalidate(nodes::INode* node) {
+        NodeEntry* entry = indexedNodes.Find(NodeKey(node));
+        if (entry != nullptr && !entry->invalidated) {
+            entry->invalidated = true;
+            invalidated.push_back(node);
+        }
+    }
+
+    void PinIndex::Clear() {
+        pinsById.Clear();
+        pinsByName.Clear();
+        indexedNodes.Clear();
+        invalidated.clear();
+    }
+
+    PinInput* PinIndex::FindInput(PinId id) {
+        PinEntry* entry = FindEntry(id);
+        return entry != nullptr && entry->input ? static_cast<PinInput*>(entry->pin) : nullptr;
+    }
+
+    PinOutput* PinIndex::FindOutput(PinId id) {
+        PinEntry* entry = FindEntry(id);
+        return entry != nullptr && !entry->input ? static_cast<PinOutput*>(entry->pin) : nullptr;
+    }
+
+    nodes::INode* PinIndex::FindNode(PinId id) {
+        PinEntry* entry = FindEntry(id);
+        return entry != nullptr ? entry->node : nullptr;
+    }
+
+    PinInput* PinIndex::FindInputByName(nodes::INode* node, std::string_view name) {
+        Refresh();
+        Pin** pin = pinsByName.Find(NameKey(node, true, name));
+        if (pin != nullptr && StrCmpLower(name, (*pin)->name)) {
+            return static_cast<PinInput*>(*pin);
+        }
+        // A hash collision with another pin, or a pin was renamed since the Node was indexed.
+        return FindPinInByName(node, name);
+    }
+
+    PinOutput* PinIndex::FindOutputByName(nodes::INode* node, std::string_view name) {
+        Refresh();
+        Pin** pin = pinsByName.Find(NameKey(node, false, name));
+        if (pin != nullptr && StrCmpLower(name, (*pin)->name)) {
+            return static_cast<PinOutput*>(*pin);
+        }
+        return FindPinOutByName(node, name);
+    }
+
+    size_t PinIndex::Size() {
+        Refresh();
+        return pinsById.Size();
+    }
+
+    uint64_t PinIndex::NameKey(nodes::INode* node, bool input, std::string_view name) {
+        const uint64_t key = (NodeKey(node) * 0x9e3779b97f4a7c15ULL) ^ ((uint64_t)SCHashLower(name) << 1 | input);
+        // Zero marks empty IdMap slots.
+        return key != 0 ? key : 1;
+    }
+
+    void PinIndex::Index(nodes::INode* node, NodeEntry& entry) {
+        size_t size;
+        PinInput* inputs = node->PinInputs(size);
+        IndexPins(node, entry, inputs, size, true);
+        PinOutput* outputs = node->PinOutputs(size);
+        IndexPins(node, entry, outputs, size, false);
+        entry.invalidated = false;
+    }
+
+    template <typename P>
+    void PinIndex::IndexPins(nodes::INode* node, NodeEntry& entry, P* pins, size_t size, bool input) {
+        // Match FindPinInByName()'s search order: every pin at this level first, then each pin's children.
+        for (size_t i = 0; i < size; i++) {
+            if (pins[i].id != 0) {
+                pinsById.Set(pins[i].id, PinEntry { &pins[i], node, input });
+                entry.ids.push_back(pins[i].id);
+            }
+
+            const uint64_t nameKey = NameKey(node, input, pins[i].name);
+            if (pinsByName.Insert(nameKey, &pins[i])) {
+                entry.nameKeys.push_back(nameKey);
+            }
+        }
+
+        for (size_t i = 0; i < size; i++) {
+            size_t childrenSize;
+            P* children = Children(pins[i], childrenSize);
+            if (children != nullptr) {
+                IndexPins(node, entry, children, childrenSize, input);
+            }
+        }
+    }
+
+    void PinIndex::Unindex(nodes::INode* node, NodeEntry& entry) {
+        for (PinId id : entry.ids) {
+            // Another Node may have been indexed with this id since.
+            PinEntry* pin = pinsById.Find(id);
+            if (pin != nullptr && pin->node == node) {
+                pinsById.Erase(id);
+            }
+        }
+        for (uint64_t key : entry.nameKeys) {
+            pinsByName.Erase(key);
+        }
+        entry.ids.clear();
+        entry.nameKeys.clear();
+    }
+
+    void PinIndex::Refresh() {
+        if (invalidated.empty()) {
+            return;
+        }
+
+        for (nodes::INode* node : invalidated) {
+            Unindex(node, *indexedNodes.Find(NodeKey(node)));
+        }
+        for (nodes::INode* node : invalidated) {
+            Index(node, *indexedNodes.Find(NodeKey(node)));
+        }
+        invalidated.clear();
+    }
+
+    PinIndex::PinEntry* PinIndex::FindEntry(PinId id) {
+        Refresh();
+        return id != 0 ? pinsById.Find(id) : nullptr;
+    }
+}
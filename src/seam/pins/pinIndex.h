@@ -0,0 +1,93 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+#include "seam/containers/idMap.h"
+#include "seam/pins/pinBase.h"
+
+namespace seam::nodes {
+    class INode;
+}
+
+namespace seam::pins {
+    class PinInput;
+    class PinOutput;
+
+    /// @brief A SeamGraph's index of every pin in the graph, by id and by name,
+    /// so connecting, disconnecting and loading don't have to search Nodes' pin hierarchies.
+    /// Nodes call INode::PinsChanged() when their pins are added, removed, moved or given new ids;
+    /// changed Nodes are reindexed in a batch before the next lookup.
+    class PinIndex {
+    public:
+        /// @brief Index the pins of a Node which was just added to the graph.
+        void Add(nodes::INode* node);
+
+        /// @brief Stop indexing a Node's pins, before the Node is deleted.
+        void Remove(nodes::INode* node);
+
+        /// @brief The Node's pins changed; they're reindexed before the next lookup.
+        /// Does nothing for Nodes which aren't indexed.
+        void Invalidate(nodes::INode* node);
+
+        void Clear();
+
+        /// @return The input pin with this id, or nullptr if there isn't one.
+        PinInput* FindInput(PinId id);
+
+        /// @return The output pin with this id, or nullptr if there isn't one.
+        PinOutput* FindOutput(PinId id);
+
+        /// @return The Node owning the pin with this id, or nullptr if there isn't one.
+        nodes::INode* FindNode(PinId id);
+
+        /// @brief Case insensitive name lookups, which find the same pin as FindPinInByName() would:
+        /// a Node's pins are searched before their children.
+        PinInput* FindInputByName(nodes::INode* node, std::string_view name);
+        PinOutput* FindOutputByName(nodes::INode* node, std::string_view name);
+
+        /// @return The number of pins indexed by id.
+        size_t Size();
+
+    private:
+        struct PinEntry {
+            Pin* pin = nullptr;
+            nodes::INode* node = nullptr;
+            bool input = false;
+        };
+
+        /// @brief What was indexed for a Node, so it can be removed again without walking the Node's pins,
+        /// which may have moved or been destroyed since.
+        struct NodeEntry {
+            std::vector<PinId> ids;
+            std::vector<uint64_t> nameKeys;
+            bool invalidated = false;
+        };
+
+        /// @brief Names are pre-hashed per Node and direction. Colliding keys keep the first pin indexed,
+        /// and lookups double check the pin's name, so a collision only costs a search.
+        static uint64_t NameKey(nodes::INode* node, bool input, std::string_view name);
+
+        static inline uint64_t NodeKey(nodes::INode* node) {
+            return (uint64_t)(uintptr_t)node;
+        }
+
+        void Index(nodes::INode* node, NodeEntry& entry);
+
+        template <typename P>
+        void IndexPins(nodes::INode* node, NodeEntry& entry, P* pins, size_t size, bool input);
+
+        void Unindex(nodes::INode* node, NodeEntry& entry);
+
+        /// @brief Reindex invalidated Nodes. All of them are unindexed before any are indexed again,
+        /// since pin ids can move between Nodes while loading.
+        void Refresh();
+
+        PinEntry* FindEntry(PinId id);
+
+        IdMap<PinEntry> pinsById;
+        IdMap<Pin*> pinsByName;
+        IdMap<NodeEntry> indexedNodes;
+        std::vector<nodes::INode*> invalidated;
+    };
+}
@@ -1,5 +1,9 @@
+#include <mutex>
+
 #include "seam/pins/pinInput.h"
 #include "seam/pins/pinConnection.h"
+#include "seam/pins/stagedPushes.h"
+#include "seam/pins/convertKernels.h"
 
 using namespace seam::pins;
 
@@ -11,25 +15,227 @@ namespace {
             return pinIn == conn.pinIn;
         });
     }
+
+    /// @brief Merge each slot's values into dst, element-wise for the element indices slots have in common.
+    /// @return Number of elements written to dst.
+    template <typename T, typename Op>
+    size_t ReduceSlots(const std::vector<FanInSlot>& slots, T* dst, size_t maxElements, uint16_t numCoords, Op op) {
+        size_t reduced = 0;
+        for (const auto& slot : slots) {
+            const T* src = (const T*)slot.values.data();
+            const size_t size = std::min(slot.size, maxElements) * numCoords;
+            const size_t overlap = std::min(size, reduced * numCoords);
+            // Flat loops over packed values, so the compiler can vectorize them.
+            for (size_t i = 0; i < overlap; i++) {
+                dst[i] = op(dst[i], src[i]);
+            }
+            std::copy(src + overlap, src + size, dst + overlap);
+            reduced = std::max(reduced, size / numCoords);
+        }
+        return reduced;
+    }
+
+    template <typename T>
+    size_t Reduce(PinReducer reducer, const std::vector<FanInSlot>& slots, T* dst, size_t maxElements, uint16_t numCoords) {
+        switch (reducer) {
+        case PinReducer::Sum:
+            return ReduceSlots(slots, dst, maxElements, numCoords, [](T a, T b) { return (T)(a + b); });
+        case PinReducer::Max:
+            return ReduceSlots(slots, dst, maxElements, numCoords, [](T a, T b) { return std::max(a, b); });
+        case PinReducer::Min:
+            return ReduceSlots(slots, dst, maxElements, numCoords, [](T a, T b) { return std::min(a, b); });
+        default:
+            assert(false);
+            return 0;
+        }
+    }
+
+    /// @brief Each slot's values follow the previous slot's, cut off once dst is full.
+    size_t Concat(const std::vector<FanInSlot>& slots, char* dst, size_t maxElements, size_t elementBytes) {
+        size_t concatenated = 0;
+        for (const auto& slot : slots) {
+            const size_t size = std::min(slot.size, maxElements - concatenated);
+            std::copy(slot.values.data(), slot.values.data() + size * elementBytes, dst + concatenated * elementBytes);
+            concatenated += size;
+        }
+        return concatenated;
+    }
 }
 
 PinInput::~PinInput() {
     // PinInputs are nice and clean up pointer refs to themselves.
-    // Make sure any existing connection to this input is severed.
-    if (connection != nullptr) {
-        auto& outputConns = connection->connections;
+    // Make sure any existing connections to this input are severed.
+    for (PinOutput* pinOut : connections) {
+        auto& outputConns = pinOut->connections;
         auto it = FindConnection(outputConns, this);
         if (it != outputConns.end()) {
             outputConns.erase(it);
         }
     }
+
+    if (staged != nullptr && staged->Pin() == this) {
+        staged->SetPin(nullptr);
+    }
+}
+
+void PinInput::Detach() {
+    // Aliased data is tightly packed, as is any buffer that can alias.
+    std::copy((const char*)alias, (const char*)alias + totalElements * stride, (char*)buffer + offset);
+    alias = nullptr;
 }
 
 void PinInput::SetNumCoords(uint16_t _numCoords) {
+    // The aliased data was pushed with the old layout.
+    if (alias != nullptr) {
+        Detach();
+    }
     numCoords = _numCoords;
-    if (connection != nullptr) {
-        auto it = FindConnection(connection->connections, this);
-        assert(it != connection->connections.end());
+    for (PinOutput* pinOut : connections) {
+        auto it = FindConnection(pinOut->connections, this);
+        assert(it != pinOut->connections.end());
         it->RecacheConverts();
     }
+
+    // Values already pushed to the fan in slots have the old layout too.
+    if (PinInputExtras* e = extras.Find()) {
+        for (auto& slot : e->fanIn) {
+            slot.values.clear();
+            slot.size = 0;
+        }
+    }
+}
+
+void PinInput::SetReducer(PinReducer _reducer) {
+    if (alias != nullptr) {
+        Detach();
+    }
+
+    reducer = _reducer;
+    if (PinInputExtras* e = extras.Find()) {
+        e->fanIn.clear();
+        e->reduced.clear();
+    }
+    for (PinOutput* pinOut : connections) {
+        if (reducer != PinReducer::LastWrite) {
+            extras.Get().fanIn.push_back(FanInSlot { pinOut });
+        }
+        // Reducing inputs can't alias pushed data.
+        auto it = FindConnection(pinOut->connections, this);
+        if (it != pinOut->connections.end()) {
+            it->RecacheConverts();
+        }
+    }
+}
+
+void PinInput::AddConnection(PinOutput* pinOut) {
+    connections.push_back(pinOut);
+    if (reducer != PinReducer::LastWrite) {
+        extras.Get().fanIn.push_back(FanInSlot { pinOut });
+    }
+}
+
+void PinInput::RemoveConnection(PinOutput* pinOut) {
+    auto it = std::find(connections.begin(), connections.end(), pinOut);
+    if (it != connections.end()) {
+        connections.erase(it);
+    }
+
+    PinInputExtras* e = extras.Find();
+    if (e == nullptr) {
+        return;
+    }
+    auto slot = std::find_if(e->fanIn.begin(), e->fanIn.end(), [pinOut](const FanInSlot& s) {
+        return s.pinOut == pinOut;
+    });
+    if (slot != e->fanIn.end()) {
+        e->fanIn.erase(slot);
+    }
+}
+
+void PinInput::ConvertReduced(PinOutput* pinOut, ConvertMulti convert, ConvertMultiArgs args) {
+    assert(args.pinIn == this);
+    PinInputExtras& e = extras.Get();
+    std::lock_guard<FanInLock> lock(e.fanInLock);
+
+    std::vector<FanInSlot>& fanIn = e.fanIn;
+    auto slot = std::find_if(fanIn.begin(), fanIn.end(), [pinOut](const FanInSlot& s) {
+        return s.pinOut == pinOut;
+    });
+    if (slot == fanIn.end()) {
+        fanIn.push_back(FanInSlot { pinOut });
+        slot = fanIn.end() - 1;
+    }
+
+    const size_t elementBytes = sizeInBytes * numCoords;
+    slot->values.resize(totalElements * elementBytes);
+
+    // The connection's converter fills the slot, leaving the pin's own buffer to the reducer.
+    args.dst = slot->values.data();
+    args.dstStride = elementBytes;
+    args.dstElements = totalElements;
+    convert(args);
+
+    if (args.dstFirst < totalElements) {
+        slot->size = std::max(slot->size, std::min(totalElements, args.dstFirst + args.srcSize));
+    }
+
+    // Merge straight into the buffer if it's packed.
+    const bool packed = stride == elementBytes;
+    std::vector<char>& reduced = e.reduced;
+    if (!packed) {
+        reduced.resize(totalElements * elementBytes);
+    }
+    char* dst = packed ? (char*)buffer + offset : reduced.data();
+
+    size_t size = 0;
+    if (reducer == PinReducer::Concat) {
+        size = Concat(fanIn, dst, totalElements, elementBytes);
+        // Values after this connection's may have moved.
+        SetChangedRange(0, size);
+    } else {
+        switch (type) {
+        case PinType::Bool:
+            size = Reduce(reducer, fanIn, (bool*)dst, totalElements, numCoords);
+            break;
+        case PinType::Char:
+            size = Reduce(reducer, fanIn, (char*)dst, totalElements, numCoords);
+            break;
+        case PinType::Int:
+            size = Reduce(reducer, fanIn, (int32_t*)dst, totalElements, numCoords);
+            break;
+        case PinType::Uint:
+            size = Reduce(reducer, fanIn, (uint32_t*)dst, totalElements, numCoords);
+            break;
+        case PinType::Float:
+            size = Reduce(reducer, fanIn, (float*)dst, totalElements, numCoords);
+            break;
+        default:
+            // Other types can't be summed or compared, so the last push wins.
+            size = slot->size;
+            std::copy(slot->values.data(), slot->values.data() + size * elementBytes, dst);
+            break;
+        }
+    }
+
+    if (!packed) {
+        char* pinDst = (char*)buffer + offset;
+        for (size_t i = 0; i < size; i++) {
+            std::copy(dst + i * elementBytes, dst + (i + 1) * elementBytes, pinDst + i * stride);
+        }
+    }
+}
+
+size_t PinInput::MetadataHeapBytes() {
+    size_t bytes = StringHeapBytes(name) + connections.capacity() * sizeof(PinOutput*)
+        + (childPins.capacity() - childPins.size()) * sizeof(PinInput);
+    if (PinInputExtras* e = extras.Find()) {
+        bytes += sizeof(PinInputExtras) + e->reduced.capacity() + e->fanIn.capacity() * sizeof(FanInSlot);
+        for (const auto& slot : e->fanIn) {
+            bytes += slot.values.capacity();
+        }
+        if (e->events != nullptr) {
+            bytes += e->events->HeapBytes();
+        }
+    }
+    return bytes;
 }
\ No newline at end of file
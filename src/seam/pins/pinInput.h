@@ -5,14 +5,22 @@
 #include <assert.h>
 #include <cstring>
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
 
 #include "seam/pins/pinBase.h"
 #include "seam/pins/pinTypes.h"
 #include "seam/pins/iInPinnable.h"
 #include "seam/pins/pinOutput.h"
+#include "seam/containers/eventQueue.h"
+#include "seam/containers/boxed.h"
 
 namespace seam::pins {
     class VectorPinInput;
+    class StagedPushes;
 
     /// @brief Is called before a pin's value has been updated.
     /// NOTE: Is called when pushing to an input pin right now, but not from user GUI updates.
@@ -20,6 +28,78 @@ namespace seam::pins {
     /// @brief Is called after a pin's value has been updated.
     using ValueChangedCallback = std::function<void(void)>;
 
+    /// @brief A span of elements in a Pin's buffer.
+    struct ElementRange {
+        size_t first;
+        size_t count;
+    };
+
+    /// @brief How an input pin with several connections merges what each of them pushes.
+    enum class PinReducer : uint8_t {
+        /// @brief Each push overwrites the pin's values, whichever connection it came from.
+        LastWrite,
+        /// @brief The pin's values are the element-wise sum of each connection's last pushed values.
+        Sum,
+        /// @brief The pin's values are the element-wise max of each connection's last pushed values.
+        Max,
+        /// @brief The pin's values are the element-wise min of each connection's last pushed values.
+        Min,
+        /// @brief Each connection's last pushed values follow the previous connection's, in connection order.
+        Concat
+    };
+
+    /// @brief The last values a connection pushed to an input pin with a reducer, 
+    /// packed and converted to the input's type.
+    struct FanInSlot {
+        PinOutput* pinOut;
+        std::vector<char> values;
+        /// @brief Number of elements pushed so far.
+        size_t size = 0;
+    };
+
+    /// @brief Serializes pushes into a reducing input, which touch its fan in slots and its whole buffer.
+    /// Only held for the length of a push; copies start out unlocked so PinInputExtras stays copyable.
+    class FanInLock {
+    public:
+        FanInLock() { }
+        FanInLock(const FanInLock&) { }
+        FanInLock& operator=(const FanInLock&) { return *this; }
+
+        inline void lock() {
+            while (locked.exchange(true, std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+        }
+
+        inline void unlock() {
+            locked.store(false, std::memory_order_release);
+        }
+
+    private:
+        std::atomic<bool> locked = false;
+    };
+
+    /// @brief The parts of a PinInput which most pins never use;
+    /// see PinInput::extras.
+    struct PinInputExtras {
+        ConnectedCallback onConnected;
+        DisconnectedCallback onDisconnected;
+        ValueChangingCallback onValueChanging;
+        ValueChangedCallback onValueChanged;
+
+        /// @brief One per connection, only while the pin has a reducer other than PinReducer::LastWrite.
+        std::vector<FanInSlot> fanIn;
+
+        /// @brief Reducers merge into this when the pin's buffer isn't packed.
+        std::vector<char> reduced;
+
+        /// @brief Held by ConvertReduced(), so parents pushing from different threads don't interleave.
+        FanInLock fanInLock;
+
+        /// @brief Only set for PinFlags::EventQueue pins. Copies of the pin share its queue.
+        std::shared_ptr<EventQueue> events;
+    };
+
     struct PinInOptions {
         PinInOptions() { }
 
@@ -69,17 +149,27 @@ namespace seam::pins {
             return options;
         }
 
+        static PinInOptions WithReducer(PinReducer reducer,
+            ValueChangedCallback&& _onValueChanged = ValueChangedCallback())
+        {
+            PinInOptions options;
+            options.reducer = reducer;
+            options.onValueChanged = std::move(_onValueChanged);
+            return options;
+        }
+
         void* pinMetadata = nullptr;
         std::string_view description;
         size_t elementSize = 0;
         size_t stride = 0;
         size_t offset = 0;
         uint16_t numCoords = 1;
+        PinReducer reducer = PinReducer::LastWrite;
         ValueChangedCallback onValueChanged;
         ValueChangingCallback onValueChanging;
     };
 
-    class PinInput final : public Pin, public IInPinnable {
+    class PinInput : public Pin, public IInPinnable {
     public:
         PinInput() {
             type = PinType::None;
@@ -113,8 +203,8 @@ namespace seam::pins {
             stride = _stride;
             offset = _offset;
             numCoords = _numCoords;
-            onValueChanged = std::move(_onValueChanged);
-            onValueChanging = std::move(_onValueChanging);
+            SetOnValueChanged(std::move(_onValueChanged));
+            SetOnValueChanging(std::move(_onValueChanging));
             pinMetadata = _pinMetadata;
 
             assert(stride >= sizeInBytes);
@@ -125,7 +215,8 @@ namespace seam::pins {
             const std::string_view _description,
             nodes::INode* _node,
             size_t _elementSizeInBytes,
-            void* _pinMetadata
+            void* _pinMetadata,
+            size_t maxEvents = 0
         ) {
             type = _type;
             name = _name;
@@ -134,7 +225,7 @@ namespace seam::pins {
             flags = (PinFlags)(flags | PinFlags::Input | PinFlags::EventQueue);
             pinMetadata = _pinMetadata;
             sizeInBytes = _elementSizeInBytes;
-            buffer = malloc(sizeInBytes * MAX_EVENTS);
+            extras.Get().events = std::make_shared<EventQueue>(sizeInBytes, 256, maxEvents);
         }
 
         PinInput(const std::string_view _name,
@@ -150,45 +241,91 @@ namespace seam::pins {
             node = _node;
             flags = (PinFlags)(flags | PinFlags::Input);
             pinMetadata = _pinMetadata;
-            onValueChanged = std::move(_onValueChanged);
+            SetOnValueChanged(std::move(_onValueChanged));
             sizeInBytes = 0;
         }
 
         ~PinInput();
 
         /// @brief Get a pointer to the input pin's raw buffer data.
+        /// If the pin is aliasing pushed data, that data is copied into the buffer first,
+        /// so whatever is written to the returned pointer never reaches the pusher.
         /// @param size will be set to the size of the returned array
         /// @return An opaque pointer to the beginning of the buffer the input Pin points to.
         inline void* Buffer(size_t& size) {
+            if (alias != nullptr) {
+                Detach();
+            }
             size = totalElements;
             return ((char*)buffer) + offset;
         }
 
+        /// @brief Read-only access to the input pin's values, which may be the pushing output's data;
+        /// see PinFlags::Aliasable. Valid until the next push to this pin.
+        /// @param size will be set to the size of the returned array
+        inline const void* ReadBuffer(size_t& size) {
+            size = totalElements;
+            return alias != nullptr ? alias : ((char*)buffer) + offset;
+        }
+
+        /// @brief Point ReadBuffer() at pushed data instead of copying it.
+        /// Only valid when the data has the same type and layout as the pin's buffer.
+        inline void Alias(const void* data) {
+            alias = data;
+        }
+
+        inline bool IsAliased() {
+            return alias != nullptr;
+        }
+
+        /// @brief Copy aliased data into the pin's own buffer and stop aliasing.
+        void Detach();
+
+        /// @brief Stop aliasing without copying, for when the aliased data is gone.
+        inline void DropAlias() {
+            alias = nullptr;
+        }
+
         void* PinMetadata() {
             return pinMetadata;
         }
 
+        /// @brief Queue events for the pin's Node to drain with GetEvents().
+        /// Safe to call from any thread, for instance straight from a MIDI or OSC callback;
+        /// the caller should dirty the pin's Node afterwards so it gets updated.
+        /// @return The number of events queued; less than numEvents only if the pin has a maximum and reached it,
+        /// in which case the rest are counted by DroppedEvents().
         template <typename T>
-        inline void PushEvents(T* events, size_t numEvents) {
+        inline size_t PushEvents(T* _events, size_t numEvents) {
+            assert(sizeof(T) == sizeInBytes);
+            return PushEventBytes(_events, numEvents);
+        }
+
+        /// @brief Untyped PushEvents(), for events which were copied elsewhere before being pushed.
+        inline size_t PushEventBytes(const void* _events, size_t numEvents) {
             assert((flags & PinFlags::EventQueue) == PinFlags::EventQueue);
-            size_t offset = totalElements * sizeof(T);
-            memcpy_s(((T*)buffer) + offset, sizeInBytes * MAX_EVENTS - offset, events, numEvents * sizeof(T));
-            totalElements = std::min(MAX_EVENTS, totalElements + numEvents);
+            return extras.Find()->events->Push(_events, numEvents);
         }
 
+        /// @brief Events dropped because the pin's queue was at its maximum; always 0 for pins without one.
+        inline uint64_t DroppedEvents() {
+            PinInputExtras* e = extras.Find();
+            return e != nullptr && e->events != nullptr ? e->events->Dropped() : 0;
+        }
+
+        /// @brief Get every event pushed so far which hasn't been cleared yet.
+        /// Should only be called from the pin's Node.
+        /// @param size will be set to the number of events in the returned array
         inline void* GetEvents(size_t& size) {
             assert((flags & PinFlags::EventQueue) == PinFlags::EventQueue);
-            size = totalElements;
-            return buffer;
+            return extras.Find()->events->Drain(size);
         }
 
-        inline void ClearEvents(size_t expected) {
+        /// @brief Drop the events returned by GetEvents(), once they've been handled.
+        /// Events pushed since GetEvents() was called are kept for the next update.
+        inline void ClearEvents(size_t handled) {
             assert((flags & PinFlags::EventQueue) == PinFlags::EventQueue);
-            // This is just a check in case any multithreading funkiness happens;
-            // Pins shouldn't be pushed to outside of an update loop, or events WILL be lost.
-            assert(expected == totalElements);
-            memset(buffer, 0, totalElements * sizeInBytes);
-            totalElements = 0;
+            extras.Find()->events->Consume(handled);
         }
 
         /// @brief Bytes needed to contain the input's buffer
@@ -198,49 +335,87 @@ namespace seam::pins {
 
         inline void SetBuffer(void* buff, size_t elements) {
             buffer = buff;
+            // Keep the aliased values in the new buffer; the old one may already be gone.
+            if (alias != nullptr) {
+                totalElements = std::min(totalElements, elements);
+                Detach();
+            }
             totalElements = elements;
         }
 
         inline void OnValueChanged() {
-            if (onValueChanged) {
-                onValueChanged();
+            PinInputExtras* e = extras.Find();
+            if (e != nullptr && e->onValueChanged) {
+                e->onValueChanged();
             }
+            changedFirst = 0;
+            changedCount = SIZE_MAX;
+        }
+
+        /// @brief Narrow the elements reported by ChangedRange() until the next OnValueChanged().
+        inline void SetChangedRange(size_t first, size_t count) {
+            changedFirst = first;
+            changedCount = count;
+        }
+
+        /// @brief The elements a push is changing, for value changing and changed callbacks 
+        /// which only need to process what changed. Is the whole buffer unless the push was ranged.
+        inline ElementRange ChangedRange() {
+            const size_t first = std::min(changedFirst, totalElements);
+            return ElementRange { first, std::min(changedCount, totalElements - first) };
         }
 
         inline void SetOnValueChanged(ValueChangedCallback&& cb) {
-            onValueChanged = std::move(cb);
+            if (cb || extras.Find() != nullptr) {
+                extras.Get().onValueChanged = std::move(cb);
+            }
         }
 
         inline void OnValueChanging() {
-            if (onValueChanging) {
-                onValueChanging();
+            PinInputExtras* e = extras.Find();
+            if (e != nullptr && e->onValueChanging) {
+                e->onValueChanging();
             }
         }
 
         inline void SetOnValueChanging(ValueChangingCallback&& cb) {
-            onValueChanging = std::move(cb);
+            if (cb || extras.Find() != nullptr) {
+                extras.Get().onValueChanging = std::move(cb);
+            }
         }
 
         inline void SetOnConnected(ConnectedCallback&& _onConnected) {
-            onConnected = std::move(_onConnected);
+            if (_onConnected || extras.Find() != nullptr) {
+                extras.Get().onConnected = std::move(_onConnected);
+            }
         }
 
         inline void OnConnected(PinConnectedArgs args) {
-            if (onConnected) {
-                onConnected(args);
+            PinInputExtras* e = extras.Find();
+            if (e != nullptr && e->onConnected) {
+                e->onConnected(args);
             }
         }
 
         inline void SetOnDisconnected(DisconnectedCallback&& _onDisconnected) {
-            onDisconnected = std::move(_onDisconnected);
+            if (_onDisconnected || extras.Find() != nullptr) {
+                extras.Get().onDisconnected = std::move(_onDisconnected);
+            }
         }
 
         inline void OnDisconnected(PinConnectedArgs args) {
-            if (onDisconnected) {
-                onDisconnected(args);
+            PinInputExtras* e = extras.Find();
+            if (e != nullptr && e->onDisconnected) {
+                e->onDisconnected(args);
             }
         }
 
+        /// @return Whether any of the pin's callbacks are set.
+        inline bool HasCallbacks() {
+            PinInputExtras* e = extras.Find();
+            return e != nullptr && (e->onConnected || e->onDisconnected || e->onValueChanging || e->onValueChanged);
+        }
+
         PinInput* PinInputs(size_t &size) override {
             size = childPins.size();
             return childPins.data();
@@ -264,20 +439,53 @@ namespace seam::pins {
 
         void SetNumCoords(uint16_t _numCoords);
 
+        inline PinReducer Reducer() {
+            return reducer;
+        }
+
+        /// @brief Only the basic pin types can be summed or compared;
+        /// other types fall back to PinReducer::LastWrite, except for PinReducer::Concat.
+        void SetReducer(PinReducer _reducer);
+
+        inline bool IsConnected() {
+            return !connections.empty();
+        }
+
+        /// @brief Called by the SeamGraph when an output pin is connected to this pin.
+        void AddConnection(PinOutput* pinOut);
+
+        /// @brief Called by the SeamGraph when an output pin is disconnected from this pin.
+        void RemoveConnection(PinOutput* pinOut);
+
+        /// @brief Convert pushed elements into this pin's slot for the pushing output,
+        /// then merge every connection's slot into the pin's buffer with its reducer.
+        /// @param convert The connection's multi converter.
+        void ConvertReduced(PinOutput* pinOut, ConvertMulti convert, ConvertMultiArgs args);
+
+        /// @brief Heap memory the pin's metadata takes up, besides the pin itself and its children:
+        /// its name, extras, connections, reducer state, event queue and unused child capacity.
+        /// Doesn't count the pin's buffer, or whatever the callbacks' std::functions allocate for their captures.
+        size_t MetadataHeapBytes();
+
         /// push pattern id
         PushId push_id;
 
-        // the output pin which connects to this pin
-        // can be nullptr
-        PinOutput* connection = nullptr;
+        /// @brief The output pins which connect to this pin, in the order they were connected.
+        std::vector<PinOutput*> connections;
+
+        /// @brief Set by the SeamGraph while pushes to this pin are held back for a pipelined update;
+        /// see StagedPushes. Pushes go straight to the pin's buffer while this is nullptr.
+        StagedPushes* staged = nullptr;
 
         friend class pins::VectorPinInput;
 
     private:
-        const static size_t MAX_EVENTS;
-
         void* buffer = nullptr;
 
+        /// @brief Pushed data read in place of the buffer, set by Alias().
+        /// Has totalElements elements, tightly packed.
+        const void* alias = nullptr;
+
         /// @brief The buffer points to this many elements starting at offset and separated by the stride.
         size_t totalElements = 0;
 
@@ -292,17 +500,22 @@ namespace seam::pins {
         /// @brief The number of bytes to skip to reach the first element pointed to by the buffer.
         size_t offset = 0;
 
-        /// @brief The number of values each element contains. For instance, vec2 should have 2, ivec4 should have 4.
-        uint16_t numCoords = 1;
+        /// @brief Set by SetChangedRange(); SIZE_MAX elements means the rest of the buffer.
+        size_t changedFirst = 0;
+        size_t changedCount = SIZE_MAX;
 
         std::vector<PinInput> childPins;
 
-        ConnectedCallback onConnected;
-        DisconnectedCallback onDisconnected;
-        ValueChangingCallback onValueChanging;
-        ValueChangedCallback onValueChanged;
+        /// @brief Callbacks, reducer state and event queues, allocated the first time any of them are set.
+        /// Vector pins and uniform structs can have thousands of children which use none of them.
+        Boxed<PinInputExtras> extras;
 
         // Should be set by pin types which have GUI metadata for mins/maxes etc.
-        void* pinMetadata;
+        void* pinMetadata = nullptr;
+
+        /// @brief The number of values each element contains. For instance, vec2 should have 2, ivec4 should have 4.
+        uint16_t numCoords = 1;
+
+        PinReducer reducer = PinReducer::LastWrite;
     };
 }
\ No newline at end of file
@@ -7,7 +7,9 @@ using namespace seam::pins;
 PinOutput::~PinOutput() {
     // Clean up any existing pin input references to this output pin.
     for (auto& conn : connections) {
-        conn.pinIn->connection = nullptr;
+        conn.pinIn->RemoveConnection(this);
+        // Pushed data may have been owned by this pin's Node, which is going away too.
+        conn.pinIn->DropAlias();
     }
 }
 
@@ -25,7 +27,8 @@ void PinOutput::SetNumCoords(uint16_t newNumCoords) {
 }
 
 void PinOutput::Reconnect(seam::pins::PushPatterns* pushPatterns) {
-    if (!onConnected) {
+    PinOutputExtras* e = extras.Find();
+    if (e == nullptr || !e->onConnected) {
         return;
     }
 
@@ -36,4 +39,13 @@ void PinOutput::Reconnect(seam::pins::PushPatterns* pushPatterns) {
         args.pinIn = conn.pinIn;
         OnConnected(args);
     }
+}
+
+size_t PinOutput::MetadataHeapBytes() {
+    size_t bytes = StringHeapBytes(name) + connections.capacity() * sizeof(PinConnection)
+        + (childPins.capacity() - childPins.size()) * sizeof(PinOutput);
+    if (extras.Find() != nullptr) {
+        bytes += sizeof(PinOutputExtras);
+    }
+    return bytes;
 }
\ No newline at end of file
@@ -5,11 +5,18 @@
 #include "seam/pins/pinBase.h"
 #include "seam/pins/pinConnection.h"
 #include "seam/pins/iOutPinnable.h"
+#include "seam/containers/boxed.h"
 
 namespace seam::pins {
     class PushPatterns;
 
-    struct PinOutput final : public Pin, public IOutPinnable {
+    /// @brief The parts of a PinOutput which most pins never use; see PinOutput::extras.
+    struct PinOutputExtras {
+        ConnectedCallback onConnected;
+        DisconnectedCallback onDisconnected;
+    };
+
+    struct PinOutput : public Pin, public IOutPinnable {
         ~PinOutput();
 
         PinOutput* PinOutputs(size_t& size) {
@@ -29,22 +36,28 @@ namespace seam::pins {
         void SetNumCoords(uint16_t newNumCoords);
 
         inline void SetOnConnected(ConnectedCallback&& _onConnected) {
-            onConnected = std::move(_onConnected);
+            if (_onConnected || extras.Find() != nullptr) {
+                extras.Get().onConnected = std::move(_onConnected);
+            }
         }
 
         inline void OnConnected(PinConnectedArgs args) {
-            if (onConnected) {
-                onConnected(args);
+            PinOutputExtras* e = extras.Find();
+            if (e != nullptr && e->onConnected) {
+                e->onConnected(args);
             }
         }
 
         inline void SetOnDisconnected(DisconnectedCallback&& _onDisconnected) {
-            onDisconnected = std::move(_onDisconnected);
+            if (_onDisconnected || extras.Find() != nullptr) {
+                extras.Get().onDisconnected = std::move(_onDisconnected);
+            }
         }
 
         inline void OnDisconnected(PinConnectedArgs args) {
-            if (onDisconnected) {
-                onDisconnected(args);
+            PinOutputExtras* e = extras.Find();
+            if (e != nullptr && e->onDisconnected) {
+                e->onDisconnected(args);
             }
         }
 
@@ -52,13 +65,24 @@ namespace seam::pins {
         /// Useful for FBO pins where texture bindings only need to run when the FBO itself changes (rather than its contents)
         void Reconnect(PushPatterns* pushPatterns);
 
+        /// @return Whether any of the pin's callbacks are set.
+        inline bool HasCallbacks() {
+            PinOutputExtras* e = extras.Find();
+            return e != nullptr && (e->onConnected || e->onDisconnected);
+        }
+
+        /// @brief Heap memory the pin's metadata takes up, besides the pin itself and its children:
+        /// its name, extras, connections and unused child capacity.
+        /// Doesn't count whatever the callbacks' std::functions allocate for their captures.
+        size_t MetadataHeapBytes();
+
         std::vector<seam::pins::PinConnection> connections;
         std::vector<PinOutput> childPins;
 
     private:
-        uint16_t numCoords = 1;
+        /// @brief Allocated the first time a callback is set.
+        Boxed<PinOutputExtras> extras;
 
-        ConnectedCallback onConnected;
-        DisconnectedCallback onDisconnected;
+        uint16_t numCoords = 1;
     };
 }
\ No newline at end of file
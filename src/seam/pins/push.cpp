@@ -94,6 +94,60 @@ void PushPatterns::SetDefault(std::string_view name) {
 	SetDefault(SCHash(name));
 }
 
+void PushPatterns::BeginChange(PinInput* pinIn, size_t first, size_t count, PushTransaction* tx) {
+	if (tx != nullptr) {
+		tx->Record(pinIn, first, count);
+	} else {
+		pinIn->SetChangedRange(first, count);
+		pinIn->OnValueChanging();
+	}
+}
+
+void PushPatterns::EndChange(PinInput* pinIn, PushTransaction* tx) {
+	if (tx == nullptr) {
+		pinIn->OnValueChanged();
+	}
+}
+
+PushTransaction::Pending* PushTransaction::Find(PinInput* pinIn) {
+	for (auto& p : pending) {
+		if (p.pinIn == pinIn) {
+			return &p;
+		}
+	}
+	return nullptr;
+}
+
+void PushTransaction::Record(PinInput* pinIn, size_t first, size_t count) {
+	const size_t end = first + std::min(count, SIZE_MAX - first);
+	Pending* p = Find(pinIn);
+	if (p == nullptr) {
+		pending.push_back(Pending { pinIn, first, end });
+		pinIn->SetChangedRange(first, count);
+		pinIn->OnValueChanging();
+	} else {
+		// Report one range spanning every push, so callbacks see everything that changed.
+		p->first = std::min(p->first, first);
+		p->end = std::max(p->end, end);
+		pinIn->SetChangedRange(p->first, p->end - p->first);
+	}
+}
+
+void PushTransaction::RecordFlow(PinInput* pinIn) {
+	if (Find(pinIn) == nullptr) {
+		pending.push_back(Pending { pinIn, 0, SIZE_MAX });
+	}
+}
+
+void PushTransaction::Flush() {
+	// Callbacks could push more, so take the pending inputs first.
+	std::vector<Pending> flushing = std::move(pending);
+	pending.clear();
+	for (auto& p : flushing) {
+		p.pinIn->OnValueChanged();
+	}
+}
+
 #if RUN_DOCTEST
 namespace {
 	template <typename T>
@@ -164,4 +218,51 @@ TEST_CASE("Testing PushPatterns behaviors") {
 	}
 
 }
+
+TEST_CASE("Test push transactions call each input's callbacks once, with the merged changed range") {
+	std::vector<float> values(8, 0.f);
+	PinInput pinIn = SetupInputPin(PinType::Float, nullptr, values.data(), values.size(), "in");
+
+	int changing = 0;
+	int changed = 0;
+	ElementRange range { 0, 0 };
+	pinIn.SetOnValueChanging([&changing]() { changing++; });
+	pinIn.SetOnValueChanged([&]() {
+		changed++;
+		range = pinIn.ChangedRange();
+	});
+	int triggered = 0;
+	PinInput flowIn = SetupInputFlowPin(nullptr, [&triggered]() { triggered++; }, "flow");
+
+	PushPatterns pushPatterns;
+	{
+		PushTransaction tx(&pushPatterns);
+		tx.Record(&pinIn, 5, 2);
+		tx.Record(&pinIn, 1, 1);
+		tx.Record(&pinIn, 2, 1);
+		tx.RecordFlow(&flowIn);
+		tx.RecordFlow(&flowIn);
+		CHECK(changing == 1);
+		CHECK(changed == 0);
+		CHECK(triggered == 0);
+		CHECK(pinIn.ChangedRange().first == 1);
+		CHECK(pinIn.ChangedRange().count == 6);
+	}
+	CHECK(changing == 1);
+	CHECK(changed == 1);
+	CHECK(triggered == 1);
+	CHECK(range.first == 1);
+	CHECK(range.count == 6);
+
+	// Once flushed, the next push starts a new change.
+	PushTransaction tx(&pushPatterns);
+	tx.Record(&pinIn, 3, 1);
+	tx.Flush();
+	CHECK(changing == 2);
+	CHECK(changed == 2);
+	CHECK(range.first == 3);
+	CHECK(range.count == 1);
+	tx.Flush();
+	CHECK(changed == 2);
+}
 #endif // RUN_DOCTEST
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "seam/pins/pinConnection.h"
 #include "seam/pins/pinOutput.h"
 #include "seam/pins/pinInput.h"
+#include "seam/pins/stagedPushes.h"
 #include "seam/hash.h"
 #include "seam/flagsHelper.h"
 
@@ -48,6 +49,77 @@ namespace seam::pins {
 		}
 	};
 
+	class PushPatterns;
+
+	template <typename T>
+	class TypedPinOutput;
+
+	/// @brief Batches a Node's pushes so each input pin's value changed callback fires once, at Flush(),
+	/// no matter how many pushes reached it. Use it when a Node pushes to the same inputs several times in an update,
+	/// or pushes to many inputs of one downstream Node whose callbacks do expensive work (like uploading shader uniforms).
+	/// Values are still converted as they're pushed, so the last write to each element wins;
+	/// ChangedRange() spans every element pushed to the input since the transaction started.
+	/// Flushes when it goes out of scope. Each thread pushing needs its own transaction.
+	class PushTransaction {
+	public:
+		PushTransaction(PushPatterns* _pushPatterns) : pushPatterns(_pushPatterns) { }
+
+		~PushTransaction() {
+			Flush();
+		}
+
+		PushTransaction(const PushTransaction&) = delete;
+		PushTransaction& operator=(const PushTransaction&) = delete;
+
+		/// @brief Same as PushPatterns::Push(), with value changed callbacks deferred until Flush().
+		template <typename T>
+		void Push(PinOutput& pinOut, T* data, size_t numElements);
+
+		/// @brief Same as PushPatterns::PushSingle(), with value changed callbacks deferred until Flush().
+		template <typename T>
+		bool PushSingle(PinOutput& pinOut, T* data, size_t index = 0);
+
+		/// @brief Same as PushPatterns::PushRange(), with value changed callbacks deferred until Flush().
+		template <typename T>
+		bool PushRange(PinOutput& pinOut, T* data, size_t first, size_t count);
+
+		template <typename T>
+		void Push(TypedPinOutput<T>& pinOut, T* data, size_t numElements);
+
+		template <typename T>
+		bool PushSingle(TypedPinOutput<T>& pinOut, T* data, size_t index = 0);
+
+		template <typename T>
+		bool PushRange(TypedPinOutput<T>& pinOut, T* data, size_t first, size_t count);
+
+		/// @brief Same as PushPatterns::PushFlow(), with value changed callbacks deferred until Flush().
+		void PushFlow(const PinOutput& pinOut);
+
+		/// @brief Call the value changed callback of every input pushed to since the last Flush(), 
+		/// in the order they were first pushed to.
+		void Flush();
+
+		/// @brief Called before a push changes elements [first, first + count) of pinIn.
+		/// Calls the input's value changing callback if this is the transaction's first push to it.
+		void Record(PinInput* pinIn, size_t first, size_t count);
+
+		/// @brief Called when a flow input is triggered, which has no value changing callback.
+		void RecordFlow(PinInput* pinIn);
+
+	private:
+		struct Pending {
+			PinInput* pinIn;
+			size_t first;
+			size_t end;
+		};
+
+		/// @brief Pending inputs are searched linearly; a Node only pushes to a handful of inputs.
+		Pending* Find(PinInput* pinIn);
+
+		PushPatterns* pushPatterns;
+		std::vector<Pending> pending;
+	};
+
 	class PushPatterns {
 	public:
 		PushPatterns();
@@ -63,10 +135,109 @@ namespace seam::pins {
 		/// @param numElements The number of elements pointed to by the data pointer.
 		template <typename T>
 		void Push(PinOutput& pinOut, T* data, size_t numElements) {
+			PushTo(pinOut, data, numElements, nullptr);
+		}
+
+		/// @brief Push a single data point. Useful if data is not stored linearly,
+		/// or if there's only one data point to push.
+		/// @param pinOut The output pin to push data from.
+		/// @param data Pointer to the data to be pushed.
+		/// @param index The channel index to push to in input pins.
+		/// @return True if data was pushed at this index. Depending on what your Node does,
+		/// you might want to bail out of pushing once no data is sent.
+		template <typename T>
+		bool PushSingle(PinOutput& pinOut, T* data, size_t index = 0) {
+			return PushSingleTo(pinOut, data, index, nullptr);
+		}
+
+		/// @brief Push a contiguous range of elements, so that only that slice of each input pin is converted.
+		/// Value changing and changed callbacks can get the range from PinInput::ChangedRange().
+		/// Useful for large pins where only a few elements change each update.
+		/// @param pinOut The output pin to push data from.
+		/// @param data Pointer to the first element of the range, which is element "first" of the output.
+		/// @param first The channel index of the first pushed element in input pins.
+		/// @param count The number of elements pointed to by the data pointer.
+		/// @return True if any data was pushed.
+		template <typename T>
+		bool PushRange(PinOutput& pinOut, T* data, size_t first, size_t count) {
+			return PushRangeTo(pinOut, data, first, count, nullptr);
+		}
+
+		/// @brief Push from an output whose type is known at compile time. 
+		/// Inputs with the same layout get an inlined copy instead of a converter call.
+		template <typename T>
+		void Push(TypedPinOutput<T>& pinOut, T* data, size_t numElements) {
+			assert(pinOut.NumCoords() == TypedPinOutput<T>::Traits::numCoords);
+			PushTo<T, true>(pinOut, data, numElements, nullptr);
+		}
+
+		template <typename T>
+		bool PushSingle(TypedPinOutput<T>& pinOut, T* data, size_t index = 0) {
+			assert(pinOut.NumCoords() == TypedPinOutput<T>::Traits::numCoords);
+			return PushSingleTo<T, true>(pinOut, data, index, nullptr);
+		}
+
+		template <typename T>
+		bool PushRange(TypedPinOutput<T>& pinOut, T* data, size_t first, size_t count) {
+			assert(pinOut.NumCoords() == TypedPinOutput<T>::Traits::numCoords);
+			return PushRangeTo<T, true>(pinOut, data, first, count, nullptr);
+		}
+
+		void PushFlow(const PinOutput& pinOut) {
+			PushFlowTo(pinOut, nullptr);
+		}
+
+		Pusher& Get(PushId push_id);
+		Pusher& Get(std::string_view name);
+
+		Pusher& Default();
+		void SetDefault(PushId push_id);
+		void SetDefault(std::string_view name);
+		
+	private:
+		friend class PushTransaction;
+
+		/// @brief Start changing elements of an input; its value changing callback is called unless tx already did.
+		static void BeginChange(PinInput* pinIn, size_t first, size_t count, PushTransaction* tx);
+
+		/// @brief Finish changing an input; its value changed callback is called now, or when tx flushes.
+		static void EndChange(PinInput* pinIn, PushTransaction* tx);
+
+		/// @brief If pinOut is a TypedPinOutput<T> and the input has the same layout, 
+		/// copy count elements into the input starting at element first.
+		/// @return false if the elements still need to be converted.
+		template <bool Typed, typename T>
+		static bool CopySameLayout(PinConnection& conn, T* data, size_t first, size_t count) {
+			if constexpr (Typed) {
+				if (conn.sameLayout) {
+					size_t dstSize;
+					T* dst = (T*)conn.pinIn->Buffer(dstSize);
+					if (first < dstSize) {
+						std::copy_n(data, std::min(count, dstSize - first), dst + first);
+					}
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/// @tparam Typed True if pinOut is a TypedPinOutput<T>, so T matches the output's layout.
+		template <typename T, bool Typed = false>
+		void PushTo(PinOutput& pinOut, T* data, size_t numElements, PushTransaction* tx) {
 			const bool isEventQueuePin = flags::AreRaised(pinOut.flags, pins::PinFlags::EventQueue);
 			// Event queue pins don't use push patterns, they just push to the input pins' vectors
 			if (isEventQueuePin) {
 				for (auto& conn : pinOut.connections) {
+					// The input's Node is updated on another thread; it gets the events once they're published.
+					if (conn.pinIn->staged != nullptr) {
+						if (flags::AreRaised(conn.pinIn->flags, pins::PinFlags::EventQueue)) {
+							conn.pinIn->staged->StageEvents(data, numElements, sizeof(T));
+						} else {
+							conn.pinIn->staged->StageFlow();
+						}
+						continue;
+					}
+
 					// Dirty the input node.
 					conn.pinIn->node->SetDirty();
 
@@ -76,51 +247,66 @@ namespace seam::pins {
 						conn.pinIn->PushEvents(data, numElements);
 					} else {
 						assert(conn.pinIn->type == PinType::Flow);
-						conn.pinIn->OnValueChanged();
+						if (tx != nullptr) {
+							tx->RecordFlow(conn.pinIn);
+						} else {
+							conn.pinIn->OnValueChanged();
+						}
 					}
 				}
 			} else {
 				for (auto& conn : pinOut.connections) {
+					if (conn.pinIn->staged != nullptr) {
+						conn.pinIn->staged->StageMulti(&conn, data, pinOut.NumCoords(), numElements,
+							numElements * SourceElementSize<T>(pinOut));
+						continue;
+					}
+
 					// Dirty the input node
 					conn.pinIn->node->SetDirty();
 
-					ConvertMultiArgs args(data, pinOut.NumCoords(), numElements, conn.pinIn);
-
-					conn.pinIn->OnValueChanging();
-					conn.convertMulti(args);
-					conn.pinIn->OnValueChanged();
+					size_t dstSize;
+					conn.pinIn->ReadBuffer(dstSize);
+					BeginChange(conn.pinIn, 0, numElements, tx);
+					if (conn.aliasable && numElements >= dstSize) {
+						// Same type and layout, so the input can read the pushed data where it is.
+						conn.pinIn->Alias(data);
+					} else if (!CopySameLayout<Typed>(conn, data, 0, numElements)) {
+						// Converting writes to the input's own buffer, which detaches it from anything it aliased before.
+						conn.Convert(ConvertMultiArgs(data, pinOut.NumCoords(), numElements, conn.pinIn));
+					}
+					EndChange(conn.pinIn, tx);
 				}
 			}
 		}
 
-		/// @brief Push a single data point. Useful if data is not stored linearly,
-		/// or if there's only one data point to push.
-		/// @param pinOut The output pin to push data from.
-		/// @param data Pointer to the data to be pushed.
-		/// @param index The channel index to push to in input pins.
-		/// @return True if data was pushed at this index. Depending on what your Node does,
-		/// you might want to bail out of pushing once no data is sent.
-		template <typename T>
-		bool PushSingle(PinOutput& pinOut, T* data, size_t index = 0) {
+		template <typename T, bool Typed = false>
+		bool PushSingleTo(PinOutput& pinOut, T* data, size_t index, PushTransaction* tx) {
 			bool pushed = false;
 
 			// Use Push() instead of PushSingle() for event queue pins!
 			assert(!flags::AreRaised(pinOut.flags, pins::PinFlags::EventQueue));
 			for (auto& conn : pinOut.connections) {
-				conn.pinIn->node->SetDirty();
-
-				// Calculate the input destination offset.
 				size_t dstSize;
-				char* dst = (char*)conn.pinIn->Buffer(dstSize);
+				conn.pinIn->ReadBuffer(dstSize);
 
-				if (index < dstSize) {
-					dst = dst + index * conn.pinIn->Stride();
-					ConvertSingleArgs args(data, pinOut.NumCoords(), 
-						dst, conn.pinIn->NumCoords(), conn.pinIn);
+				if (conn.pinIn->staged != nullptr) {
+					if (index < dstSize) {
+						conn.pinIn->staged->StageSingle(&conn, data, pinOut.NumCoords(), index,
+							SourceElementSize<T>(pinOut));
+						pushed = true;
+					}
+					continue;
+				}
 
-					conn.pinIn->OnValueChanging();
-					conn.convertSingle(args);
-					conn.pinIn->OnValueChanged();
+				conn.pinIn->node->SetDirty();
+
+				if (index < dstSize) {
+					BeginChange(conn.pinIn, index, 1, tx);
+					if (!CopySameLayout<Typed>(conn, data, index, 1)) {
+						conn.ConvertAt(data, pinOut.NumCoords(), index);
+					}
+					EndChange(conn.pinIn, tx);
 					
 					pushed = true;
 				}
@@ -129,24 +315,105 @@ namespace seam::pins {
 			return pushed;
 		}
 
-		void PushFlow(const PinOutput& pinOut) {
+		template <typename T, bool Typed = false>
+		bool PushRangeTo(PinOutput& pinOut, T* data, size_t first, size_t count, PushTransaction* tx) {
+			bool pushed = false;
+
+			// Use Push() instead of PushRange() for event queue pins!
+			assert(!flags::AreRaised(pinOut.flags, pins::PinFlags::EventQueue));
+			for (auto& conn : pinOut.connections) {
+				size_t dstSize;
+				conn.pinIn->ReadBuffer(dstSize);
+				// Flow inputs have no elements, but still get triggered.
+				if (count == 0 || (first >= dstSize && conn.pinIn->type != PinType::Flow)) {
+					continue;
+				}
+				pushed = true;
+
+				if (conn.pinIn->staged != nullptr) {
+					conn.pinIn->staged->StageMulti(&conn, data, pinOut.NumCoords(), count,
+						count * SourceElementSize<T>(pinOut), first);
+					continue;
+				}
+
+				conn.pinIn->node->SetDirty();
+
+				// Converting writes to the input's own buffer, which detaches it from anything it aliased before.
+				BeginChange(conn.pinIn, first, count, tx);
+				if (!CopySameLayout<Typed>(conn, data, first, count)) {
+					conn.Convert(ConvertMultiArgs(data, pinOut.NumCoords(), count, conn.pinIn, first));
+				}
+				EndChange(conn.pinIn, tx);
+			}
+
+			return pushed;
+		}
+
+		void PushFlowTo(const PinOutput& pinOut, PushTransaction* tx) {
 			assert(pinOut.type == PinType::Flow);
 			for (auto& conn : pinOut.connections) {
-				conn.pinIn->OnValueChanged();
+				if (conn.pinIn->staged != nullptr) {
+					conn.pinIn->staged->StageFlow();
+				} else if (tx != nullptr) {
+					tx->RecordFlow(conn.pinIn);
+				} else {
+					conn.pinIn->OnValueChanged();
+				}
 			}
 		}
 
-		Pusher& Get(PushId push_id);
-		Pusher& Get(std::string_view name);
+		/// @brief Bytes a convert reads per pushed element, so staged pushes copy exactly that much.
+		template <typename T>
+		static size_t SourceElementSize(PinOutput& pinOut) {
+			switch (pinOut.type) {
+			case PinType::Bool:
+			case PinType::Char:
+			case PinType::Int:
+			case PinType::Uint:
+			case PinType::Float:
+				return PinTypeToElementSize(pinOut.type) * pinOut.NumCoords();
+			default:
+				return sizeof(T);
+			}
+		}
 
-		Pusher& Default();
-		void SetDefault(PushId push_id);
-		void SetDefault(std::string_view name);
-		
-	private:
 		// push patterns are sorted by pusher id
 		std::vector<Pusher> push_patterns;
 
 		Pusher* default_pattern = nullptr;
 	};
+
+	template <typename T>
+	void PushTransaction::Push(PinOutput& pinOut, T* data, size_t numElements) {
+		pushPatterns->PushTo(pinOut, data, numElements, this);
+	}
+
+	template <typename T>
+	bool PushTransaction::PushSingle(PinOutput& pinOut, T* data, size_t index) {
+		return pushPatterns->PushSingleTo(pinOut, data, index, this);
+	}
+
+	template <typename T>
+	bool PushTransaction::PushRange(PinOutput& pinOut, T* data, size_t first, size_t count) {
+		return pushPatterns->PushRangeTo(pinOut, data, first, count, this);
+	}
+
+	template <typename T>
+	void PushTransaction::Push(TypedPinOutput<T>& pinOut, T* data, size_t numElements) {
+		pushPatterns->PushTo<T, true>(pinOut, data, numElements, this);
+	}
+
+	template <typename T>
+	bool PushTransaction::PushSingle(TypedPinOutput<T>& pinOut, T* data, size_t index) {
+		return pushPatterns->PushSingleTo<T, true>(pinOut, data, index, this);
+	}
+
+	template <typename T>
+	bool PushTransaction::PushRange(TypedPinOutput<T>& pinOut, T* data, size_t first, size_t count) {
+		return pushPatterns->PushRangeTo<T, true>(pinOut, data, first, count, this);
+	}
+
+	inline void PushTransaction::PushFlow(const PinOutput& pinOut) {
+		pushPatterns->PushFlowTo(pinOut, this);
+	}
 }
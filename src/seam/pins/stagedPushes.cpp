@@ -0,0 +1,82 @@
+#include <algorithm>
+#include <cstddef>
+
+#include "seam/pins/stagedPushes.h"
+#include "seam/pins/pinInput.h"
+#include "seam/pins/pinConnection.h"
+#include "seam/nodes/iNode.h"
+
+using namespace seam::pins;
+
+size_t StagedPushes::Append(const void* src, size_t bytes) {
+    const size_t alignment = alignof(std::max_align_t);
+    const size_t offset = (data.size() + alignment - 1) & ~(alignment - 1);
+    data.resize(offset + bytes);
+    std::copy((const char*)src, (const char*)src + bytes, data.data() + offset);
+    return offset;
+}
+
+void StagedPushes::StageMulti(PinConnection* conn, const void* src, uint16_t srcNumCoords, size_t srcSize, size_t srcBytes,
+    size_t dstFirst) {
+    pushes.push_back(Staged { Kind::Multi, srcNumCoords, conn, srcSize, Append(src, srcBytes), dstFirst });
+}
+
+void StagedPushes::StageSingle(PinConnection* conn, const void* src, uint16_t srcNumCoords, size_t index, size_t srcBytes) {
+    pushes.push_back(Staged { Kind::Single, srcNumCoords, conn, index, Append(src, srcBytes), 0 });
+}
+
+void StagedPushes::StageEvents(const void* events, size_t numEvents, size_t eventSize) {
+    pushes.push_back(Staged { Kind::Events, 0, nullptr, numEvents, Append(events, numEvents * eventSize), 0 });
+}
+
+void StagedPushes::StageFlow() {
+    pushes.push_back(Staged { Kind::Flow, 0, nullptr, 0, 0, 0 });
+}
+
+void StagedPushes::Publish() {
+    if (pushes.empty()) {
+        return;
+    }
+
+    // The pin was destroyed after these were pushed.
+    if (pinIn == nullptr) {
+        pushes.clear();
+        data.clear();
+        return;
+    }
+
+    for (const auto& p : pushes) {
+        char* src = data.data() + p.dataOffset;
+        switch (p.kind) {
+        case Kind::Multi: {
+            pinIn->SetChangedRange(p.dstFirst, p.count);
+            pinIn->OnValueChanging();
+            p.conn->Convert(ConvertMultiArgs(src, p.srcNumCoords, p.count, pinIn, p.dstFirst));
+            pinIn->OnValueChanged();
+            break;
+        }
+        case Kind::Single: {
+            size_t dstSize;
+            pinIn->ReadBuffer(dstSize);
+            if (p.count < dstSize) {
+                pinIn->SetChangedRange(p.count, 1);
+                pinIn->OnValueChanging();
+                p.conn->ConvertAt(src, p.srcNumCoords, p.count);
+                pinIn->OnValueChanged();
+            }
+            break;
+        }
+        case Kind::Events:
+            pinIn->PushEventBytes(src, p.count);
+            break;
+        case Kind::Flow:
+            pinIn->OnValueChanged();
+            break;
+        }
+    }
+
+    pinIn->node->SetDirty();
+
+    pushes.clear();
+    data.clear();
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace seam::pins {
+    class PinInput;
+    struct PinConnection;
+
+    /// @brief Back buffer for an input pin whose Node is updated on a different thread than its parent.
+    /// While the SeamGraph runs a pipelined update pass, pushes to the pin are recorded here instead of
+    /// landing in the pin's buffer, so the pin's Node can keep drawing the current frame with its front values.
+    /// Publish() replays the pushes on the Node's own thread once the pipelined pass has finished.
+    class StagedPushes {
+    public:
+        StagedPushes(PinInput* _pinIn) : pinIn(_pinIn) { }
+
+        /// @brief Record a push of srcSize elements starting at input element dstFirst;
+        /// srcBytes is how much data the conversion can read from src.
+        void StageMulti(PinConnection* conn, const void* src, uint16_t srcNumCoords, size_t srcSize, size_t srcBytes,
+            size_t dstFirst = 0);
+
+        /// @brief Record a push of a single element to the given channel index.
+        void StageSingle(PinConnection* conn, const void* src, uint16_t srcNumCoords, size_t index, size_t srcBytes);
+
+        /// @brief Record events pushed to an event queue pin.
+        void StageEvents(const void* events, size_t numEvents, size_t eventSize);
+
+        /// @brief Record a value change on a flow pin.
+        void StageFlow();
+
+        /// @brief Apply staged pushes to the pin in the order they were made, and dirty its Node if there were any.
+        /// Must not be called while the thread which stages pushes is running.
+        void Publish();
+
+        inline bool Empty() {
+            return pushes.empty();
+        }
+
+        inline PinInput* Pin() {
+            return pinIn;
+        }
+
+        /// @brief Point at the pin again after it has moved; nullptr once it's destroyed.
+        inline void SetPin(PinInput* _pinIn) {
+            pinIn = _pinIn;
+        }
+
+    private:
+        enum class Kind : uint8_t {
+            Multi,
+            Single,
+            Events,
+            Flow
+        };
+
+        struct Staged {
+            Kind kind;
+            uint16_t srcNumCoords;
+            /// @brief Connections can't change while pushes are staged; the SeamGraph publishes first.
+            PinConnection* conn;
+            /// @brief Number of elements for Multi and Events, channel index for Single.
+            size_t count;
+            size_t dataOffset;
+            /// @brief First input element written by Multi.
+            size_t dstFirst;
+        };
+
+        /// @brief Copy pushed data to the end of the data buffer.
+        /// @return Offset of the copy, aligned so converts can read it as any basic pin type.
+        size_t Append(const void* src, size_t bytes);
+
+        PinInput* pinIn;
+        std::vector<Staged> pushes;
+        std::vector<char> data;
+    };
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "seam/pins/pin.h"
+
+namespace seam::pins {
+    /// @brief Maps a C++ element type to the PinType and number of coords of a Pin storing it.
+    /// Only basic pin types are mapped, since those are what converts and same-layout copies handle.
+    template <typename T>
+    struct PinTypeTraits {
+        static constexpr bool valid = false;
+    };
+
+    template <PinType _type, uint16_t _numCoords>
+    struct BasicPinTypeTraits {
+        static constexpr bool valid = true;
+        static constexpr PinType type = _type;
+        static constexpr uint16_t numCoords = _numCoords;
+    };
+
+    template <> struct PinTypeTraits<bool> : BasicPinTypeTraits<PinType::Bool, 1> { };
+    template <> struct PinTypeTraits<char> : BasicPinTypeTraits<PinType::Char, 1> { };
+    template <> struct PinTypeTraits<int32_t> : BasicPinTypeTraits<PinType::Int, 1> { };
+    template <> struct PinTypeTraits<uint32_t> : BasicPinTypeTraits<PinType::Uint, 1> { };
+    template <> struct PinTypeTraits<float> : BasicPinTypeTraits<PinType::Float, 1> { };
+    template <> struct PinTypeTraits<glm::vec2> : BasicPinTypeTraits<PinType::Float, 2> { };
+    template <> struct PinTypeTraits<glm::vec3> : BasicPinTypeTraits<PinType::Float, 3> { };
+    template <> struct PinTypeTraits<glm::vec4> : BasicPinTypeTraits<PinType::Float, 4> { };
+    template <> struct PinTypeTraits<glm::ivec2> : BasicPinTypeTraits<PinType::Int, 2> { };
+    template <> struct PinTypeTraits<glm::ivec3> : BasicPinTypeTraits<PinType::Int, 3> { };
+    template <> struct PinTypeTraits<glm::ivec4> : BasicPinTypeTraits<PinType::Int, 4> { };
+    template <> struct PinTypeTraits<glm::uvec2> : BasicPinTypeTraits<PinType::Uint, 2> { };
+    template <> struct PinTypeTraits<glm::uvec3> : BasicPinTypeTraits<PinType::Uint, 3> { };
+    template <> struct PinTypeTraits<glm::uvec4> : BasicPinTypeTraits<PinType::Uint, 4> { };
+
+    /// @brief An input pin whose element type and count are known at compile time,
+    /// for Nodes with fixed pin types. Is a plain PinInput as far as the rest of seam is concerned
+    /// (serialization, the editor, connections), so it can also be stored in place of one.
+    /// @tparam T The element type; see PinTypeTraits for the supported types.
+    /// @tparam Elements The number of elements the pin's buffer holds.
+    template <typename T, size_t Elements = 1>
+    class TypedPinInput : public PinInput {
+    public:
+        using Traits = PinTypeTraits<T>;
+        static_assert(Traits::valid, "TypedPinInput needs a basic pin element type");
+
+        /// @param values The Node's storage for the pin's Elements values.
+        TypedPinInput(
+            nodes::INode* node,
+            T* values,
+            const std::string_view name,
+            PinInOptions&& options = PinInOptions()
+        ) : PinInput(SetupInputPin(Traits::type, node, values, Elements, name, WithTraits(std::move(options))))
+        {
+        }
+
+        /// @brief Read an element, whether the pin aliases pushed data or not.
+        inline const T& Value(size_t index = 0) {
+            size_t size;
+            const T* values = (const T*)ReadBuffer(size);
+            assert(index < size);
+            return values[index];
+        }
+
+    private:
+        static PinInOptions WithTraits(PinInOptions&& options) {
+            // Values are packed T's; a custom layout needs an untyped PinInput.
+            assert(options.stride == 0 || options.stride == sizeof(T));
+            options.numCoords = Traits::numCoords;
+            return std::move(options);
+        }
+    };
+
+    /// @brief An output pin whose element type is known at compile time.
+    /// Pushing a TypedPinOutput to an input with the same layout copies elements inline
+    /// rather than calling a converter.
+    /// Is a plain PinOutput otherwise; don't change its number of coords.
+    /// @tparam T The element type; see PinTypeTraits for the supported types.
+    template <typename T>
+    class TypedPinOutput : public PinOutput {
+    public:
+        using Traits = PinTypeTraits<T>;
+        static_assert(Traits::valid, "TypedPinOutput needs a basic pin element type");
+
+        TypedPinOutput(
+            nodes::INode* node,
+            std::string_view name,
+            PinFlags flags = PinFlags::None,
+            void* userp = nullptr
+        ) : PinOutput(SetupOutputPin(node, Traits::type, name, Traits::numCoords, flags, userp))
+        {
+        }
+    };
+
+    // Nodes return their pins as PinInput and PinOutput arrays, so typed pins can't add any state.
+    static_assert(sizeof(TypedPinInput<float>) == sizeof(PinInput));
+    static_assert(sizeof(TypedPinOutput<float>) == sizeof(PinOutput));
+}
@@ -61,8 +61,8 @@ void UniformsPinMap::UpdatePins(const std::unordered_set<const char*>& blacklist
         PinInput* match = FindPinInByName(uniformsPin, pinIn.name);
         if (match != nullptr) {
             pinIn.id = match->id;
-            pinIn.connection = match->connection;
-            match->connection = nullptr;
+            pinIn.connections = std::move(match->connections);
+            match->connections.clear();
 
 			// Also copy the previously set shader uniform values.
 			size_t pinSize, matchSize;
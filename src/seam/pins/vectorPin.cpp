@@ -3,9 +3,10 @@
 
 using namespace seam::pins;
 
-VectorPinInput::VectorPinInput(PinType childPinType) {
-    elementSize = PinTypeToElementSize(childPinType);
-    
+VectorPinInput::VectorPinInput(PinType childPinType)
+    : elementSize(PinTypeToElementSize(childPinType)), buff(elementSize)
+{
+
     createCb = [this, childPinType](VectorPinInput* me, size_t i) -> PinInput {
         assert(vectorPin != nullptr);
         size_t size;
@@ -15,7 +16,7 @@ VectorPinInput::VectorPinInput(PinType childPinType) {
             nullptr, 1, std::to_string(size));
     };
 
-    fixPointersCb = [this](void* buff, PinInput* pinIn) {
+    setPointersCb = [this](void* buff, PinInput* pinIn) {
         pinIn->SetBuffer(buff, 1);
     };
 }
@@ -24,28 +25,27 @@ VectorPinInput::VectorPinInput(
     VectorPinInput::CreateCallback&& _createCb,
     VectorPinInput::SetPinPointersCallback&& _setPinPointersCb,
     size_t _elementSize
-) {
-    elementSize = _elementSize;
+) : elementSize(_elementSize), buff(_elementSize) {
     createCb = _createCb;
-    fixPointersCb = _setPinPointersCb;
+    setPointersCb = _setPinPointersCb;
     assert(!createCb == false);
-    assert(!fixPointersCb == false);
+    assert(!setPointersCb == false);
 }
 
 PinInput VectorPinInput::SetupVectorPin(
-    nodes::INode* node, 
+    nodes::INode* _node, 
     PinType pinType, 
     const std::string_view name,
     size_t initialSize
 ) {
     assert(elementSize != 0);
-    PinInput pinIn = SetupInputPin(pinType, node, nullptr, 0, name);
+    PinInput pinIn = SetupInputPin(pinType, _node, nullptr, 0, name);
     pinIn.flags = (PinFlags)(pinIn.flags | PinFlags::Vector);
     pinIn.seamp = this;
+    node = _node;
 
-    // vectorPin = &pinIn;
-
-    UpdateSize(initialSize);
+    // The returned pin is copied into the Node, so it's found there when it's first resized.
+    assert(initialSize == 0 || !"Resize vector pins once their Node stores them");
     return pinIn;
 }
 
@@ -77,19 +77,20 @@ void VectorPinInput::SetCallbackOptions(Options&& _options) {
 }
 
 void VectorPinInput::UpdateSize(size_t newSize) {
-    if (vectorPin == nullptr) {
+    if (Size() == newSize) {
         return;
     }
-    assert(vectorPin != nullptr);
 
-    if (Size() == newSize) {
+    vectorPin = FindVectorPin();
+    if (vectorPin == nullptr) {
         return;
     }
 
-    buff.resize(newSize * elementSize);
-    vectorPin->SetBuffer(buff.data(), buff.size() / elementSize);
+    // Existing elements stay put; only new elements need their child pins pointed at them.
+    buff.Resize(newSize);
 
-    // Set up any new additional child pins.
+    // Set up any new additional child pins, moving the existing ones at most once.
+    vectorPin->childPins.reserve(newSize);
     while (vectorPin->childPins.size() < newSize) {
         std::function<void(void)> changedCb;
         if (options.onPinChanged) {
@@ -102,6 +103,7 @@ void VectorPinInput::UpdateSize(size_t newSize) {
         PinInput childPin = createCb(this, vectorPin->childPins.size());
         childPin.node = vectorPin->node;
         childPin.SetOnValueChanged(std::move(changedCb));
+        setPointersCb(buff.At(vectorPin->childPins.size()), &childPin);
         vectorPin->childPins.push_back(std::move(childPin));
     }
 
@@ -117,16 +119,32 @@ void VectorPinInput::UpdateSize(size_t newSize) {
         }
     }
 
-    assert(buff.size() / elementSize == vectorPin->childPins.size());
-
-    // Assume the pointer to buff moved, and re-set each child pin's buffer.
-    for (size_t i = 0, j = 0; i < vectorPin->childPins.size() && j < buff.size(); i++, j+= elementSize) {
-        fixPointersCb((void*)&buff[j], &vectorPin->childPins[i]);
-    }
+    assert(buff.Size() == vectorPin->childPins.size());
 
+    // The child pins themselves may have moved, though the elements they point to haven't.
     vectorPin->RecacheInputConnections();
+    if (vectorPin->node != nullptr) {
+        // Child pins were added, removed or moved.
+        vectorPin->node->PinsChanged();
+    }
 
     if (options.onSizeChanged) {
         options.onSizeChanged(this);
     }
+}
+
+PinInput* VectorPinInput::FindVectorPin() {
+    // Look it up every time, in case the Node's pins moved since the last resize.
+    if (node == nullptr) {
+        return nullptr;
+    }
+
+    size_t size;
+    PinInput* pins = node->PinInputs(size);
+    for (size_t i = 0; i < size; i++) {
+        if (pins[i].seamp == this) {
+            return &pins[i];
+        }
+    }
+    return nullptr;
 }
\ No newline at end of file
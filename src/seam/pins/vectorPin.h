@@ -1,8 +1,13 @@
 #pragma once
 
 #include "seam/pins/pinInput.h"
+#include "seam/containers/chunkedArray.h"
 
 namespace seam::pins {
+    /// @brief An input pin with a resizable number of child pins, one per element.
+    /// Elements are stored in chunks and never move once added, so resizing only sets up new child pins,
+    /// and pointers to existing elements stay valid.
+    /// The vector pin itself has no buffer; each element is read and written through its child pin.
     class VectorPinInput {
     public:
         using CreateCallback = std::function<PinInput(VectorPinInput*, size_t)>;
@@ -34,24 +39,32 @@ namespace seam::pins {
         void UpdateSize(size_t newSize);
 
         inline size_t Size() {
-            return buff.size() / elementSize;
+            return buff.Size();
         }
 
         template <typename T>
-        inline T* Get(size_t &size) {
-            assert(sizeof(T) == elementSize);
-            size = Size();
-            return (T*)buff.data();
+        inline T& Get(size_t i) {
+            return buff.At<T>(i);
+        }
+
+        /// @brief Call func(T* first, size_t count) for each contiguous run of elements, in order.
+        template <typename T, typename Func>
+        inline void ForEachRun(Func&& func) {
+            buff.ForEachRun<T>(std::forward<Func>(func));
         }
 
     private:
+        /// @brief Find the vector pin where its Node keeps it; SetupVectorPin() returns a copy.
+        PinInput* FindVectorPin();
+
         PinInput* vectorPin = nullptr;
+        nodes::INode* node = nullptr;
 
         size_t elementSize = 0;
         CreateCallback createCb;
-        SetPinPointersCallback fixPointersCb;
+        SetPinPointersCallback setPointersCb;
 
-        std::vector<char> buff;
+        ChunkedArray buff;
 
         Options options;
     };
@@ -0,0 +1,62 @@
+#include "seam/pipelineThread.h"
+
+#include <assert.h>
+
+using namespace seam;
+
+PipelineThread::PipelineThread() {
+	thread = std::thread(&PipelineThread::ThreadLoop, this);
+}
+
+PipelineThread::~PipelineThread() {
+	Wait();
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_one();
+	thread.join();
+}
+
+void PipelineThread::Start(Task&& _task) {
+	assert(!running);
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		task = std::move(_task);
+		hasTask = true;
+	}
+	running = true;
+	wake.notify_one();
+}
+
+void PipelineThread::Wait() {
+	if (!running) {
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(mutex);
+	done.wait(lock, [this] { return !hasTask; });
+	running = false;
+}
+
+void PipelineThread::ThreadLoop() {
+	while (true) {
+		Task current;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [this] { return stopping || hasTask; });
+			if (stopping) {
+				return;
+			}
+			current = std::move(task);
+		}
+
+		current();
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			hasTask = false;
+		}
+		done.notify_one();
+	}
+}
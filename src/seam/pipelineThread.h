@@ -0,0 +1,47 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace seam {
+	/// @brief A single long-lived thread which runs one task at a time in the background.
+	/// The SeamGraph uses it to update Nodes for the next frame while the current frame draws.
+	class PipelineThread {
+	public:
+		using Task = std::function<void()>;
+
+		PipelineThread();
+		~PipelineThread();
+
+		PipelineThread(const PipelineThread&) = delete;
+		void operator=(const PipelineThread&) = delete;
+
+		/// @brief Start running a task on the thread. The previous task must have been waited on.
+		void Start(Task&& task);
+
+		/// @brief Block until the running task has finished; returns right away if nothing is running.
+		void Wait();
+
+		/// @return true between Start() and the Wait() which follows it.
+		inline bool IsRunning() {
+			return running;
+		}
+
+	private:
+		void ThreadLoop();
+
+		std::thread thread;
+
+		std::mutex mutex;
+		std::condition_variable wake;
+		std::condition_variable done;
+
+		Task task;
+		/// @brief Only touched by the thread which calls Start() and Wait().
+		bool running = false;
+		bool hasTask = false;
+		bool stopping = false;
+	};
+}
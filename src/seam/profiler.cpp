@@ -0,0 +1,242 @@
+#include "seam/profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace seam;
+
+namespace {
+	std::atomic<uint32_t> nextThreadId = 1;
+	thread_local uint32_t threadId = 0;
+	thread_local const char* threadName = nullptr;
+
+	uint32_t ThreadId() {
+		if (threadId == 0) {
+			threadId = nextThreadId.fetch_add(1, std::memory_order_relaxed);
+		}
+		return threadId;
+	}
+
+	const char* ScopeName(ProfileScope scope) {
+		switch (scope) {
+		case ProfileScope::Update:
+			return "Update";
+		case ProfileScope::Draw:
+			return "Draw";
+		case ProfileScope::ProcessAudio:
+			return "ProcessAudio";
+		default:
+			return "Unknown";
+		}
+	}
+
+	/// @brief Node names are identifiers, but escape them anyways so the JSON can't break.
+	void WriteEscaped(FILE* file, const char* str, size_t length) {
+		for (size_t i = 0; i < length; i++) {
+			const char c = str[i];
+			if (c == '"' || c == '\\') {
+				fputc('\\', file);
+				fputc(c, file);
+			} else if ((unsigned char)c < 0x20) {
+				fprintf(file, "\\u%04x", (unsigned char)c);
+			} else {
+				fputc(c, file);
+			}
+		}
+	}
+}
+
+void TimingRing::Push(float ms) {
+	// Only one thread pushes to a ring, so the count can be loaded and stored separately.
+	const uint32_t c = count.load(std::memory_order_relaxed);
+	samples[c & (SIZE - 1)].store(ms, std::memory_order_relaxed);
+	count.store(c + 1, std::memory_order_release);
+}
+
+TimingStats TimingRing::Stats() const {
+	TimingStats stats;
+	const uint32_t c = count.load(std::memory_order_acquire);
+	const uint32_t n = std::min(c, SIZE);
+	if (n == 0) {
+		return stats;
+	}
+
+	std::array<float, SIZE> copy;
+	float sum = 0.f;
+	stats.min_ms = std::numeric_limits<float>::max();
+	for (uint32_t i = 0; i < n; i++) {
+		copy[i] = samples[i].load(std::memory_order_relaxed);
+		stats.min_ms = std::min(stats.min_ms, copy[i]);
+		sum += copy[i];
+	}
+
+	const uint32_t p99 = (uint32_t)std::ceil(n * 0.99f) - 1;
+	std::nth_element(copy.begin(), copy.begin() + p99, copy.begin() + n);
+
+	stats.avg_ms = sum / n;
+	stats.p99_ms = copy[p99];
+	stats.samples = n;
+	return stats;
+}
+
+Profiler::Profiler() {
+	traceStart = Now();
+}
+
+Profiler::~Profiler() {
+	EndTrace();
+	WaitForTraceWriters();
+}
+
+void Profiler::Record(NodeTimings* timings, std::string_view nodeName, uint64_t nodeId,
+	ProfileScope scope, TimePoint start, TimePoint end)
+{
+	if (timings != nullptr) {
+		const float ms = std::chrono::duration<float, std::milli>(end - start).count();
+		timings->scopes[(size_t)scope].Push(ms);
+	}
+
+	if (tracing.load(std::memory_order_relaxed)) {
+		AppendTraceEvent(nodeName, nodeId, scope, start, end);
+	}
+}
+
+void Profiler::AppendTraceEvent(std::string_view nodeName, uint64_t nodeId,
+	ProfileScope scope, TimePoint start, TimePoint end)
+{
+	traceWriters.fetch_add(1, std::memory_order_seq_cst);
+
+	// Check again now that this thread is registered as a writer;
+	// BeginTrace() and WriteTrace() stop tracing before waiting for writers to leave.
+	if (tracing.load(std::memory_order_seq_cst)) {
+		const size_t index = traceNext.fetch_add(1, std::memory_order_relaxed);
+		if (index < traceCapacity) {
+			TraceEvent& e = traceEvents[index];
+			e.nodeName = nodeName.data();
+			e.nodeNameLength = (uint32_t)nodeName.size();
+			e.threadId = ThreadId();
+			e.threadName = threadName;
+			e.nodeId = nodeId;
+			e.startUs = std::chrono::duration_cast<std::chrono::microseconds>(start - traceStart).count();
+			e.durationUs = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+			e.scope = scope;
+		}
+	}
+
+	traceWriters.fetch_sub(1, std::memory_order_release);
+}
+
+void Profiler::WaitForTraceWriters() {
+	while (traceWriters.load(std::memory_order_seq_cst) != 0) {
+		std::this_thread::yield();
+	}
+}
+
+void Profiler::BeginTrace(size_t maxEvents) {
+	tracing.store(false, std::memory_order_seq_cst);
+	WaitForTraceWriters();
+
+	if (maxEvents != traceCapacity) {
+		traceEvents = std::make_unique<TraceEvent[]>(maxEvents);
+		traceCapacity = maxEvents;
+	}
+	traceNext.store(0, std::memory_order_relaxed);
+	traceStart = Now();
+
+	tracing.store(true, std::memory_order_seq_cst);
+}
+
+void Profiler::EndTrace() {
+	tracing.store(false, std::memory_order_seq_cst);
+}
+
+size_t Profiler::DroppedTraceEvents() const {
+	const size_t next = traceNext.load(std::memory_order_relaxed);
+	return next > traceCapacity ? next - traceCapacity : 0;
+}
+
+void Profiler::SetThreadName(const char* name) {
+	threadName = name;
+}
+
+bool Profiler::WriteTrace(std::string_view filename) {
+	EndTrace();
+	WaitForTraceWriters();
+
+	FILE* file = fopen(std::string(filename).c_str(), "w");
+	if (file == nullptr) {
+		printf("Failed to open trace file %s for writing\n", filename.data());
+		return false;
+	}
+
+	const size_t count = std::min(traceNext.load(std::memory_order_relaxed), traceCapacity);
+
+	fprintf(file, "{\"traceEvents\":[\n");
+
+	// Name each thread which shows up in the capture once.
+	std::vector<uint32_t> namedThreads;
+	bool first = true;
+	for (size_t i = 0; i < count; i++) {
+		const TraceEvent& e = traceEvents[i];
+		if (e.threadName == nullptr
+			|| std::find(namedThreads.begin(), namedThreads.end(), e.threadId) != namedThreads.end())
+		{
+			continue;
+		}
+		namedThreads.push_back(e.threadId);
+		fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+			first ? "" : ",\n", e.threadId, e.threadName);
+		first = false;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		const TraceEvent& e = traceEvents[i];
+		fprintf(file, "%s{\"name\":\"", first ? "" : ",\n");
+		WriteEscaped(file, e.nodeName, e.nodeNameLength);
+		fprintf(file, "\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,\"pid\":1,\"tid\":%u,\"args\":{\"id\":%llu}}",
+			ScopeName(e.scope), (long long)e.startUs, (long long)e.durationUs, e.threadId,
+			(unsigned long long)e.nodeId);
+		first = false;
+	}
+
+	fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+	fclose(file);
+
+	if (DroppedTraceEvents() > 0) {
+		printf("Trace buffer was full; %zu events were dropped\n", DroppedTraceEvents());
+	}
+	return true;
+}
+
+#if RUN_DOCTEST
+#include "doctest.h"
+
+TEST_CASE("Timing ring stats") {
+	TimingRing ring;
+	CHECK(ring.Stats().samples == 0);
+
+	for (int i = 1; i <= 100; i++) {
+		ring.Push((float)i);
+	}
+
+	TimingStats stats = ring.Stats();
+	CHECK(stats.samples == 100);
+	CHECK(stats.min_ms == 1.f);
+	CHECK(stats.avg_ms == doctest::Approx(50.5f));
+	CHECK(stats.p99_ms == 99.f);
+
+	// Once the ring wraps, only the most recent samples count.
+	for (int i = 0; i < (int)TimingRing::SIZE; i++) {
+		ring.Push(2.f);
+	}
+	stats = ring.Stats();
+	CHECK(stats.samples == TimingRing::SIZE);
+	CHECK(stats.min_ms == 2.f);
+	CHECK(stats.p99_ms == 2.f);
+}
+#endif
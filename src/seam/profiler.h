@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string_view>
+#include <cstdint>
+
+namespace seam {
+	/// @brief The Node calls a SeamGraph can time.
+	enum class ProfileScope : uint8_t {
+		Update,
+		Draw,
+		ProcessAudio,
+		Count
+	};
+
+	/// @brief Summary of a Node's recent timings for one ProfileScope, in milliseconds.
+	struct TimingStats {
+		float min_ms = 0.f;
+		float avg_ms = 0.f;
+		float p99_ms = 0.f;
+		/// @brief How many samples the stats were computed from; zero if the Node was never timed.
+		size_t samples = 0;
+	};
+
+	/// @brief Rolling window of the most recent timings of one Node call.
+	/// Pushed to by a single thread (whichever thread makes that call), and can be read from any thread.
+	class TimingRing {
+	public:
+		/// @brief Must be a power of two.
+		static constexpr uint32_t SIZE = 128;
+
+		void Push(float ms);
+
+		TimingStats Stats() const;
+
+	private:
+		std::array<std::atomic<float>, SIZE> samples;
+		std::atomic<uint32_t> count = 0;
+	};
+
+	/// @brief Per-Node timing windows; only allocated for Nodes while profiling is enabled.
+	struct NodeTimings {
+		std::array<TimingRing, (size_t)ProfileScope::Count> scopes;
+	};
+
+	/// @brief Low overhead timing of Node calls, with optional chrome://tracing / Perfetto JSON export.
+	/// Recording never blocks; trace events are appended to a fixed size buffer and dropped once it's full.
+	class Profiler {
+	public:
+		using Clock = std::chrono::steady_clock;
+		using TimePoint = Clock::time_point;
+
+		Profiler();
+		~Profiler();
+
+		Profiler(const Profiler&) = delete;
+		void operator=(const Profiler&) = delete;
+
+		inline static TimePoint Now() {
+			return Clock::now();
+		}
+
+		inline bool IsEnabled() const {
+			return enabled.load(std::memory_order_relaxed);
+		}
+
+		/// @brief Use SeamGraph::SetProfiling() instead, which also allocates per-Node timings.
+		inline void SetEnabled(bool _enabled) {
+			enabled.store(_enabled, std::memory_order_relaxed);
+		}
+
+		/// @brief Record one call of a Node. Safe to call from any thread.
+		/// @param nodeName The Node type's name, which must outlive the Profiler.
+		void Record(NodeTimings* timings, std::string_view nodeName, uint64_t nodeId,
+			ProfileScope scope, TimePoint start, TimePoint end);
+
+		/// @brief Start capturing trace events, discarding any previous capture.
+		/// Call from the main thread between frames.
+		/// @param maxEvents Events recorded after the buffer fills up are dropped.
+		void BeginTrace(size_t maxEvents = 1 << 20);
+
+		/// @brief Stop capturing trace events; the capture is kept until the next BeginTrace().
+		void EndTrace();
+
+		inline bool IsTracing() const {
+			return tracing.load(std::memory_order_relaxed);
+		}
+
+		/// @brief Write the last capture as a chrome://tracing / Perfetto compatible JSON file.
+		/// Ends the capture if it's still running.
+		bool WriteTrace(std::string_view filename);
+
+		/// @return How many events didn't fit into the last capture's buffer.
+		size_t DroppedTraceEvents() const;
+
+		/// @brief Name the calling thread in trace captures.
+		/// @param name Must be a string literal or otherwise outlive the Profiler.
+		static void SetThreadName(const char* name);
+
+	private:
+		struct TraceEvent {
+			const char* nodeName;
+			uint32_t nodeNameLength;
+			uint32_t threadId;
+			const char* threadName;
+			uint64_t nodeId;
+			int64_t startUs;
+			int64_t durationUs;
+			ProfileScope scope;
+		};
+
+		void AppendTraceEvent(std::string_view nodeName, uint64_t nodeId,
+			ProfileScope scope, TimePoint start, TimePoint end);
+
+		/// @brief Wait for threads which are in the middle of appending trace events.
+		void WaitForTraceWriters();
+
+		std::atomic<bool> enabled = false;
+		std::atomic<bool> tracing = false;
+
+		/// @brief Number of threads currently inside AppendTraceEvent(),
+		/// so the trace buffer isn't reallocated or read while it's being written to.
+		std::atomic<uint32_t> traceWriters = 0;
+
+		std::unique_ptr<TraceEvent[]> traceEvents;
+		size_t traceCapacity = 0;
+		std::atomic<size_t> traceNext = 0;
+		TimePoint traceStart;
+	};
+}
@@ -1,3 +1,12 @@
+#if RUN_DOCTEST
+#include "doctest.h"
+#include <thread>
+#endif
+
+#include <functional>
+#include <queue>
+#include <unordered_map>
+
 #include "seam/seamGraph.h"
 #include "seam/hash.h"
 #include "seam/properties/nodeProperty.h"
@@ -7,6 +16,11 @@ using namespace seam::nodes;
 using namespace seam::pins;
 
 namespace {
+	/// @brief Node editor calls are skipped when there's no editor context, for instance when running headless.
+	bool HasEditorContext() {
+		return ed::GetCurrentEditor() != nullptr;
+	}
+
 	template <typename T>
 	void Erase(std::vector<T*>& v, T* item) {
 		auto it = std::find(v.begin(), v.end(), item);
@@ -210,7 +224,10 @@ namespace {
 
 SeamGraph::SeamGraph() {
 	updateParams.push_patterns = &pushPatterns;
-    updateParams.alloc_pool = &allocPool;
+    updateParams.alloc_pool = &frameArenas.Current();
+
+	pipelineUpdateParams.push_patterns = &pushPatterns;
+	pipelineUpdateParams.alloc_pool = &pipelineFrameArenas.Current();
 }
 
 SeamGraph::~SeamGraph() {
@@ -220,51 +237,311 @@ SeamGraph::~SeamGraph() {
 
 void SeamGraph::Draw() {
     DrawParams params;
-    params.time = ofGetElapsedTimef();
-    params.delta_time = ofGetLastFrameTime();
+    params.time = clock->Time();
+    params.delta_time = clock->DeltaTime();
 
     for (auto n : nodesToDraw) {
-        n->Draw(&params);
+        Profiled(n, ProfileScope::Draw, [&] { n->Draw(&params); });
     }
 }
 
-void SeamGraph::UpdateVisibleNodeGraph(INode* n, UpdateParams* params) {
-    // Traverse parents and update them before traversing this node.
-    // Parents are sorted by update order, so that any "shared parents" are updated first
-    static std::vector<INode*> in_use_parents;
-    n->InUseParents(in_use_parents);
+void SeamGraph::CompileUpdateSchedule() {
+	updateSchedule.Clear();
+	pipelineSchedule.Clear();
+	scheduleMark += 1;
+
+	// Collect the parent tree of each visible node with an explicit stack,
+	// marking Nodes as they're found so shared parents are only scheduled once.
+	std::vector<INode*> stack;
+	std::vector<INode*> inUseParents;
+	for (auto n : visibleNodes) {
+		if (n->schedule_mark != scheduleMark) {
+			n->schedule_mark = scheduleMark;
+			stack.push_back(n);
+		}
+	}
 
-    for (auto p : in_use_parents) {
-        assert(p->update_order < n->update_order);
-        UpdateVisibleNodeGraph(p, params);
-    }
+	while (!stack.empty()) {
+		INode* n = stack.back();
+		stack.pop_back();
+		updateSchedule.nodes.push_back(n);
+
+		n->InUseParents(inUseParents);
+		for (auto p : inUseParents) {
+			assert(p->update_order < n->update_order);
+			if (p->schedule_mark != scheduleMark) {
+				p->schedule_mark = scheduleMark;
+				stack.push_back(p);
+			}
+		}
+	}
 
-    // now, this node can update, if it's dirty
-    if (n->dirty) {
-        n->Update(params);
-        n->dirty = false;
+	// Update order is max(parents' update order) + 1, so sorting by it
+	// guarantees every parent is updated before any of its children.
+	std::stable_sort(updateSchedule.nodes.begin(), updateSchedule.nodes.end(), &INode::CompareUpdateOrder);
 
-        // if this is a visual node, it will need to be re-drawn now
-        if (n->IsVisual()) {
-            nodesToDraw.push_back(n);
-        }
-    }
+	// Nodes left out of the schedule still get events pushed into them by Nodes which are scheduled,
+	// but nothing would ever drain them; see ClearUnscheduledEvents().
+	unscheduledEventNodes.clear();
+	size_t size;
+	for (auto n : nodes) {
+		if (n->schedule_mark == scheduleMark || n->UpdatesEveryFrame()) {
+			continue;
+		}
+		PinInput* pinInputs = n->PinInputs(size);
+		for (size_t i = 0; i < size; i++) {
+			if (flags::AreRaised(pinInputs[i].flags, PinFlags::EventQueue)) {
+				unscheduledEventNodes.push_back(n);
+				break;
+			}
+		}
+	}
+
+	if (pipelined) {
+		CompilePipelineSchedule();
+	}
+
+	CompileBatches(updateSchedule);
+	CompileBatches(pipelineSchedule);
+
+	updateScheduleDirty = false;
+}
+
+void SeamGraph::CompileBatches(UpdateSchedule& schedule) {
+	schedule.batches.clear();
+	std::vector<INode*>& scheduled = schedule.nodes;
+	std::vector<std::pair<uint32_t, INode*>> parallel;
+
+	const uint32_t size = (uint32_t)scheduled.size();
+	uint32_t begin = 0;
+	while (begin < size) {
+		uint32_t end = begin + 1;
+		while (end < size && scheduled[end]->update_order == scheduled[begin]->update_order) {
+			end++;
+		}
+
+		auto parallelBegin = std::stable_partition(scheduled.begin() + begin, scheduled.begin() + end, [](INode* n) {
+			return !n->IsThreadSafeUpdate();
+		});
+		const uint32_t serialEnd = (uint32_t)(parallelBegin - scheduled.begin());
+		if (serialEnd > begin) {
+			schedule.batches.push_back(ScheduleBatch { begin, serialEnd, false });
+		}
+
+		// Pushes write into children's inputs and run their pin callbacks on the pushing worker,
+		// so each Node goes into a later batch than any Node in this level already pushing into one of its children.
+		// Children are marked with this level's scheduleMark; the DFS which used it is done by now.
+		scheduleMark += 1;
+		parallel.clear();
+		for (uint32_t i = serialEnd; i < end; i++) {
+			INode* n = scheduled[i];
+			uint32_t batch = 0;
+			for (auto& child : n->children) {
+				if (child.node->schedule_mark == scheduleMark) {
+					batch = std::max(batch, child.node->schedule_batch + 1);
+				}
+			}
+			for (auto& child : n->children) {
+				child.node->schedule_mark = scheduleMark;
+				child.node->schedule_batch = batch;
+			}
+			parallel.push_back(std::make_pair(batch, n));
+		}
+
+		std::stable_sort(parallel.begin(), parallel.end(), [](auto& a, auto& b) {
+			return a.first < b.first;
+		});
+		for (uint32_t i = 0; i < parallel.size(); i++) {
+			const uint32_t index = serialEnd + i;
+			scheduled[index] = parallel[i].second;
+			if (i == 0 || parallel[i].first != parallel[i - 1].first) {
+				schedule.batches.push_back(ScheduleBatch { index, index + 1, true });
+			} else {
+				schedule.batches.back().end = index + 1;
+			}
+		}
+
+		begin = end;
+	}
+}
+
+void SeamGraph::CompilePipelineSchedule() {
+	for (auto n : nodes) {
+		n->pipeline_update = false;
+	}
+
+	// The schedule is sorted parents first, so each Node's parents are classified before it is.
+	std::vector<INode*> inUseParents;
+	for (auto n : updateSchedule.nodes) {
+		bool pipelines = n->IsThreadSafeUpdate() && !n->IsVisual() && !n->UpdatesEveryFrame();
+		n->InUseParents(inUseParents);
+		for (size_t i = 0; i < inUseParents.size() && pipelines; i++) {
+			pipelines = inUseParents[i]->pipeline_update;
+		}
+		n->pipeline_update = pipelines;
+	}
+
+	pipelineBoundary.clear();
+	// Both halves stay sorted by update order.
+	std::vector<INode*>& scheduled = updateSchedule.nodes;
+	auto mainEnd = std::stable_partition(scheduled.begin(), scheduled.end(), [](INode* n) {
+		return !n->pipeline_update;
+	});
+	pipelineSchedule.nodes.assign(mainEnd, scheduled.end());
+	scheduled.erase(mainEnd, scheduled.end());
+
+	for (auto n : scheduled) {
+		for (const auto& p : n->parents) {
+			if (p.node->pipeline_update) {
+				pipelineBoundary.push_back(n);
+				break;
+			}
+		}
+	}
+
+	// Stage every input which the pipeline thread pushes to but doesn't own,
+	// including inputs of Nodes which are culled from the schedule.
+	std::vector<PinOutput*> outputs;
+	for (auto n : pipelineSchedule.nodes) {
+		size_t size;
+		PinOutput* pinOutputs = n->PinOutputs(size);
+		for (size_t i = 0; i < size; i++) {
+			outputs.push_back(&pinOutputs[i]);
+		}
+
+		while (!outputs.empty()) {
+			PinOutput* pinOut = outputs.back();
+			outputs.pop_back();
+
+			for (auto& conn : pinOut->connections) {
+				if (!conn.pinIn->node->pipeline_update && conn.pinIn->staged == nullptr) {
+					stagedInputs.push_back(std::make_unique<StagedPushes>(conn.pinIn));
+					conn.pinIn->staged = stagedInputs.back().get();
+					// The parent will be writing its outputs on the other thread.
+					if (conn.pinIn->IsAliased()) {
+						conn.pinIn->Detach();
+					}
+				}
+			}
+
+			PinOutput* children = pinOut->PinOutputs(size);
+			for (size_t i = 0; i < size; i++) {
+				outputs.push_back(&children[i]);
+			}
+		}
+	}
+
+	// Nodes which just moved to the pipeline thread haven't been updated ahead of the main pass yet.
+	pipelineAhead = false;
+}
+
+void SeamGraph::InvalidateUpdateSchedule() {
+	FinishPipelinedUpdate();
+	ClearStagedInputs();
+	updateScheduleDirty = true;
+}
+
+void SeamGraph::ClearStagedInputs() {
+	for (auto& staged : stagedInputs) {
+		staged->Publish();
+		if (staged->Pin() != nullptr) {
+			staged->Pin()->staged = nullptr;
+		}
+	}
+	stagedInputs.clear();
+}
+
+void SeamGraph::SetPipelined(bool enabled) {
+	if (enabled == pipelined) {
+		return;
+	}
+
+	FinishPipelinedUpdate();
+	pipelined = enabled;
+	if (pipelined) {
+		pipelineThread = std::make_unique<PipelineThread>();
+	} else {
+		pipelineThread.reset();
+		pipelineSchedule.Clear();
+		pipelineBoundary.clear();
+		for (auto n : nodes) {
+			n->pipeline_update = false;
+		}
+	}
+	InvalidateUpdateSchedule();
+}
+
+void SeamGraph::FinishPipelinedUpdate() {
+	if (!pipelineThread || !pipelineThread->IsRunning()) {
+		return;
+	}
+	pipelineThread->Wait();
+	PublishPipelinedUpdate();
+}
+
+void SeamGraph::RunPipelineSchedule(float time, float deltaTime) {
+	pipelineEpoch = frameEpoch.fetch_add(1) + 1;
+	INode::threadPassEpoch = pipelineEpoch;
+
+	BeginFrameArenas(pipelineFrameArenas, pipelineWorkerFrameArenas,
+		&pipelineUpdateParams, pipelineWorkerUpdateParams, pipelineEpoch);
+
+	pipelineUpdateParams.time = time;
+	pipelineUpdateParams.delta_time = deltaTime;
+	RunSchedule(pipelineSchedule, &pipelineUpdateParams, pipelineWorkerUpdateParams, pipelineEpoch);
+
+	frameEpoch.fetch_add(1);
+	INode::threadPassEpoch = 0;
+}
+
+void SeamGraph::PublishPipelinedUpdate() {
+	for (auto& staged : stagedInputs) {
+		staged->Publish();
+	}
+
+	// Pipelined parents can't pass their dirtiness on during the main pass, so it's passed on here.
+	for (auto n : pipelineBoundary) {
+		for (const auto& p : n->parents) {
+			if (p.node->pipeline_update && p.node->propagated_epoch == pipelineEpoch) {
+				n->SetDirty();
+				break;
+			}
+		}
+	}
 }
 
 void SeamGraph::Update() {
+    // Pick up whatever the pipeline thread pushed while the last frame was drawing.
+    FinishPipelinedUpdate();
+
+    if (updateScheduleDirty) {
+        CompileUpdateSchedule();
+    }
+
+    // Nothing ran ahead of this frame (yet), so catch the pipeline schedule up before the main pass reads from it.
+    if (pipelined && !pipelineAhead) {
+        RunPipelineSchedule(clock->Time(), clock->DeltaTime());
+        PublishPipelinedUpdate();
+    }
+    pipelineAhead = false;
+
     // Traverse the parent tree of each visible visual node and determine what needs to update
     nodesToDraw.clear();
 
-    // Before traversing the graphs of visible nodes, dirty nodes which update every frame
-    for (auto n : nodesUpdateOverTime) {
-        // Set the dirty flag directly so children aren't affected;
-        // just because the node updates over time doesn't mean it will change every frame,
-        // for instance in the case of a timer which fires every XX seconds
-        n->dirty = true;
+    // Start this frame's update pass. Nodes dirtied during the pass are stamped with this epoch,
+    // and anything dirtied after the pass is stamped with the next one.
+    const uint32_t epoch = frameEpoch.fetch_add(1) + 1;
+    INode::threadPassEpoch = epoch;
+
+    // Whatever was allocated before the last frame's pass has been read by now,
+    // whether by this thread or the pipeline thread.
+    if (lastUpdateEpoch != 0) {
+        retiredEpoch.store(lastUpdateEpoch - 1, std::memory_order_release);
     }
+    lastUpdateEpoch = epoch;
+    BeginFrameArenas(frameArenas, workerFrameArenas, &updateParams, workerUpdateParams, epoch);
 
-    // Clear the per-frame allocation pool
-    allocPool.Clear();
+	Profiler::SetThreadName("main");
 
 	UpdateParams* params = GetUpdateParams();
 
@@ -272,15 +549,211 @@ void SeamGraph::Update() {
     // these are usually nodes which handle some kind of external input and/or can be dirtied by other threads
     for (auto n : nodesUpdateEveryFrame) {
         // Assume the node will dirty itself if it needs to Update()
-        if (n->dirty) {
-            n->Update(params);
+        if (n->IsDirty()) {
+            n->propagated_epoch = epoch;
+            Profiled(n, ProfileScope::Update, [&] { n->Update(params); });
+            n->updated_epoch = epoch;
+        }
+    }
+
+    RunSchedule(updateSchedule, params, workerUpdateParams, epoch);
+    ClearUnscheduledEvents();
+
+    // End the update pass; anything dirtied from here on should update next frame.
+    frameEpoch.fetch_add(1);
+    INode::threadPassEpoch = 0;
+
+    // Update the pipeline schedule for the next frame while this one draws.
+    if (pipelined && !pipelineSchedule.nodes.empty()) {
+        const float time = params->time + params->delta_time;
+        const float deltaTime = params->delta_time;
+        pipelineThread->Start([this, time, deltaTime] {
+            Profiler::SetThreadName("pipeline");
+            RunPipelineSchedule(time, deltaTime);
+        });
+        pipelineAhead = true;
+    }
+}
+
+void SeamGraph::ClearUnscheduledEvents() {
+	size_t size;
+	for (auto n : unscheduledEventNodes) {
+		PinInput* pinInputs = n->PinInputs(size);
+		for (size_t i = 0; i < size; i++) {
+			if (flags::AreRaised(pinInputs[i].flags, PinFlags::EventQueue)) {
+				size_t events;
+				pinInputs[i].GetEvents(events);
+				pinInputs[i].ClearEvents(events);
+			}
+		}
+	}
+}
+
+void SeamGraph::RunSchedule(const UpdateSchedule& schedule, UpdateParams* params,
+    std::vector<UpdateParams>& workerParams, uint32_t epoch)
+{
+    for (auto& p : workerParams) {
+        p.time = params->time;
+        p.delta_time = params->delta_time;
+    }
+
+    // Walk the schedule in update order and update nodes that need to be updated.
+    // Nodes which share an update order can't depend on each other, so the Nodes of a parallel batch
+    // which need to update are updated together on the workers before moving on to the next batch.
+    for (const ScheduleBatch& batch : schedule.batches) {
+        parallelBatch.clear();
+
+        for (uint32_t i = batch.begin; i < batch.end; i++) {
+            INode* n = schedule.nodes[i];
+            if (!PrepareScheduledNode(n, epoch)) {
+                continue;
+            }
+
+            if (workerPool && batch.parallel) {
+                parallelBatch.push_back(n);
+            } else {
+                UpdateScheduledNode(n, params, epoch);
+            }
         }
+
+        UpdateParallelBatch(params, workerParams, epoch);
+    }
+}
+
+bool SeamGraph::PrepareScheduledNode(INode* n, uint32_t epoch) {
+    // Dirtiness propagates lazily: a Node is dirty if it was dirtied directly since its last Update(),
+    // or if any of its parents passed their dirtiness on since then.
+    // That includes passes in which this Node wasn't scheduled, for instance while its branch was hidden.
+    bool propagates = n->IsDirty();
+    for (size_t i = 0; i < n->parents.size() && !propagates; i++) {
+        propagates = n->parents[i].node->propagated_epoch > n->updated_epoch;
+    }
+
+    if (propagates) {
+        // Stamp inherited dirtiness on the Node itself so IsDirty() holds during its Update().
+        n->RaiseDirtiedEpoch(epoch);
+        n->propagated_epoch = epoch;
+        return true;
+    }
+
+    // Nodes which update over time Update() every frame, but that alone doesn't dirty their children;
+    // for instance a timer which only fires every XX seconds
+    return n->UpdatesOverTime();
+}
+
+void SeamGraph::UpdateScheduledNode(INode* n, UpdateParams* params, uint32_t epoch) {
+    Profiled(n, ProfileScope::Update, [&] { n->Update(params); });
+    n->updated_epoch = epoch;
+
+    // if this is a visual node, it will need to be re-drawn now
+    if (n->IsVisual()) {
+        nodesToDraw.push_back(n);
     }
+}
+
+void SeamGraph::UpdateParallelBatch(UpdateParams* params, std::vector<UpdateParams>& workerParams, uint32_t epoch) {
+    if (parallelBatch.size() == 1) {
+        UpdateScheduledNode(parallelBatch[0], params, epoch);
+        return;
+    } else if (parallelBatch.empty()) {
+        return;
+    }
+
+    workerPool->RunBatch(parallelBatch.size(), [this, params, &workerParams, epoch](size_t index, size_t workerIndex) {
+        INode* n = parallelBatch[index];
+        // Worker 0 is the thread running the schedule, which keeps its own params.
+        UpdateParams* p = params;
+        if (workerIndex != 0) {
+            Profiler::SetThreadName("update worker");
+            p = &workerParams[workerIndex];
+            INode::threadPassEpoch = epoch;
+        }
+        Profiled(n, ProfileScope::Update, [&] { n->Update(p); });
+    });
+
+    // Book keeping happens back on the calling thread once the level's barrier has passed.
+    for (auto n : parallelBatch) {
+        n->updated_epoch = epoch;
+        if (n->IsVisual()) {
+            nodesToDraw.push_back(n);
+        }
+    }
+}
+
+void SeamGraph::SetProfiling(bool enabled) {
+	FinishPipelinedUpdate();
+	if (enabled && !profiler.IsEnabled()) {
+		// Keep the audio thread out while timings are handed out to Nodes.
+		LockAudio();
+		for (auto n : nodes) {
+			if (!n->timings) {
+				n->timings = std::make_unique<NodeTimings>();
+			}
+		}
+		profiler.SetEnabled(true);
+		audioLock.store(false);
+	} else if (!enabled) {
+		// Timings are kept so they can still be inspected after profiling stops.
+		profiler.SetEnabled(false);
+	}
+}
+
+TimingStats SeamGraph::GetNodeTimings(INode* node, ProfileScope scope) {
+	if (!node->timings) {
+		return TimingStats();
+	}
+	return node->timings->scopes[(size_t)scope].Stats();
+}
 
-    // Traverse the visible node graph and update nodes that need to be updated
-    for (auto n : visibleNodes) {
-        UpdateVisibleNodeGraph(n, params);
+PinMemoryStats SeamGraph::GetPinMemoryStats() {
+	FinishPipelinedUpdate();
+
+	PinMemoryStats stats;
+	for (INode* node : nodes) {
+		AddPinMemory(static_cast<IInPinnable*>(node), stats);
+		AddPinMemory(static_cast<IOutPinnable*>(node), stats);
+	}
+	return stats;
+}
+
+void SeamGraph::BeginFrameArenas(FrameArenaRing& arenas, std::vector<std::unique_ptr<FrameArenaRing>>& workerArenas,
+	UpdateParams* params, std::vector<UpdateParams>& workerParams, uint32_t epoch)
+{
+	const uint32_t retired = retiredEpoch.load(std::memory_order_acquire);
+	params->alloc_pool = &arenas.Begin(epoch, retired);
+	// Worker 0 uses the pass's own params.
+	for (size_t i = 0; i < workerArenas.size(); i++) {
+		workerParams[i + 1].alloc_pool = &workerArenas[i]->Begin(epoch, retired);
+	}
+}
+
+void SeamGraph::SetUpdateThreads(size_t numThreads) {
+    FinishPipelinedUpdate();
+
+    workerPool.reset();
+    workerFrameArenas.clear();
+    workerUpdateParams.clear();
+    pipelineWorkerFrameArenas.clear();
+    pipelineWorkerUpdateParams.clear();
+
+    if (numThreads == 0) {
+        return;
     }
+
+    workerPool = std::make_unique<WorkerPool>(numThreads);
+
+    // Each worker gets its own frame pool so allocations don't need to be synchronized.
+    // Push patterns are shared; pushing doesn't modify the PushPatterns themselves.
+    // Worker 0 is the thread running the schedule, which uses the params passed to RunSchedule().
+    auto makeWorkerParams = [this](std::vector<UpdateParams>& params, std::vector<std::unique_ptr<FrameArenaRing>>& arenas) {
+        params.resize(workerPool->NumWorkers(), updateParams);
+        for (size_t i = 1; i < params.size(); i++) {
+            arenas.push_back(std::make_unique<FrameArenaRing>());
+            params[i].alloc_pool = &arenas.back()->Current();
+        }
+    };
+    makeWorkerParams(workerUpdateParams, workerFrameArenas);
+    makeWorkerParams(pipelineWorkerUpdateParams, pipelineWorkerFrameArenas);
 }
 
 void SeamGraph::LockAudio() {
@@ -307,14 +780,17 @@ void SeamGraph::ProcessAudio(ofSoundBuffer& buffer) {
 		return;
 	}
 
-    for (auto n : audioNodes) {
-        n->ProcessAudio(buffer);
+	Profiler::SetThreadName("audio");
+
+    for (auto& n : audioNodes) {
+        Profiled(n.node, ProfileScope::ProcessAudio, [&] { n.audio->ProcessAudio(buffer); });
     }
 
 	processingAudio.store(false);
 }
 
 void SeamGraph::NewGraph() {
+	FinishPipelinedUpdate();
 	LockAudio();
 	if (!destructing) {
 		clearAudioNodes.store(true);
@@ -325,10 +801,15 @@ void SeamGraph::NewGraph() {
 	// Clear all the various lists that keep track of nodes.
     nodesToDraw.clear();
     visibleNodes.clear();
-    nodesUpdateOverTime.clear();
+    updateSchedule.Clear();
+    pipelineSchedule.Clear();
+    pipelineBoundary.clear();
     nodesUpdateEveryFrame.clear();
+    unscheduledEventNodes.clear();
 
 	visualOutputNode = nullptr;
+	previewNode = nullptr;
+	InvalidateUpdateSchedule();
 
 #if BUILD_AUDIO_ANALYSIS
 	while (!destructing && clearAudioNodes.load() == true) {
@@ -341,6 +822,7 @@ void SeamGraph::NewGraph() {
         delete nodes[i];
     }
     nodes.clear();
+    pinIndex.Clear();
 
 	audioLock.store(false);
 
@@ -351,24 +833,22 @@ INode* SeamGraph::CreateAndAdd(seam::nodes::NodeId node_id) {
 	INode* node = factory.Create(node_id);
 	if (node != nullptr) {
 		node->seamState.pushPatterns = &pushPatterns;
+		node->seamState.pinIndex = &pinIndex;
 		node->seamState.texLocResolver = &texLocResolver;
+		node->seamState.frameEpoch = &frameEpoch;
 
-		node->OnWindowResized(glm::ivec2(ofGetWidth(), ofGetHeight()));
+		node->OnWindowResized(GetResolution());
 		node->Setup(&setupParams);
+		pinIndex.Add(node);
 
-		nodes.push_back(node);
-
-		if (node->IsVisual()) {
-			// probably temporary: add to the list of visible nodes up front
-			auto it = std::upper_bound(visibleNodes.begin(), visibleNodes.end(), node, &INode::CompareUpdateOrder);
-			visibleNodes.insert(it, node);
+		if (profiler.IsEnabled()) {
+			node->timings = std::make_unique<NodeTimings>();
 		}
 
+		nodes.push_back(node);
+
 		if (node->UpdatesEveryFrame()) {
 			nodesUpdateEveryFrame.push_back(node);
-		} 
-		if (node->UpdatesOverTime()) {
-			nodesUpdateOverTime.push_back(node);
 		}
 
 		// Does this Node process audio?
@@ -377,7 +857,7 @@ INode* SeamGraph::CreateAndAdd(seam::nodes::NodeId node_id) {
 			LockAudio();
 			// TODO this needs some kind of guard against the audio thread,
 			// but a mutex can't be used since it's the audio thread...
-			audioNodes.push_back(audioNode);
+			audioNodes.push_back(AudioNode { audioNode, node });
 			audioLock.store(false);
 		}
 	}
@@ -390,13 +870,14 @@ INode* SeamGraph::CreateAndAdd(const std::string_view node_name) {
 }
 
 void SeamGraph::DeleteNode(INode* node) {
+    FinishPipelinedUpdate();
     size_t size;
 
     // Undo Input connections.
     PinInput* pinInputs = node->PinInputs(size);
     for (size_t i = 0; i < size; i++) {
-        if (pinInputs[i].connection != nullptr) {
-            Disconnect(&pinInputs[i], pinInputs[i].connection);
+        while (pinInputs[i].IsConnected()) {
+            Disconnect(&pinInputs[i], pinInputs[i].connections.back());
         }
     }
 
@@ -413,16 +894,35 @@ void SeamGraph::DeleteNode(INode* node) {
     Erase(nodes, node);
     Erase(nodesToDraw, node);
     Erase(visibleNodes, node);
+
+    if (visualOutputNode == node) {
+        visualOutputNode = nullptr;
+    }
+    if (previewNode == node) {
+        previewNode = nullptr;
+    }
+    // The schedules are recompiled before the next Update().
+    updateSchedule.Clear();
+    pipelineSchedule.Clear();
+    Erase(pipelineBoundary, node);
     Erase(nodesUpdateEveryFrame, node);
-    Erase(nodesUpdateOverTime, node);
+    Erase(unscheduledEventNodes, node);
+    pinIndex.Remove(node);
     
     IAudioNode* audioNode = dynamic_cast<IAudioNode*>(node);
     if (audioNode != nullptr) {
 		LockAudio();
-        Erase(audioNodes, audioNode);
+		auto it = std::find_if(audioNodes.begin(), audioNodes.end(), [audioNode](const AudioNode& a) {
+			return a.audio == audioNode;
+		});
+		if (it != audioNodes.end()) {
+			audioNodes.erase(it);
+		}
 		audioLock.store(false);
     }
 
+    InvalidateUpdateSchedule();
+
     // Finally, delete the Node.
     delete node;
 }
@@ -434,11 +934,35 @@ INode* SeamGraph::GetVisualOutputNode() {
 void SeamGraph::SetVisualOutputNode(INode* node) {
 	assert(node->IsVisual());
 	visualOutputNode = node;
+	RefreshVisibleNodes();
+}
+
+void SeamGraph::SetPreviewNode(INode* node) {
+	assert(node == nullptr || node->IsVisual());
+	if (previewNode == node) {
+		return;
+	}
+	previewNode = node;
+	RefreshVisibleNodes();
+}
+
+void SeamGraph::RefreshVisibleNodes() {
+	// Visual nodes which feed neither the output nor the preview are culled;
+	// they and their parents don't update until one of them is shown again.
+	visibleNodes.clear();
+	if (visualOutputNode != nullptr) {
+		visibleNodes.push_back(visualOutputNode);
+	}
+	if (previewNode != nullptr && previewNode != visualOutputNode) {
+		visibleNodes.push_back(previewNode);
+	}
 
-	// TODO recalculate visual draw chain
+	InvalidateUpdateSchedule();
 }
 
 bool SeamGraph::Connect(PinInput* pinIn, PinOutput* pinOut) {
+	FinishPipelinedUpdate();
+
 	assert((pinIn->flags & PinFlags::Input) == PinFlags::Input);
 	assert((pinOut->flags & PinFlags::Output) == PinFlags::Output);
 
@@ -449,10 +973,26 @@ bool SeamGraph::Connect(PinInput* pinIn, PinOutput* pinOut) {
 	assert(child->FindPinInput(pinIn->id) != nullptr);
 	assert(parent->FindPinOutput(pinOut->id) != nullptr);
 
+	// Batches are checked for cycles all at once in EndBatchConnect().
+	if (!batchConnecting && CreatesCycle(parent, child)) {
+		printf("Connect(): connecting %s to %s would create a cycle\n", 
+			parent->NodeName().data(), child->NodeName().data());
+		return false;
+	}
+
+	// LoadGraph() doesn't go through the editor's type checks, so a stale file can pair any two pins.
+	bool canConvert;
+	pins::GetConvertSingle(pinOut->type, pinIn->type, canConvert);
+	if (!canConvert) {
+		printf("Connect(): can't convert pin %s of %s to pin %s of %s\n",
+			pinOut->name.c_str(), parent->NodeName().data(), pinIn->name.c_str(), child->NodeName().data());
+		return false;
+	}
+
 	// create the connection
 
 	pinOut->connections.push_back(PinConnection(pinIn, pinOut));
-	pinIn->connection = pinOut;
+	pinIn->AddConnection(pinOut);
 
 	PinConnectedArgs connectedArgs;
 	connectedArgs.pinIn = pinIn;
@@ -472,14 +1012,20 @@ bool SeamGraph::Connect(PinInput* pinIn, PinOutput* pinOut) {
 	const bool is_new_parent = child->AddParent(parent);
 	const bool rearranged = is_new_parent || is_new_child;
 
-	if (rearranged) {
-		RecalculateTraversalOrder(child);
+	if (rearranged && !batchConnecting) {
+		PropagateUpdateOrder(child);
+		InvalidateUpdateSchedule();
+	} else if (pipelined && !batchConnecting) {
+		// The schedule doesn't change, but the new input may need to be staged.
+		InvalidateUpdateSchedule();
 	}
 
 	return true;
 }
 
 bool SeamGraph::Disconnect(PinInput* pinIn, PinOutput* pinOut) {
+	FinishPipelinedUpdate();
+
     assert((pinIn->flags & PinFlags::Input) == PinFlags::Input);
 	assert((pinOut->flags & PinFlags::Output) == PinFlags::Output);
 
@@ -489,7 +1035,11 @@ bool SeamGraph::Disconnect(PinInput* pinIn, PinOutput* pinOut) {
 	assert(child->FindPinInput(pinIn->id) != nullptr);
 	assert(parent->FindPinOutput(pinOut->id) != nullptr);
 
-	pinIn->connection = nullptr;
+	pinIn->RemoveConnection(pinOut);
+	// Keep the last pushed values; they belong to the parent.
+	if (pinIn->IsAliased()) {
+		pinIn->Detach();
+	}
 
 	// remove from pinOut's connections list
 	size_t i = 0;
@@ -543,9 +1093,10 @@ bool SeamGraph::Disconnect(PinInput* pinIn, PinOutput* pinOut) {
 		}
 	}
 
-	if (rearranged) {
+	if (rearranged && !batchConnecting) {
 		// the child node and its children need to recalculate draw and update order now
-		RecalculateTraversalOrder(child);
+		PropagateUpdateOrder(child);
+		InvalidateUpdateSchedule();
 	}
 
 	return true;
@@ -553,54 +1104,222 @@ bool SeamGraph::Disconnect(PinInput* pinIn, PinOutput* pinOut) {
 
 void SeamGraph::OnWindowResized(int w, int h) {
 	assert(w > 0 && h > 0);
+	resolution = glm::ivec2(w, h);
 	for (auto n : nodes) {
 		n->OnWindowResized(glm::ivec2(w, h));
 	}
 }
 
-int16_t SeamGraph::RecalculateUpdateOrder(INode* node) {
-	// update order is always max of parents' update order + 1
-	if (node->update_order != -1) {
-		return node->update_order;
+glm::ivec2 SeamGraph::GetResolution() {
+	if (resolution.x > 0 && resolution.y > 0) {
+		return resolution;
 	}
+	return glm::ivec2(ofGetWidth(), ofGetHeight());
+}
+
+void SeamGraph::SetClock(IClock* _clock) {
+	clock = _clock != nullptr ? _clock : &ofClock;
+}
+
+void SeamGraph::PropagateUpdateOrder(INode* node) {
+	// update order is always max of parents' update order + 1.
+	// Visit Nodes lowest update order first, so parents are usually settled before their children,
+	// and stop propagating past any Node whose update order didn't change.
+	// Connect() refuses edges which would close a cycle, so this always settles.
+	using OrderedNode = std::pair<int32_t, INode*>;
+	std::priority_queue<OrderedNode, std::vector<OrderedNode>, std::greater<OrderedNode>> queue;
+	queue.push(std::make_pair(node->update_order, node));
+
+	// Nodes with a parent whose update order changed; their parents lists are re-sorted once it's all settled.
+	orderMark += 1;
+	std::vector<INode*> unsorted;
 
 	// TODO! deal with feedback pins
+	while (!queue.empty()) {
+		INode* n = queue.top().second;
+		queue.pop();
+
+		int32_t updateOrder = 0;
+		for (auto& parent : n->parents) {
+			updateOrder = std::max(updateOrder, parent.node->update_order + 1);
+		}
+		if (updateOrder == n->update_order && n != node) {
+			continue;
+		}
+
+		n->update_order = updateOrder;
+		for (auto child : n->children) {
+			queue.push(std::make_pair(child.node->update_order, child.node));
+			if (child.node->order_mark != orderMark) {
+				child.node->order_mark = orderMark;
+				unsorted.push_back(child.node);
+			}
+		}
+	}
+
+	for (auto n : unsorted) {
+		n->SortParents();
+	}
+}
 
-	int16_t max_parents_update_order = -1;
-	for (auto parent : node->parents) {
-		max_parents_update_order = std::max(
-			max_parents_update_order,
-			// TODO checking the parent update order may not be necessary,
-			// if the children list is sorted for its recursive traversal
-			RecalculateUpdateOrder(parent.node)
-		);
+bool SeamGraph::CreatesCycle(INode* parent, INode* child) {
+	if (parent == child) {
+		return true;
 	}
-	node->update_order = max_parents_update_order + 1;
 
-	// recursively update children
-	for (auto child : node->children) {
-		RecalculateUpdateOrder(child.node);
+	// Update orders strictly increase along edges, so a path from the child back up to the parent
+	// can only pass through Nodes ordered before the parent.
+	if (child->update_order >= parent->update_order) {
+		return false;
 	}
 
-	return node->update_order;
+	orderMark += 1;
+	child->order_mark = orderMark;
+	std::vector<INode*> stack = { child };
+	while (!stack.empty()) {
+		INode* n = stack.back();
+		stack.pop_back();
+		for (auto& c : n->children) {
+			if (c.node == parent) {
+				return true;
+			}
+			if (c.node->order_mark != orderMark && c.node->update_order < parent->update_order) {
+				c.node->order_mark = orderMark;
+				stack.push_back(c.node);
+			}
+		}
+	}
+	return false;
 }
 
-void SeamGraph::InvalidateChildren(INode* node) {
-    // if this node has already been invalidated, don't go over it again
-    if (node->update_order == -1) {
-        return;
-    }
+void SeamGraph::RecalculateAllUpdateOrders() {
+	// Kahn's algorithm: visit each Node once all of its parents have been visited.
+	std::unordered_map<INode*, size_t> remainingParents;
+	std::vector<INode*> ready;
+	for (auto n : nodes) {
+		n->update_order = 0;
+		remainingParents[n] = n->parents.size();
+		if (n->parents.empty()) {
+			ready.push_back(n);
+		}
+	}
+
+	size_t visited = 0;
+	while (!ready.empty()) {
+		INode* n = ready.back();
+		ready.pop_back();
+		visited += 1;
 
-	node->update_order = -1;
-	for (auto child : node->children) {
-		InvalidateChildren(child.node);
+		for (auto child : n->children) {
+			child.node->update_order = std::max(child.node->update_order, n->update_order + 1);
+			if (--remainingParents[child.node] == 0) {
+				ready.push_back(child.node);
+			}
+		}
+	}
+
+	if (visited != nodes.size()) {
+		std::vector<INode*> unordered;
+		for (auto n : nodes) {
+			if (remainingParents[n] != 0) {
+				unordered.push_back(n);
+			}
+		}
+		const size_t removed = DisconnectCycles(unordered);
+		printf("RecalculateAllUpdateOrders(): cycle detected among %zu Nodes, removed %zu connections\n",
+			unordered.size(), removed);
+		if (removed > 0) {
+			// The graph is acyclic now.
+			RecalculateAllUpdateOrders();
+			return;
+		}
+		assert(false);
+	}
+
+	for (auto n : nodes) {
+		n->SortParents();
 	}
 }
 
-void SeamGraph::RecalculateTraversalOrder(INode* node) {
-	// invalidate this node and its children
-	InvalidateChildren(node);
-	RecalculateUpdateOrder(node);
+size_t SeamGraph::DisconnectCycles(const std::vector<INode*>& unordered) {
+	// Depth first search through the Nodes which couldn't be ordered;
+	// every edge back to a Node still on the search's stack closes a cycle.
+	enum class Visit { Unseen, OnStack, Done };
+	std::unordered_map<INode*, Visit> visits;
+	for (auto n : unordered) {
+		visits[n] = Visit::Unseen;
+	}
+
+	std::vector<std::pair<INode*, INode*>> backEdges;
+	std::vector<std::pair<INode*, size_t>> stack;
+	for (auto root : unordered) {
+		if (visits[root] != Visit::Unseen) {
+			continue;
+		}
+		visits[root] = Visit::OnStack;
+		stack.push_back(std::make_pair(root, 0));
+		while (!stack.empty()) {
+			INode* n = stack.back().first;
+			size_t& next = stack.back().second;
+			if (next == n->children.size()) {
+				visits[n] = Visit::Done;
+				stack.pop_back();
+				continue;
+			}
+
+			INode* child = n->children[next++].node;
+			auto it = visits.find(child);
+			// Children which were ordered aren't part of any cycle.
+			if (it == visits.end()) {
+				continue;
+			}
+			if (it->second == Visit::OnStack) {
+				backEdges.push_back(std::make_pair(n, child));
+			} else if (it->second == Visit::Unseen) {
+				it->second = Visit::OnStack;
+				stack.push_back(std::make_pair(child, 0));
+			}
+		}
+	}
+
+	// Disconnect without propagating update orders, which wouldn't settle while there are cycles.
+	const bool wasBatchConnecting = batchConnecting;
+	batchConnecting = true;
+	size_t removed = 0;
+	std::function<void(IInPinnable*, INode*)> disconnectFrom = [&](IInPinnable* pinnable, INode* parent) {
+		size_t size;
+		PinInput* pinInputs = pinnable->PinInputs(size);
+		for (size_t i = 0; i < size; i++) {
+			for (size_t j = pinInputs[i].connections.size(); j > 0; j--) {
+				PinOutput* pinOut = pinInputs[i].connections[j - 1];
+				if (pinOut->node == parent) {
+					printf("DisconnectCycles(): disconnecting %s from %s\n",
+						parent->NodeName().data(), pinInputs[i].node->NodeName().data());
+					Disconnect(&pinInputs[i], pinOut);
+					removed += 1;
+				}
+			}
+			disconnectFrom(&pinInputs[i], parent);
+		}
+	};
+	for (auto& edge : backEdges) {
+		disconnectFrom(static_cast<IInPinnable*>(edge.second), edge.first);
+	}
+	batchConnecting = wasBatchConnecting;
+
+	return removed;
+}
+
+void SeamGraph::BeginBatchConnect() {
+	assert(!batchConnecting);
+	batchConnecting = true;
+}
+
+void SeamGraph::EndBatchConnect() {
+	assert(batchConnecting);
+	batchConnecting = false;
+	RecalculateAllUpdateOrders();
+	InvalidateUpdateSchedule();
 }
 
 bool SeamGraph::SaveGraph(const std::string_view filename, const std::vector<INode*>& nodesToSave) {
@@ -669,9 +1388,11 @@ bool SeamGraph::SaveGraph(const std::string_view filename, const std::vector<INo
         auto node_builder = serialized_nodes[i];
 
         // Serialize node fields.
-        auto nodePosition = ed::GetNodePosition((ed::NodeId)node);
-        node_builder.getPosition().setX(nodePosition.x);
-        node_builder.getPosition().setY(nodePosition.y);
+        if (HasEditorContext()) {
+            auto nodePosition = ed::GetNodePosition((ed::NodeId)node);
+            node_builder.getPosition().setX(nodePosition.x);
+            node_builder.getPosition().setY(nodePosition.y);
+        }
 
         node_builder.setDisplayName(node->InstanceName());
         node_builder.setNodeName(node->NodeName().data());
@@ -750,20 +1471,17 @@ bool SeamGraph::LoadGraph(const std::string_view filename, std::vector<SeamGraph
 	IdsDistributor::GetInstance().SetNextNodeId(node_graph.getMaxNodeId());
 	IdsDistributor::GetInstance().SetNextPinId(node_graph.getMaxPinId());
 
-	// Keep a pin id to node map so pins can be looked up for connecting shortly.
-	// Pins have to be looked up through the Node each time we want them,
-	// since pin pointers are prone to change during deserialization.
-	std::map<PinId, INode*> inputPinMap;
-	std::map<PinId, INode*> outputPinMap;
-
+	// Pins are looked up through the PinIndex, which follows pins as they move during deserialization.
 	// First deserialize nodes and pins
 	for (const auto& serialized_node : node_graph.getNodes()) {
 		auto node = CreateAndAdd(serialized_node.getNodeName().cStr());
 		node->id = serialized_node.getId();
 		node->instance_name = serialized_node.getDisplayName();
 
-		auto position = ImVec2(serialized_node.getPosition().getX(), serialized_node.getPosition().getY());
-		ed::SetNodePosition((ed::NodeId)node, position);
+		if (HasEditorContext()) {
+			auto position = ImVec2(serialized_node.getPosition().getX(), serialized_node.getPosition().getY());
+			ed::SetNodePosition((ed::NodeId)node, position);
+		}
 
 		// Deserialize properties before inputs and outputs, since setting properties might create some pins.
 		for (const auto& serializedProperty : serialized_node.getProperties()) {
@@ -826,21 +1544,18 @@ bool SeamGraph::LoadGraph(const std::string_view filename, std::vector<SeamGraph
 			// POSSIBLE IMPROVEMENT: is there a use case for PropertyBag here?
 		}
 
-		// Now that props have been set (possibly creating pins), get the pin in / out lists.
-		size_t inputs_size;
-		auto input_pins = node->PinInputs(inputs_size);
+		// Setting properties may have created pins.
+		node->PinsChanged();
 
 		auto dynamicPinsNode = dynamic_cast<IDynamicPinsNode*>(node);
 
 		// Deserialize inputs
 		uint32_t inputIndex = 0;
 		for (const auto& serialized_pin_in : serialized_node.getInputPins()) {
-			std::string serialized_pin_name = serialized_pin_in.getName().cStr();
-			std::transform(serialized_pin_name.begin(), serialized_pin_name.end(), serialized_pin_name.begin(), 
-				[](unsigned char c) {return std::tolower(c); });
+			std::string_view serialized_pin_name = serialized_pin_in.getName().cStr();
 
 			// Try to find an input pin on the node with a matching name.
-			auto matchPos = FindPinInByName(input_pins, inputs_size, serialized_pin_name);
+			auto matchPos = pinIndex.FindInputByName(node, serialized_pin_name);
 
 			const auto serialized_values = serialized_pin_in.getValues();
 
@@ -853,7 +1568,6 @@ bool SeamGraph::LoadGraph(const std::string_view filename, std::vector<SeamGraph
 				}
 				
 				DeserializePinInput(serialized_pin_in, match);
-				UpdatePinMap(match, inputPinMap);
 
 			} else if (dynamicPinsNode != nullptr) {
 				PinType pinType = (PinType)serialized_pin_in.getType();
@@ -864,35 +1578,29 @@ bool SeamGraph::LoadGraph(const std::string_view filename, std::vector<SeamGraph
 
 				if (added == nullptr) {
 					printf("Dynamic Pins Node %s refused to add an input pin named %s\n",
-						node->NodeName().data(), serialized_pin_name.c_str());
+						node->NodeName().data(), serialized_pin_name.data());
 				} else {
 					DeserializePinInput(serialized_pin_in, added);
-					UpdatePinMap(added, inputPinMap);
-
-					// Refresh the input pins list!
-					input_pins = node->PinInputs(inputs_size);
+					node->PinsChanged();
 				}
 
 			} else {
 				printf("Could not match serialized input pin with name %s on node %s\n", 
-					serialized_pin_name.c_str(), serialized_node.getDisplayName().cStr());
+					serialized_pin_name.data(), serialized_node.getDisplayName().cStr());
 			}
 
 			inputIndex += 1;
 		}
 
 		// Deserialize outputs
-		size_t outputs_size;
-		auto output_pins = node->PinOutputs(outputs_size);
 		for (const auto& serialized_pin_out : serialized_node.getOutputPins()) {
 			std::string_view pin_name = serialized_pin_out.getName().cStr();
 
 			// Try to find an output pin on the node with a matching name.
-			auto match = FindPinOutByName(output_pins, outputs_size, pin_name);
+			auto match = pinIndex.FindOutputByName(node, pin_name);
 
 			if (match != nullptr) {
 				DeserializePinOutput(serialized_pin_out, match);
-				UpdatePinMap(match, outputPinMap);
 
 			} else if (dynamicPinsNode != nullptr) {
 				PinType pinType = (PinType)serialized_pin_out.getType();
@@ -908,33 +1616,30 @@ bool SeamGraph::LoadGraph(const std::string_view filename, std::vector<SeamGraph
 						node->NodeName().data(), serialized_pin_out.getName().cStr());
 				} else {
 					assert(added->id == serialized_pin_out.getId());
-
-					UpdatePinMap(added, outputPinMap);
-
-					// Refresh the output pins list
-					output_pins = node->PinOutputs(outputs_size);
+					node->PinsChanged();
 				}
 			} else {
 				printf("Could not match serialized output pin with name %s on node %s\n",
 					pin_name.data(), serialized_node.getDisplayName().cStr());
 			}
 		};
+
+		// Deserializing gave the Node's pins their saved ids.
+		node->PinsChanged();
 	}
 
 	// Now add any valid connections.
+	// Update order is calculated once after all the connections are made, rather than per connection.
 	links.clear();
+	BeginBatchConnect();
 	for (const auto& conn : node_graph.getConnections()) {
 		size_t outId = conn.getOutId();
 		size_t inId = conn.getInId();
-		auto outNode = outputPinMap.find(outId);
-		auto inNode = inputPinMap.find(inId);
-		if (inNode != inputPinMap.end() && outNode != outputPinMap.end()) {
-			// Look up the input and output pins.
-			auto outPin = outNode->second->FindPinOutput(outId);
-			auto inPin = inNode->second->FindPinInput(inId);
-
+		PinOutput* outPin = pinIndex.FindOutput(outId);
+		PinInput* inPin = pinIndex.FindInput(inId);
+		if (inPin != nullptr && outPin != nullptr) {
 			if (Connect(inPin, outPin)) {
-				links.push_back(Link(outNode->second, outId, inNode->second, inId));
+				links.push_back(Link(pinIndex.FindNode(outId), outId, pinIndex.FindNode(inId), inId));
 			} else {
 				printf("LoadGraph(): failed to connect pin out %llu to pin in %llu\n",
 					outId, inId);
@@ -944,11 +1649,22 @@ bool SeamGraph::LoadGraph(const std::string_view filename, std::vector<SeamGraph
 				outId, inId);
 		}
 	}
+	EndBatchConnect();
 
-	ed::NavigateToContent();
+	// Drop the links EndBatchConnect() disconnected for closing a cycle.
+	links.erase(std::remove_if(links.begin(), links.end(), [this](const Link& link) {
+		PinInput* inPin = pinIndex.FindInput(link.inPin);
+		PinOutput* outPin = pinIndex.FindOutput(link.outPin);
+		return std::find(inPin->connections.begin(), inPin->connections.end(), outPin) == inPin->connections.end();
+	}), links.end());
+
+	if (HasEditorContext()) {
+		ed::NavigateToContent();
+	}
 
 	// Ensure that window-size related pins use the current resolution instead of the file's resolution.
-	OnWindowResized(ofGetWidth(), ofGetHeight());
+	glm::ivec2 currentResolution = GetResolution();
+	OnWindowResized(currentResolution.x, currentResolution.y);
 
 	auto visualOutputNodeId = node_graph.getVisualOutputNodeId();
 	if (visualOutputNodeId != 0) {
@@ -963,4 +1679,276 @@ bool SeamGraph::LoadGraph(const std::string_view filename, std::vector<SeamGraph
 	}
 	
     return true;
-}
\ No newline at end of file
+}
+
+#if RUN_DOCTEST
+namespace {
+	/// @brief Dirties its children by updating, without pushing anything to them.
+	class TestSource : public INode {
+	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("Test Source", { }, { PinType::Float });
+
+		TestSource() : INode(metadata) { }
+
+		void Update(UpdateParams* params) override {
+			updates++;
+			// Like a MIDI callback arriving right after Update() has drained its queue.
+			if (dirtyFromAnotherThread) {
+				dirtyFromAnotherThread = false;
+				std::thread([this]() { SetDirty(); }).join();
+			}
+		}
+
+		PinInput* PinInputs(size_t& size) override {
+			size = 0;
+			return nullptr;
+		}
+
+		PinOutput* PinOutputs(size_t& size) override {
+			size = 1;
+			return &pinOut;
+		}
+
+		int updates = 0;
+		bool dirtyFromAnotherThread = false;
+		TypedPinOutput<float> pinOut = TypedPinOutput<float>(this, "output");
+	};
+
+	class TestView : public INode {
+	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("Test View", { PinType::Float }, { });
+
+		TestView() : INode(metadata) {
+			flags = (NodeFlags)(flags | NodeFlags::IsVisual);
+		}
+
+		void Update(UpdateParams* params) override {
+			updates++;
+		}
+
+		PinInput* PinInputs(size_t& size) override {
+			size = 1;
+			return &pinIn;
+		}
+
+		PinOutput* PinOutputs(size_t& size) override {
+			size = 0;
+			return nullptr;
+		}
+
+		int updates = 0;
+		float value = 0.f;
+		PinInput pinIn = TypedPinInput<float>(this, &value, "Value");
+	};
+
+	class TestRelay : public INode {
+	public:
+		static constexpr NodeMetadata metadata = NodeMetadata("Test Relay", { PinType::Float }, { PinType::Float });
+
+		TestRelay() : INode(metadata) { }
+
+		void Update(UpdateParams* params) override { }
+
+		PinInput* PinInputs(size_t& size) override {
+			size = pinInputs.size();
+			return pinInputs.data();
+		}
+
+		PinOutput* PinOutputs(size_t& size) override {
+			size = 1;
+			return &pinOut;
+		}
+
+		int32_t UpdateOrder() {
+			return update_order;
+		}
+
+		std::array<float, 2> values = { };
+		std::array<PinInput, 2> pinInputs = {
+			TypedPinInput<float>(this, &values[0], "A"),
+			TypedPinInput<float>(this, &values[1], "B"),
+		};
+		TypedPinOutput<float> pinOut = TypedPinOutput<float>(this, "output");
+	};
+}
+
+TEST_CASE("Test a hidden branch catches up on its parent's changes when shown again") {
+	SeamGraph graph;
+	FixedStepClock clock;
+	graph.SetClock(&clock);
+	graph.OnWindowResized(64, 64);
+	graph.GetFactory()->Register<TestSource>();
+	graph.GetFactory()->Register<TestView>();
+
+	TestSource* source = (TestSource*)graph.CreateAndAdd(TestSource::metadata.id);
+	TestView* output = (TestView*)graph.CreateAndAdd(TestView::metadata.id);
+	TestView* preview = (TestView*)graph.CreateAndAdd(TestView::metadata.id);
+	REQUIRE(graph.Connect(&output->pinIn, &source->pinOut));
+	REQUIRE(graph.Connect(&preview->pinIn, &source->pinOut));
+	graph.SetVisualOutputNode(output);
+	graph.SetPreviewNode(preview);
+
+	graph.Update();
+	CHECK(source->updates == 1);
+	CHECK(output->updates == 1);
+	CHECK(preview->updates == 1);
+
+	// Dirty the source while the preview branch is hidden.
+	graph.SetPreviewNode(nullptr);
+	source->SetDirty();
+	clock.Step();
+	graph.Update();
+	CHECK(source->updates == 2);
+	CHECK(output->updates == 2);
+	CHECK(preview->updates == 1);
+
+	// Nothing is dirty anymore, but the preview hasn't seen the source's last update yet.
+	graph.SetPreviewNode(preview);
+	clock.Step();
+	graph.Update();
+	CHECK(source->updates == 2);
+	CHECK(output->updates == 2);
+	CHECK(preview->updates == 2);
+}
+
+TEST_CASE("Test a Node dirtied from another thread during an update pass updates next frame") {
+	SeamGraph graph;
+	FixedStepClock clock;
+	graph.SetClock(&clock);
+	graph.OnWindowResized(64, 64);
+	graph.GetFactory()->Register<TestSource>();
+	graph.GetFactory()->Register<TestView>();
+
+	TestSource* source = (TestSource*)graph.CreateAndAdd(TestSource::metadata.id);
+	TestView* output = (TestView*)graph.CreateAndAdd(TestView::metadata.id);
+	REQUIRE(graph.Connect(&output->pinIn, &source->pinOut));
+	graph.SetVisualOutputNode(output);
+
+	graph.Update();
+	CHECK(source->updates == 1);
+
+	// The other thread dirties the source after the pass has already updated it.
+	source->dirtyFromAnotherThread = true;
+	source->SetDirty();
+	clock.Step();
+	graph.Update();
+	CHECK(source->updates == 2);
+	CHECK(source->IsDirty());
+
+	clock.Step();
+	graph.Update();
+	CHECK(source->updates == 3);
+	CHECK(output->updates == 3);
+
+	// Nothing's dirty anymore.
+	clock.Step();
+	graph.Update();
+	CHECK(source->updates == 3);
+}
+
+TEST_CASE("Test incremental update orders match a full recalculation") {
+	SeamGraph graph;
+	graph.GetFactory()->Register<TestRelay>();
+	std::vector<TestRelay*> relays;
+	for (int i = 0; i < 5; i++) {
+		relays.push_back((TestRelay*)graph.CreateAndAdd(TestRelay::metadata.id));
+	}
+	TestRelay* a = relays[0];
+	TestRelay* b = relays[1];
+	TestRelay* c = relays[2];
+	TestRelay* d = relays[3];
+	TestRelay* e = relays[4];
+
+	auto checkOrders = [&]() {
+		std::vector<int32_t> incremental;
+		for (auto relay : relays) {
+			incremental.push_back(relay->UpdateOrder());
+		}
+		// An empty batch recalculates every update order from scratch.
+		graph.BeginBatchConnect();
+		graph.EndBatchConnect();
+		for (size_t i = 0; i < relays.size(); i++) {
+			CHECK(relays[i]->UpdateOrder() == incremental[i]);
+		}
+	};
+
+	// Build the chain a -> b -> c -> d from the bottom up, so each connection pushes orders further down.
+	REQUIRE(graph.Connect(&d->pinInputs[0], &c->pinOut));
+	checkOrders();
+	REQUIRE(graph.Connect(&c->pinInputs[0], &b->pinOut));
+	checkOrders();
+	REQUIRE(graph.Connect(&b->pinInputs[0], &a->pinOut));
+	checkOrders();
+	CHECK(d->UpdateOrder() == 3);
+
+	// A longer path into c through e.
+	REQUIRE(graph.Connect(&e->pinInputs[0], &b->pinOut));
+	REQUIRE(graph.Connect(&d->pinInputs[1], &e->pinOut));
+	REQUIRE(graph.Connect(&e->pinInputs[1], &a->pinOut));
+	checkOrders();
+	REQUIRE(graph.Connect(&c->pinInputs[1], &e->pinOut));
+	checkOrders();
+	CHECK(c->UpdateOrder() == 3);
+	CHECK(d->UpdateOrder() == 4);
+
+	// Disconnecting pulls orders back up.
+	REQUIRE(graph.Disconnect(&e->pinInputs[0], &b->pinOut));
+	checkOrders();
+	REQUIRE(graph.Disconnect(&b->pinInputs[0], &a->pinOut));
+	checkOrders();
+	CHECK(b->UpdateOrder() == 0);
+}
+
+TEST_CASE("Test Connect refuses connections which would create a cycle") {
+	SeamGraph graph;
+	graph.GetFactory()->Register<TestRelay>();
+	TestRelay* a = (TestRelay*)graph.CreateAndAdd(TestRelay::metadata.id);
+	TestRelay* b = (TestRelay*)graph.CreateAndAdd(TestRelay::metadata.id);
+	TestRelay* c = (TestRelay*)graph.CreateAndAdd(TestRelay::metadata.id);
+	REQUIRE(graph.Connect(&b->pinInputs[0], &a->pinOut));
+	REQUIRE(graph.Connect(&c->pinInputs[0], &b->pinOut));
+
+	CHECK(!graph.Connect(&a->pinInputs[0], &c->pinOut));
+	CHECK(!graph.Connect(&a->pinInputs[0], &a->pinOut));
+	CHECK(!a->pinInputs[0].IsConnected());
+	CHECK(a->UpdateOrder() == 0);
+	CHECK(c->UpdateOrder() == 2);
+
+	// Connecting across the chain is fine.
+	CHECK(graph.Connect(&c->pinInputs[1], &a->pinOut));
+}
+
+TEST_CASE("Test a batch of connections with a cycle has the cycle broken") {
+	SeamGraph graph;
+	graph.GetFactory()->Register<TestRelay>();
+	TestRelay* a = (TestRelay*)graph.CreateAndAdd(TestRelay::metadata.id);
+	TestRelay* b = (TestRelay*)graph.CreateAndAdd(TestRelay::metadata.id);
+	TestRelay* c = (TestRelay*)graph.CreateAndAdd(TestRelay::metadata.id);
+	TestRelay* d = (TestRelay*)graph.CreateAndAdd(TestRelay::metadata.id);
+
+	// Like loading a hand edited file: a -> b -> c -> a, with d hanging off of the cycle.
+	graph.BeginBatchConnect();
+	REQUIRE(graph.Connect(&b->pinInputs[0], &a->pinOut));
+	REQUIRE(graph.Connect(&c->pinInputs[0], &b->pinOut));
+	REQUIRE(graph.Connect(&a->pinInputs[0], &c->pinOut));
+	REQUIRE(graph.Connect(&d->pinInputs[0], &c->pinOut));
+	graph.EndBatchConnect();
+
+	// Exactly one connection of the cycle is gone, and d keeps its parent.
+	const int connected = (int)a->pinInputs[0].IsConnected() + (int)b->pinInputs[0].IsConnected()
+		+ (int)c->pinInputs[0].IsConnected();
+	CHECK(connected == 2);
+	CHECK(d->pinInputs[0].IsConnected());
+
+	// What's left is ordered parent first.
+	TestRelay* relays[3] = { a, b, c };
+	for (auto relay : relays) {
+		for (auto& pinIn : relay->pinInputs) {
+			for (auto pinOut : pinIn.connections) {
+				CHECK(((TestRelay*)pinOut->node)->UpdateOrder() < relay->UpdateOrder());
+			}
+		}
+	}
+	CHECK(d->UpdateOrder() > c->UpdateOrder());
+}
+#endif // RUN_DOCTEST
@@ -2,13 +2,19 @@
 
 #include <vector>
 #include <atomic>
+#include <memory>
 
 #include "seam/include.h"
 #include "seam/factory.h"
 #include "seam/pins/push.h"
+#include "seam/pins/pinIndex.h"
 #include "seam/seamState.h"
 #include "seam/pins/pin.h"
 #include "seam/textureLocationResolver.h"
+#include "seam/workerPool.h"
+#include "seam/pipelineThread.h"
+#include "seam/clock.h"
+#include "seam/profiler.h"
 
 namespace seam {
     using namespace nodes;
@@ -49,6 +55,28 @@ namespace seam {
         /// @brief To be called during OpenFrameworks' update() call.
         void Update();
 
+		/// @brief Set how many extra threads are used to update NodeFlags::ThreadSafeUpdate Nodes in parallel.
+		/// Nodes which share an update order and don't push into a shared child run concurrently,
+		/// with a barrier between each parallel batch.
+		/// Defaults to 0, which updates every Node on the calling thread.
+		void SetUpdateThreads(size_t numThreads);
+
+		/// @brief Start or stop pipelining updates with drawing.
+		/// While pipelined, NodeFlags::ThreadSafeUpdate Nodes which aren't visual and are only fed by other such Nodes
+		/// update for the next frame on a background thread while the current frame draws.
+		/// Their pushes into the rest of the graph are staged (see StagedPushes) and published
+		/// at the start of the next Update(), so Draw() never reads values which are being written.
+		void SetPipelined(bool enabled);
+
+		inline bool IsPipelined() {
+			return pipelined;
+		}
+
+		/// @brief Wait for the pipelined update started by the last Update(), and publish what it pushed.
+		/// Call before touching Nodes from the main thread outside of Update() and Draw();
+		/// the Editor calls this before drawing its GUI, and graph edits like Connect() call it themselves.
+		void FinishPipelinedUpdate();
+
         /// @brief To be called during OpenFrameworks' hook for audio input.
         void ProcessAudio(ofSoundBuffer& buffer);
 
@@ -75,39 +103,169 @@ namespace seam {
 		/// Calling this function will cause the SeamGraph to recalculate its visual update chain.
 		void SetVisualOutputNode(INode* node);
 
+		/// @brief Get the visual node which the editor is previewing, if any.
+		inline INode* GetPreviewNode() { return previewNode; }
+
+		/// @brief Set the visual node which the editor is previewing; may be nullptr.
+		/// Only the visual output node, the preview node, and the Nodes upstream of them update and draw.
+		void SetPreviewNode(INode* node);
+
 		/// @brief Connect an output pin to an input pin.
 		/// @return true if the Pins were successfully connected.
 		bool Connect(PinInput* pinIn, PinOutput* pinOut);
 
 		bool Disconnect(PinInput* pinIn, PinOutput* pinOut);
 
+		/// @brief Start a batch of Connect() / Disconnect() calls.
+		/// Update order recalculation is deferred until EndBatchConnect(),
+		/// which recalculates every Node's update order in a single pass.
+		void BeginBatchConnect();
+
+		/// @brief Finish a batch of connections started with BeginBatchConnect().
+		/// Connections in the batch aren't checked for cycles one by one, so any which closed a cycle are disconnected here.
+		void EndBatchConnect();
+
 		void OnWindowResized(int w, int h);
 
+		/// @brief The resolution window-sized Nodes are created with.
+		/// Falls back to the OpenFrameworks window's size until OnWindowResized() is called.
+		glm::ivec2 GetResolution();
+
+		/// @brief Replace the clock which provides time to update and draw params.
+		/// Pass nullptr to go back to OpenFrameworks' timers.
+		/// The graph doesn't take ownership; the clock must outlive the graph or be replaced first.
+		void SetClock(IClock* clock);
+
+		/// @brief Start or stop timing Nodes' Update(), Draw() and ProcessAudio() calls.
+		/// Timings are kept per Node in a rolling window; see GetNodeTimings().
+		void SetProfiling(bool enabled);
+
+		inline bool IsProfiling() {
+			return profiler.IsEnabled();
+		}
+
+		/// @return Rolling stats of a Node's recent calls; empty if the Node hasn't been timed.
+		TimingStats GetNodeTimings(INode* node, ProfileScope scope);
+
+		/// @brief Walk every Node's pins to total the memory they take up,
+		/// next to the memory of the values they point to.
+		PinMemoryStats GetPinMemoryStats();
+
+		/// @brief Use to capture chrome://tracing / Perfetto traces of timed calls while profiling.
+		inline Profiler& GetProfiler() { return profiler; }
+
         inline EventNodeFactory* GetFactory() { return &factory; }
 
         inline const std::vector<INode*>& GetNodes() { return nodes; }
 
 		inline UpdateParams* GetUpdateParams() {
-			updateParams.time = ofGetElapsedTimef();
-			updateParams.delta_time = ofGetLastFrameTime();
+			updateParams.time = clock->Time();
+			updateParams.delta_time = clock->DeltaTime();
 			return &updateParams;
 		}
 
     private:
+		/// @brief A run of Nodes in an UpdateSchedule which share an update order.
+		struct ScheduleBatch {
+			uint32_t begin;
+			uint32_t end;
+			/// @brief Every Node in the batch is thread safe and pushes into different children,
+			/// so they can Update() in parallel.
+			bool parallel;
+		};
+
+		/// @brief Nodes sorted by update order, with the index range of each batch
+		/// worked out when the schedule is compiled, so an update pass is a linear walk over both arrays.
+		struct UpdateSchedule {
+			std::vector<INode*> nodes;
+			std::vector<ScheduleBatch> batches;
+
+			inline void Clear() {
+				nodes.clear();
+				batches.clear();
+			}
+		};
+
 		void LockAudio();
 
-		/// @brief Recursively traverse a visual node's parent tree and update nodes in order.
-		/// Also determines the draw list (but not ordering!) for this frame.
-		void UpdateVisibleNodeGraph(INode* n, UpdateParams* params);
+		/// @brief Rebuild the flat update schedule from the parent trees of visible nodes.
+		/// Is called lazily from Update() after the graph's topology has changed.
+		void CompileUpdateSchedule();
+
+		/// @brief Split a schedule whose Nodes are already sorted by update order into batches.
+		/// Each level's Nodes are reordered so its serial Nodes come first, followed by its parallel batches.
+		void CompileBatches(UpdateSchedule& schedule);
+
+		/// @brief Rebuild the visible nodes list after the visual output or preview node changes.
+		void RefreshVisibleNodes();
+
+		/// @brief Split the compiled schedule into the Nodes which update on the pipeline thread and the rest,
+		/// and stage the inputs which the pipeline thread pushes to from across the split.
+		void CompilePipelineSchedule();
+
+		/// @brief Mark the update schedule as stale so it is recompiled before the next Update().
+		/// Staged inputs are published and released right away, since the pins they point to may be going away.
+		void InvalidateUpdateSchedule();
 
-        /// @brief Recalculate a node and its children's update order
-		int16_t RecalculateUpdateOrder(INode* node);
+		/// @brief Publish and release every staged input.
+		void ClearStagedInputs();
 
-		/// @brief Recalculate the node and its children's update and/or draw orders
-		void InvalidateChildren(INode* node);
+		/// @brief Move an update pass's frame arenas on to a new epoch, and point its params at them.
+		void BeginFrameArenas(FrameArenaRing& arenas, std::vector<std::unique_ptr<FrameArenaRing>>& workerArenas,
+			UpdateParams* params, std::vector<UpdateParams>& workerParams, uint32_t epoch);
 
-		/// @brief Recalculates the update and/or draw orders of nodes
-		void RecalculateTraversalOrder(INode* node);
+		/// @brief Update the Nodes in a schedule level by level, with epoch as the update pass's frame epoch.
+		void RunSchedule(const UpdateSchedule& schedule, UpdateParams* params,
+			std::vector<UpdateParams>& workerParams, uint32_t epoch);
+
+		/// @brief Drop the events queued on unscheduled Nodes' inputs.
+		/// Events point into frame arenas which are retired two frames later,
+		/// so a Node which isn't updating can't hold on to them until it's scheduled again.
+		void ClearUnscheduledEvents();
+
+		/// @brief Run an update pass over the pipeline schedule, as if it were the given time.
+		/// Runs on the pipeline thread, or on the main thread when there's no pass running ahead of Update().
+		void RunPipelineSchedule(float time, float deltaTime);
+
+		/// @brief Move values pushed during the last pipelined pass into their inputs, on the main thread.
+		void PublishPipelinedUpdate();
+
+		/// @brief Decide whether a scheduled Node needs to Update() during this update pass,
+		/// pulling dirtiness down from any parents which were dirty earlier in the pass.
+		bool PrepareScheduledNode(INode* n, uint32_t epoch);
+
+		/// @brief Update a single scheduled Node and queue it for drawing if it's visual.
+		void UpdateScheduledNode(INode* n, UpdateParams* params, uint32_t epoch);
+
+		/// @brief Update the Nodes gathered from one parallel schedule batch using the worker pool.
+		void UpdateParallelBatch(UpdateParams* params, std::vector<UpdateParams>& workerParams, uint32_t epoch);
+
+		/// @brief Incrementally recalculate update order after an edge into the given Node was added or removed.
+		/// Only the Node and descendants whose update order actually changes are visited.
+		void PropagateUpdateOrder(INode* node);
+
+		/// @brief Whether an edge from parent to child would close a cycle; needs update orders to be current.
+		bool CreatesCycle(INode* parent, INode* child);
+
+		/// @brief Recalculate every Node's update order from scratch in O(nodes + edges).
+		/// If the graph has cycles, the connections closing them are disconnected first.
+		void RecalculateAllUpdateOrders();
+
+		/// @brief Disconnect every connection from a parent to a child which closes a cycle among the given Nodes.
+		/// @return The number of pin connections removed.
+		size_t DisconnectCycles(const std::vector<INode*>& unordered);
+
+		/// @brief Make a call on a Node, timing it if profiling is enabled.
+		template <typename F>
+		inline void Profiled(INode* n, ProfileScope scope, F&& call) {
+			if (!profiler.IsEnabled()) {
+				call();
+				return;
+			}
+			const Profiler::TimePoint start = Profiler::Now();
+			call();
+			profiler.Record(n->timings.get(), n->NodeName(), n->Id(), scope, start, Profiler::Now());
+		}
 
         /// @brief Unsorted list of all the Nodes in the graph.
 		std::vector<INode*> nodes;
@@ -115,31 +273,108 @@ namespace seam {
 		/// @brief These two are re-calculated each frame, and then sorted for update + draw in that order
         std::vector<INode*> nodesToDraw;
 
-		/// @brief Visible visual nodes dictate which nodes actually get updated and drawn during those loops
+		/// @brief Visible visual nodes dictate which nodes actually get updated and drawn during those loops.
+		/// Holds the visual output node and the preview node; see RefreshVisibleNodes().
 		std::vector<INode*> visibleNodes;
 
-		/// @brief Nodes which update over time need to be invalidated every frame.
-		std::vector<INode*> nodesUpdateOverTime;
+		/// @brief Every Node in the parent trees of visible nodes, each listed once and sorted by update order.
+		/// Update() makes a single linear pass over this schedule instead of re-walking parent trees every frame.
+		UpdateSchedule updateSchedule;
+
+		/// @brief While pipelined, the Nodes split off of the update schedule to update on the pipeline thread.
+		UpdateSchedule pipelineSchedule;
+
+		/// @brief Nodes in the update schedule with parents in the pipeline schedule,
+		/// which are dirtied when those parents pass on their dirtiness.
+		std::vector<INode*> pipelineBoundary;
+
+		/// @brief Back buffers of the inputs which the pipeline schedule pushes to from across the split.
+		std::vector<std::unique_ptr<StagedPushes>> stagedInputs;
+
+		/// @brief Nodes outside of the update schedule with event queue inputs, which are cleared every frame.
+		std::vector<INode*> unscheduledEventNodes;
+
+		/// @brief Raised when Nodes or connections change, so the update schedule is recompiled.
+		bool updateScheduleDirty = true;
+
+		/// @brief Incremented for each pass over Nodes while compiling the update schedule; used to mark already-visited Nodes.
+		uint32_t scheduleMark = 0;
+
+		/// @brief Incremented for each update order propagation or cycle check; used to mark already-visited Nodes.
+		uint32_t orderMark = 0;
+
+		/// @brief Raised between BeginBatchConnect() and EndBatchConnect().
+		bool batchConnecting = false;
 
 		/// @brief Nodes which update every frame may need to need to Update() no matter what,
 		// even if they are not part of a visible visual chain
 		std::vector<INode*> nodesUpdateEveryFrame;
 
-		std::vector<IAudioNode*> audioNodes;
+		struct AudioNode {
+			IAudioNode* audio;
+			INode* node;
+		};
+		std::vector<AudioNode> audioNodes;
 
 		/// @brief The visual node which is drawn to the output window.
 		/// Dictates which Nodes are in the active visual update chain and will be updated each frame.
 		INode* visualOutputNode = nullptr;
 
+		/// @brief The visual node the editor is previewing; also kept up to date when it's not the output.
+		INode* previewNode = nullptr;
+
 		SetupParams setupParams;
 
 		EventNodeFactory factory;
 		PushPatterns pushPatterns;
+		/// @brief Every pin in the graph, by id and by name.
+		pins::PinIndex pinIndex;
 		TextureLocationResolver texLocResolver = TextureLocationResolver(&pushPatterns, GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS);
-		FramePool allocPool = FramePool(8192);
+		/// @brief Frame pools for the main update pass. Each frame's allocations are kept until the frame
+		/// after next starts, so events can be read by Nodes which update a frame late; see retiredEpoch.
+		FrameArenaRing frameArenas;
 
 		UpdateParams updateParams;
 
+		Profiler profiler;
+
+		OfClock ofClock;
+		IClock* clock = &ofClock;
+
+		/// @brief Set by OnWindowResized(); zero until then.
+		glm::ivec2 resolution = glm::ivec2(0);
+
+		/// @brief Only exists if SetUpdateThreads() was called with a non-zero thread count.
+		std::unique_ptr<WorkerPool> workerPool;
+		/// @brief Frame pools for workers 1..N; worker 0 is the calling thread and uses frameArenas.
+		std::vector<std::unique_ptr<FrameArenaRing>> workerFrameArenas;
+		/// @brief One set of update params per worker, indexed by worker index.
+		std::vector<UpdateParams> workerUpdateParams;
+		/// @brief Dirty Nodes from the parallel schedule batch currently being updated.
+		std::vector<INode*> parallelBatch;
+
+		bool pipelined = false;
+		/// @brief Raised once the pipeline schedule has been updated for the next Update().
+		bool pipelineAhead = false;
+		/// @brief Frame epoch of the last pipelined pass.
+		uint32_t pipelineEpoch = 0;
+		/// @brief Only exists while pipelined.
+		std::unique_ptr<PipelineThread> pipelineThread;
+		UpdateParams pipelineUpdateParams;
+		FrameArenaRing pipelineFrameArenas;
+		/// @brief The pipelined pass gets its own worker frame pools, since the main pass's allocations
+		/// may still be read while the current frame draws.
+		std::vector<std::unique_ptr<FrameArenaRing>> pipelineWorkerFrameArenas;
+		std::vector<UpdateParams> pipelineWorkerUpdateParams;
+
+		/// @brief Incremented at the start and end of each Update() pass; see INode::SetDirty().
+		std::atomic<uint32_t> frameEpoch = 1;
+		/// @brief Frame allocations made for this epoch or earlier ones are no longer read, by either pass.
+		/// Raised at the start of each Update() to just before the previous Update()'s epoch.
+		std::atomic<uint32_t> retiredEpoch = 0;
+		/// @brief The epoch of the last Update() pass.
+		uint32_t lastUpdateEpoch = 0;
+
 		std::atomic<bool> clearAudioNodes;
 		std::atomic<bool> processingAudio;
 		std::atomic<bool> audioLock;
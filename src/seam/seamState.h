@@ -1,16 +1,22 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+
 namespace seam {
     class TextureLocationResolver;
 }
 
 namespace seam::pins {
     class PushPatterns;
+    class PinIndex;
 }
 
 namespace seam {
     struct SeamState {
         seam::pins::PushPatterns* pushPatterns = nullptr;
+        seam::pins::PinIndex* pinIndex = nullptr;
         seam::TextureLocationResolver* texLocResolver = nullptr;
+        const std::atomic<uint32_t>* frameEpoch = nullptr;
     };
 }
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include "seam/workerPool.h"
+
+using namespace seam;
+
+WorkerPool::WorkerPool(size_t numThreads) {
+	threads.reserve(numThreads);
+	for (size_t i = 0; i < numThreads; i++) {
+		// Worker 0 is the thread which calls RunBatch().
+		threads.emplace_back(&WorkerPool::WorkerLoop, this, i + 1);
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+
+	for (auto& t : threads) {
+		t.join();
+	}
+}
+
+void WorkerPool::RunBatch(size_t count, const Job& _job) {
+	if (count == 0) {
+		return;
+	}
+
+	// Not worth waking anybody up for a single job.
+	if (count == 1 || threads.empty()) {
+		for (size_t i = 0; i < count; i++) {
+			_job(i, 0);
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		job = &_job;
+		jobCount = count;
+		nextJob.store(0);
+		activeWorkers = threads.size();
+		generation += 1;
+	}
+	wake.notify_all();
+
+	RunJobs(0);
+
+	// Wait for the other workers to drain the batch.
+	std::unique_lock<std::mutex> lock(mutex);
+	done.wait(lock, [this] { return activeWorkers == 0; });
+	job = nullptr;
+}
+
+void WorkerPool::WorkerLoop(size_t workerIndex) {
+	uint64_t seenGeneration = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [this, seenGeneration] { 
+				return stopping || generation != seenGeneration; 
+			});
+
+			if (stopping) {
+				return;
+			}
+			seenGeneration = generation;
+		}
+
+		RunJobs(workerIndex);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			activeWorkers -= 1;
+			if (activeWorkers == 0) {
+				done.notify_one();
+			}
+		}
+	}
+}
+
+void WorkerPool::RunJobs(size_t workerIndex) {
+	size_t i;
+	while ((i = nextJob.fetch_add(1)) < jobCount) {
+		(*job)(i, workerIndex);
+	}
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+
+namespace seam {
+	/// @brief A fixed set of worker threads which run batches of indexed jobs.
+	/// The thread calling RunBatch() participates as worker 0, and RunBatch() blocks until
+	/// every job in the batch has finished, so consecutive batches are separated by a barrier.
+	class WorkerPool {
+	public:
+		/// @brief Is called once per job index; workerIndex is in [0, NumWorkers()).
+		using Job = std::function<void(size_t index, size_t workerIndex)>;
+
+		/// @param numThreads Number of threads to spawn, not counting the calling thread.
+		WorkerPool(size_t numThreads);
+		~WorkerPool();
+
+		WorkerPool(const WorkerPool&) = delete;
+		void operator=(const WorkerPool&) = delete;
+
+		/// @return The number of threads which run jobs, including the thread calling RunBatch().
+		inline size_t NumWorkers() {
+			return threads.size() + 1;
+		}
+
+		/// @brief Run job(i, workerIndex) for every i in [0, count) across all workers,
+		/// and wait for all of them to finish.
+		void RunBatch(size_t count, const Job& job);
+
+	private:
+		void WorkerLoop(size_t workerIndex);
+		void RunJobs(size_t workerIndex);
+
+		std::vector<std::thread> threads;
+
+		std::mutex mutex;
+		std::condition_variable wake;
+		std::condition_variable done;
+
+		const Job* job = nullptr;
+		size_t jobCount = 0;
+		std::atomic<size_t> nextJob = 0;
+
+		/// @brief Number of spawned workers which haven't finished the current batch yet.
+		size_t activeWorkers = 0;
+		/// @brief Incremented per batch so sleeping workers know there's new work.
+		uint64_t generation = 0;
+		bool stopping = false;
+	};
+}